@@ -0,0 +1,43 @@
+#include "radar_os.h"
+
+/**
+ * Background thread of a host worker: runs the handler once per batch of
+ * submissions, like a k_work item on its own work queue.
+ * @param arg Pointer to the worker.
+ * @return Never returns.
+ */
+static void *radar_worker_thread(void *arg)
+{
+	radar_worker_t *worker = arg;
+
+	pthread_mutex_lock(&worker->mutex);
+	while (1) {
+		while (!worker->pending) {
+			pthread_cond_wait(&worker->cond, &worker->mutex);
+		}
+		worker->pending = false;
+		pthread_mutex_unlock(&worker->mutex);
+		worker->handler();
+		pthread_mutex_lock(&worker->mutex);
+	}
+	return NULL;
+}
+
+/**
+ * Queues the worker, starting its thread on first use.
+ * @param worker Pointer to the worker.
+ */
+void radar_worker_submit(radar_worker_t *worker)
+{
+	pthread_mutex_lock(&worker->mutex);
+	if (!worker->started) {
+		pthread_create(&worker->thread, NULL, radar_worker_thread, worker);
+		pthread_detach(worker->thread);
+		worker->started = true;
+	}
+	if (!worker->pending) {
+		worker->pending = true;
+		pthread_cond_signal(&worker->cond);
+	}
+	pthread_mutex_unlock(&worker->mutex);
+}
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Compare benchmark runs of different build profiles.
+
+Each argument is LABEL=LOG, where LOG is a console log (or twister
+handler.log) with the "BENCH ..." lines of tests/benchmark:
+
+    west twister -T tests/benchmark -p mps2_an385 -p native_sim
+    scripts/bench_compare.py \\
+        Os=twister-out/mps2_an385/tests/benchmark/benchmark.radar/handler.log \\
+        O2=twister-out/mps2_an385/tests/benchmark/benchmark.radar.o2/handler.log \\
+        O2+LTO=twister-out/mps2_an385/tests/benchmark/benchmark.radar.perf/handler.log
+
+Prints a Markdown table with cycles/op per benchmark and profile, and the
+change relative to the first profile.
+"""
+
+import argparse
+import re
+import sys
+
+BENCH_RE = re.compile(r"BENCH (\S+)\s+(\d+) cycles/op\s+(\d+) ns/op")
+
+
+def parse(path):
+    results = {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = BENCH_RE.search(line)
+            if m:
+                results[m.group(1)] = (int(m.group(2)), int(m.group(3)))
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("runs", nargs="+", metavar="LABEL=LOG")
+    parser.add_argument("--ns", action="store_true", help="compare ns/op instead of cycles/op")
+    args = parser.parse_args()
+
+    runs = []
+    for arg in args.runs:
+        label, sep, path = arg.partition("=")
+        if not sep:
+            sys.exit(f"expected LABEL=LOG, got {arg}")
+        runs.append((label, parse(path)))
+
+    names = []
+    for _, results in runs:
+        names += [n for n in results if n not in names]
+    if not names:
+        sys.exit("no BENCH lines found")
+
+    col = 1 if args.ns else 0
+    unit = "ns/op" if args.ns else "cycles/op"
+    header = [f"benchmark ({unit})"] + [label for label, _ in runs]
+    print("| " + " | ".join(header) + " |")
+    print("|" + "---|" * len(header))
+    for name in names:
+        base = runs[0][1].get(name)
+        cells = [name]
+        for i, (_, results) in enumerate(runs):
+            if name not in results:
+                cells.append("-")
+                continue
+            value = results[name][col]
+            cell = str(value)
+            if i > 0 and base and base[col]:
+                cell += f" ({(value - base[col]) * 100 / base[col]:+.0f}%)"
+            cells.append(cell)
+        print("| " + " | ".join(cells) + " |")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
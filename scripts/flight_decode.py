@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""Decode the radar flight recorder.
+
+Reads either a console log containing the "FR <16 hex digits>" lines
+printed at boot or from the fatal error handler, or (with --bin) a raw
+image of the flight_ring_t object, e.g. from a coredump or from gdb:
+
+    dump binary memory ring.bin &flight_ring (char *)&flight_ring + sizeof(flight_ring)
+
+The image layout is the 32-bit target one: magic, size, boots and head
+as little-endian u32, then size little-endian u64 events. Both halves of
+an event carry a lap tag; events whose tags do not match their position
+were torn by a writer that never finished and are skipped.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+MAGIC = 0x46524543
+TIME_MASK = 0x0fffffff
+TYPES = ["boot", "edge_start", "edge_end", "finalize", "speed", "trigger",
+         "result", "log_add", "drop"]
+STATUS = ["normal", "warning", "infraction"]
+VEHICLE = ["light", "heavy", "unknown"]
+QUEUE = ["sensor_msgq", "display sink"]
+LINE_RE = re.compile(r"\bFR ([0-9a-fA-F]{16})\b")
+
+
+def unpack(raw):
+    return raw & TIME_MASK, (raw >> 32) & 0xf, (raw >> 40) & 0xff, (raw >> 48) & 0xffff
+
+
+def lap_tag(seq, size):
+    return (seq // size + 1) & 0xf
+
+
+def describe(kind, arg, value):
+    if kind == "boot":
+        return f"boot #{value}"
+    if kind == "finalize":
+        return f"{arg} axles, {value} ms"
+    if kind == "speed":
+        status = STATUS[arg] if arg < len(STATUS) else arg
+        return f"{value} km/h, {status}"
+    if kind == "trigger":
+        return f"{value} km/h"
+    if kind == "result":
+        return "valid read" if arg else "read failed"
+    if kind == "log_add":
+        vehicle = VEHICLE[arg] if arg < len(VEHICLE) else arg
+        return f"{vehicle}, {value} km/h"
+    if kind == "drop":
+        if arg == 1:
+            return f"display sink {value}"
+        return QUEUE[arg] if arg < len(QUEUE) else f"queue {arg}"
+    return ""
+
+
+def from_log(stream):
+    return [int(m.group(1), 16) for m in map(LINE_RE.search, stream) if m]
+
+
+def from_image(data):
+    magic, size, boots, head = struct.unpack_from("<4I", data, 0)
+    if magic != MAGIC:
+        sys.exit(f"bad magic 0x{magic:08x}, ring was never initialized")
+    if len(data) < 16 + 8 * size:
+        sys.exit(f"image too short for {size} events")
+    events = struct.unpack_from(f"<{size}Q", data, 16)
+    count = min(head, size)
+    print(f"ring: {size} slots, {head} events recorded, boot {boots}")
+    words = []
+    for seq in range(head - count, head):
+        raw = events[seq % size]
+        tag = lap_tag(seq, size)
+        if (raw >> 28) & 0xf != tag or (raw >> 36) & 0xf != tag:
+            print(f"event {seq}: torn, skipped")
+            continue
+        words.append(raw)
+    return words
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", nargs="?", help="console log or ring image (default: stdin)")
+    parser.add_argument("--bin", action="store_true", help="input is a raw flight_ring_t image")
+    args = parser.parse_args()
+
+    if args.bin:
+        with open(args.input, "rb") as f:
+            words = from_image(f.read())
+    elif args.input:
+        with open(args.input, errors="replace") as f:
+            words = from_log(f)
+    else:
+        words = from_log(sys.stdin)
+
+    prev = None
+    for raw in words:
+        time_ms, type_id, arg, value = unpack(raw)
+        kind = TYPES[type_id] if type_id < len(TYPES) else f"type{type_id}"
+        if kind == "boot":
+            prev = None
+        delta = f"+{(time_ms - prev) & TIME_MASK}" if prev is not None else ""
+        print(f"{time_ms:>10} {delta:>8}  {kind:<10} {describe(kind, arg, value)}")
+        prev = time_ms
+
+
+if __name__ == "__main__":
+    main()
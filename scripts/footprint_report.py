@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Summarize RAM/ROM per subsystem and check it against the footprint budget.
+
+Run after the footprint targets of a build:
+
+    west build -b mps2/an385 -- \
+        -DEXTRA_CONF_FILE="overlay-minimal-core.conf;overlay-minimal.conf"
+    west build -t ram_report && west build -t rom_report
+    scripts/footprint_report.py build
+
+It reads ram.json and rom.json from the build directory, groups every
+symbol by the source tree it comes from, prints a table and exits 1 if
+any group in footprint_budget.json is over its budget.
+"""
+
+import argparse
+import json
+import os
+import sys
+
+# First matching path fragment wins
+SUBSYSTEMS = [
+    ("/subsys/zbus/", "zbus"),
+    ("/subsys/logging/", "logging"),
+    ("/lib/os/cbprintf", "cbprintf"),
+    ("/subsys/", "subsys"),
+    ("/kernel/", "kernel"),
+    ("/arch/", "arch"),
+    ("/drivers/", "drivers"),
+    ("/lib/libc/", "libc"),
+    ("/lib/", "lib"),
+    ("/soc/", "soc"),
+]
+DEFAULT_BUDGET = os.path.join(os.path.dirname(__file__), "..", "footprint_budget.json")
+
+
+def classify(path, app_dir):
+    if app_dir and path.startswith(app_dir):
+        return "app"
+    for fragment, name in SUBSYSTEMS:
+        if fragment in path:
+            return name
+    if "/src/" in path and "/zephyr/" not in path:
+        return "app"
+    return "other"
+
+
+def leaves(node, prefix=""):
+    path = node.get("identifier", node.get("name", ""))
+    children = node.get("children")
+    if not children:
+        yield path, node.get("size", 0)
+        return
+    for child in children:
+        yield from leaves(child, path)
+
+
+def summarize(report, app_dir):
+    groups = {}
+    for path, size in leaves(report["symbols"]):
+        name = classify(path.replace("\\", "/"), app_dir)
+        groups[name] = groups.get(name, 0) + size
+    groups["total"] = report.get("total_size", sum(groups.values()))
+    return groups
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("build_dir", help="Zephyr build directory")
+    parser.add_argument("--budget", default=DEFAULT_BUDGET, help="budget JSON file")
+    parser.add_argument("--app-dir", default=os.path.abspath(os.path.join(os.path.dirname(__file__), "..", "src")),
+                        help="application source directory (default: src/)")
+    args = parser.parse_args()
+
+    with open(args.budget) as f:
+        budget = json.load(f)
+
+    over = []
+    for kind in ("ram", "rom"):
+        report_path = os.path.join(args.build_dir, f"{kind}.json")
+        if not os.path.exists(report_path):
+            sys.exit(f"{report_path} missing, run west build -t {kind}_report first")
+        with open(report_path) as f:
+            groups = summarize(json.load(f), args.app_dir.replace("\\", "/"))
+
+        limits = budget.get(kind, {})
+        print(f"{kind.upper():<10} {'bytes':>8} {'budget':>8}")
+        for name in sorted(groups, key=lambda n: (n == "total", -groups[n])):
+            limit = limits.get(name)
+            flag = ""
+            if limit is not None and groups[name] > limit:
+                flag = "  OVER"
+                over.append(f"{kind} {name}: {groups[name]} > {limit}")
+            shown = "" if limit is None else str(limit)
+            print(f"  {name:<8} {groups[name]:>8} {shown:>8}{flag}")
+        print()
+
+    if over:
+        print("Footprint over budget:\n  " + "\n  ".join(over))
+        return 1
+    print("Footprint within budget")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,47 @@
+#include "camera_batch.h"
+
+/**
+ * Opens a burst for a trigger.
+ * @param batch Pointer to the batch.
+ * @param first The trigger that starts the burst.
+ * @param now_ms When the camera starts recording; later than the trigger if it was busy.
+ */
+void camera_batch_start(camera_batch_t *batch, const camera_trigger_t *first, int64_t now_ms)
+{
+	batch->members[0] = *first;
+	batch->count = 1;
+	batch->start_ms = now_ms;
+	batch->done_ms = now_ms + CONFIG_RADAR_CAMERA_CAPTURE_MS;
+}
+
+/**
+ * Adds a trigger to the burst if it belongs to the same platoon: same
+ * lane, close behind the last member, and room left.
+ * @param batch Pointer to the batch.
+ * @param trigger The trigger.
+ * @return True if the trigger joined, false if it starts a burst of its own.
+ */
+bool camera_batch_join(camera_batch_t *batch, const camera_trigger_t *trigger)
+{
+	const camera_trigger_t *last = &batch->members[batch->count - 1];
+
+	if (batch->count == CONFIG_RADAR_CAMERA_PLATOON_MAX || trigger->lane != last->lane ||
+	    trigger->timestamp_ms - last->timestamp_ms > CONFIG_RADAR_CAMERA_PLATOON_GAP_MS) {
+		return false;
+	}
+	batch->members[batch->count++] = *trigger;
+	batch->done_ms = MAX(batch->done_ms, trigger->timestamp_ms) + CONFIG_RADAR_CAMERA_EXTRACT_MS;
+	return true;
+}
+
+/**
+ * Tells whether a member was still in view when the recording started.
+ * Members that arrive during the recording always are.
+ * @param batch Pointer to the batch.
+ * @param index The member.
+ * @return True if its plate is in the recorded frames.
+ */
+bool camera_batch_in_view(const camera_batch_t *batch, uint32_t index)
+{
+	return batch->start_ms - batch->members[index].timestamp_ms <= CONFIG_RADAR_CAMERA_VIEW_MS;
+}
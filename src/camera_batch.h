@@ -0,0 +1,66 @@
+#ifndef CAMERA_BATCH_H
+#define CAMERA_BATCH_H
+
+#include "radar_os.h"
+#include "common.h"
+
+#ifndef CONFIG_RADAR_CAMERA_CAPTURE_MS
+#define CONFIG_RADAR_CAMERA_CAPTURE_MS 500
+#endif
+#ifndef CONFIG_RADAR_CAMERA_EXTRACT_MS
+#define CONFIG_RADAR_CAMERA_EXTRACT_MS 60
+#endif
+#ifndef CONFIG_RADAR_CAMERA_VIEW_MS
+#define CONFIG_RADAR_CAMERA_VIEW_MS 1000
+#endif
+#ifndef CONFIG_RADAR_CAMERA_PLATOON_GAP_MS
+#define CONFIG_RADAR_CAMERA_PLATOON_GAP_MS 600
+#endif
+#ifndef CONFIG_RADAR_CAMERA_PLATOON_MAX
+#define CONFIG_RADAR_CAMERA_PLATOON_MAX 10
+#endif
+
+/*
+ * Platoon capture: triggers on the same lane, each within the platoon gap
+ * of the previous one, share one burst of up to CONFIG_RADAR_CAMERA_PLATOON_MAX
+ * vehicles. The burst records from its first trigger while the camera reads
+ * the plates, and the recording stays open for the gap after the last
+ * member. A follower only adds a plate extraction, queued behind the
+ * earlier ones or started at its own trigger if the camera has caught up.
+ * Results are published as soon as the camera is done with them, so a lone
+ * vehicle still comes back after a single capture. A vehicle is only in
+ * the pictures if the recording started before it left the camera's view.
+ */
+typedef struct {
+	camera_trigger_t members[CONFIG_RADAR_CAMERA_PLATOON_MAX];
+	uint32_t count;
+	int64_t start_ms; // Recording start
+	int64_t done_ms;  // When the camera is done with the current members
+} camera_batch_t;
+
+void camera_batch_start(camera_batch_t *batch, const camera_trigger_t *first, int64_t now_ms);
+bool camera_batch_join(camera_batch_t *batch, const camera_trigger_t *trigger);
+bool camera_batch_in_view(const camera_batch_t *batch, uint32_t index);
+
+/**
+ * When the camera is done with a burst's current members: one capture, then
+ * one plate extraction per follower, none before its trigger.
+ * @param batch Pointer to the batch.
+ * @return The uptime in milliseconds.
+ */
+static inline int64_t camera_batch_done_ms(const camera_batch_t *batch)
+{
+	return batch->done_ms;
+}
+
+/**
+ * When the recording closes unless another follower joins.
+ * @param batch Pointer to the batch.
+ * @return The uptime in milliseconds.
+ */
+static inline int64_t camera_batch_gap_end_ms(const camera_batch_t *batch)
+{
+	return batch->members[batch->count - 1].timestamp_ms + CONFIG_RADAR_CAMERA_PLATOON_GAP_MS;
+}
+
+#endif
@@ -1,13 +1,35 @@
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/random/random.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/zbus/zbus.h>
 #include "common.h"
+#include "camera_batch.h"
+#include "evidence_stage.h"
+#include "lpr.h"
+#include "telemetry.h"
 
-LOG_MODULE_REGISTER(camera_thread, LOG_LEVEL_INF);
+LOG_MODULE_REGISTER(camera_thread, CONFIG_RADAR_LOG_LEVEL);
 
-ZBUS_SUBSCRIBER_DEFINE(camera_sub, 4);
+// Triggers, handed over by a ZBUS listener so a platoon queues up while the camera is busy
+K_MSGQ_DEFINE(camera_trigger_msgq, sizeof(camera_trigger_t), 2 * CONFIG_RADAR_CAMERA_PLATOON_MAX, 4);
+
+/**
+ * ZBUS listener for camera triggers. Runs in the publisher's context.
+ * @param chan Pointer to the camera trigger channel.
+ */
+static void camera_trigger_listener(const struct zbus_channel *chan) {
+    const camera_trigger_t *trig = zbus_chan_const_msg(chan);
+
+    if (k_msgq_put(&camera_trigger_msgq, trig, K_NO_WAIT) != 0) {
+        LOG_WRN("camera_trigger_msgq full, dropping trigger");
+    }
+}
+
+ZBUS_LISTENER_DEFINE(camera_trigger_lis, camera_trigger_listener);
+
+static camera_batch_t batch;
 
 /**
  * Generates a random Mercosul plate number.
@@ -44,6 +66,103 @@ static void generate_plate(char *buf) {
     buf[7] = '\0';
 }
 
+#if IS_ENABLED(CONFIG_RADAR_CAMERA_LPR)
+#if !IS_ENABLED(CONFIG_RADAR_EVIDENCE)
+static lpr_frame_t lpr_frame;
+#endif
+static lpr_integral_t lpr_workspace;
+
+/**
+ * Reads the plate of a vehicle from a camera frame. The vehicle, with the
+ * random plate it carries, is rendered into the frame; at the failure
+ * rate the plate is smudged. The plate is then located and recognized,
+ * and the result is what the recognizer read. With evidence enabled the
+ * frame is a slab buffer that goes on to compression, in place.
+ * @param result Pointer to the result to fill.
+ */
+static void camera_capture(camera_result_t *result) {
+    char carried[sizeof(result->plate)];
+    lpr_rect_t where;
+    lpr_rect_t crop;
+    lpr_read_t read;
+#if IS_ENABLED(CONFIG_RADAR_EVIDENCE)
+    lpr_frame_t *frame = evidence_frame_alloc();
+#else
+    lpr_frame_t *frame = &lpr_frame;
+#endif
+
+    generate_plate(carried);
+    lpr_sim_render(frame, carried, result->id, &where);
+    if (sys_rand32_get() % 100 < CONFIG_RADAR_CAMERA_FAILURE_RATE_PERCENT) {
+        lpr_sim_smudge(frame, &where, result->id);
+    }
+
+    uint32_t start = k_cycle_get_32();
+    bool located = lpr_locate(frame, &lpr_workspace, &crop);
+    uint32_t located_at = k_cycle_get_32();
+    result->valid_read = located && lpr_read(frame, &crop, &read);
+    uint32_t locate_us = k_cyc_to_us_floor32(located_at - start);
+    uint32_t read_us = k_cyc_to_us_floor32(k_cycle_get_32() - located_at);
+
+    if (!located) {
+        LOG_WRN("Camera: no plate in the frame (%u us)", locate_us);
+    } else if (!result->valid_read) {
+        LOG_WRN("Camera: plate unreadable, confidence %u%% (%u + %u us)", read.min_confidence,
+                locate_us, read_us);
+    } else {
+        strcpy(result->plate, read.plate);
+        if (strcmp(read.plate, carried) != 0) {
+            LOG_WRN("Camera: %s misread as %s", carried, read.plate);
+        }
+        LOG_INF("Camera Result: %s, confidence %u%% (%u + %u us)", result->plate,
+                read.min_confidence, locate_us, read_us);
+    }
+#if IS_ENABLED(CONFIG_RADAR_EVIDENCE)
+    // Unreadable plates need the picture most; every trigger is an infraction
+    evidence_submit(frame, result->id);
+#endif
+}
+#else
+/**
+ * Simulated plate read: a random plate, or a failure at the failure rate.
+ * @param result Pointer to the result to fill.
+ */
+static void camera_capture(camera_result_t *result) {
+    if (sys_rand32_get() % 100 < CONFIG_RADAR_CAMERA_FAILURE_RATE_PERCENT) {
+        LOG_WRN("Camera simulation: Read Failed");
+        result->valid_read = false;
+        return;
+    }
+    generate_plate(result->plate);
+    result->valid_read = true;
+    LOG_INF("Camera Result: %s", result->plate);
+}
+#endif
+
+/**
+ * Reads one member's plate from the burst and publishes it under the
+ * member's trigger id.
+ * @param b Pointer to the burst.
+ * @param index The member.
+ */
+static void camera_read_plate(const camera_batch_t *b, uint32_t index) {
+    camera_result_t result = {.id = b->members[index].id};
+
+    if (!camera_batch_in_view(b, index)) {
+        // Gone before the recording started: no frame shows its plate
+        telemetry_inc(TELEMETRY_CAMERA_ESCAPED);
+        LOG_WRN("Camera simulation: vehicle %u left the view", result.id);
+        result.valid_read = false;
+    } else {
+        camera_capture(&result);
+    }
+
+    int pub_ret = zbus_chan_pub(&camera_result_chan, &result, K_NO_WAIT);
+    if (pub_ret != 0) {
+        LOG_WRN("ZBUS publish to camera_result_chan failed: %d", pub_ret);
+    }
+}
+
 /**
  * Main entry point for the camera thread.
  * @param p1 Pointer to the camera thread data.
@@ -51,48 +170,56 @@ static void generate_plate(char *buf) {
  * @param p3 Pointer to the camera thread data.
  */
 void camera_thread_entry(void *p1, void *p2, void *p3) {
-    const struct zbus_channel *chan;
-    
-    // Subscribe to the trigger channel
-    zbus_chan_add_obs(&camera_trigger_chan, &camera_sub, K_FOREVER);
+    camera_trigger_t next;
+    bool have_next = false;
 
     LOG_INF("Camera System Ready");
 
     while (1) {
-        // Wait for a trigger from the sensor thread
-        if (zbus_sub_wait(&camera_sub, &chan, K_FOREVER) == 0) {
-            if (chan == &camera_trigger_chan) {
-                // Read the trigger data
-                camera_trigger_t trigger;
-                zbus_chan_read(&camera_trigger_chan, &trigger, K_NO_WAIT);
-                
-                LOG_INF("Camera Triggered! Processing...");
-                
-                // Simulate processing time
-                k_msleep(500); 
-                
-                camera_result_t result;
-                // Generate a random failure rate
-                uint32_t failure_rate = CONFIG_RADAR_CAMERA_FAILURE_RATE_PERCENT;
-                uint32_t chance = sys_rand32_get() % 100;
-                
-                // If the chance is less than the failure rate, the read failed
-                if (chance < failure_rate) {
-                    LOG_WRN("Camera simulation: Read Failed");
-                    result.valid_read = false;
-                    result.plate[0] = '\0';
-                } else {
-                    generate_plate(result.plate);
-                    result.valid_read = true;
-                    LOG_INF("Camera Result: %s", result.plate);
+        // Wait for a trigger, unless the last burst already took one off the queue
+        if (!have_next) {
+            (void)k_msgq_get(&camera_trigger_msgq, &next, K_FOREVER);
+            telemetry_inc(TELEMETRY_WAKEUP);
+        }
+        have_next = false;
+        camera_batch_start(&batch, &next, k_uptime_get());
+        LOG_INF("Camera Triggered! Recording...");
+
+        uint32_t read = 0;
+
+        while (!have_next) {
+            // Keep recording while the plates are read; close followers join the burst
+            while (batch.count < CONFIG_RADAR_CAMERA_PLATOON_MAX) {
+                int64_t end = MIN(camera_batch_gap_end_ms(&batch), camera_batch_done_ms(&batch));
+
+                if (k_msgq_get(&camera_trigger_msgq, &next, K_TIMEOUT_ABS_MS(end)) != 0) {
+                    break;
                 }
-                
-                int pub_ret = zbus_chan_pub(&camera_result_chan, &result, K_NO_WAIT);
-                if (pub_ret != 0) {
-                    LOG_WRN("ZBUS publish to camera_result_chan failed: %d", pub_ret);
+                telemetry_inc(TELEMETRY_WAKEUP);
+                if (!camera_batch_join(&batch, &next)) {
+                    have_next = true;
+                    break;
                 }
             }
+
+            // Simulate processing time: one capture, one plate extraction per further vehicle
+            k_sleep(K_TIMEOUT_ABS_MS(camera_batch_done_ms(&batch)));
+            for (; read < batch.count; read++) {
+                camera_read_plate(&batch, read);
+            }
+
+            // Results are out; the recording stays open for the rest of the platoon gap
+            if (have_next || batch.count == CONFIG_RADAR_CAMERA_PLATOON_MAX ||
+                k_msgq_get(&camera_trigger_msgq, &next,
+                           K_TIMEOUT_ABS_MS(camera_batch_gap_end_ms(&batch))) != 0) {
+                break;
+            }
+            telemetry_inc(TELEMETRY_WAKEUP);
+            have_next = !camera_batch_join(&batch, &next);
+        }
+        if (batch.count > 1) {
+            telemetry_inc(TELEMETRY_CAMERA_BURST);
+            LOG_INF("Camera burst: %u vehicles on lane %u", batch.count, batch.members[0].lane);
         }
     }
 }
-
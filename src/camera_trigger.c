@@ -0,0 +1,181 @@
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/drivers/counter.h>
+#include <zephyr/drivers/gpio.h>
+#include "camera_trigger.h"
+#include "telemetry.h"
+
+LOG_MODULE_REGISTER(camera_trigger, CONFIG_RADAR_LOG_LEVEL);
+
+#define CAMERA_TRIGGER_CHANNEL 0
+
+static const struct device *const trigger_counter = DEVICE_DT_GET(DT_ALIAS(camera_counter));
+static const struct gpio_dt_spec trigger_gpio = GPIO_DT_SPEC_GET(DT_ALIAS(camera_trigger), gpios);
+
+typedef enum {
+	TRIGGER_IDLE,
+	TRIGGER_ARMED,   // Waiting for the rising edge alarm
+	TRIGGER_PULSING, // Waiting for the falling edge alarm
+} trigger_state_t;
+
+static struct k_spinlock trigger_lock;
+static trigger_state_t trigger_state;
+static uint32_t trigger_target_ticks;
+// How far the prediction was already in the past when the pulse was armed
+static uint32_t trigger_late_us;
+static bool trigger_ready;
+
+/**
+ * Adds ticks to a counter value, wrapping at the counter's top value.
+ * @param now The counter value.
+ * @param ticks The ticks to add.
+ * @return The sum.
+ */
+static uint32_t trigger_ticks_add(uint32_t now, uint32_t ticks)
+{
+	uint64_t period = (uint64_t)counter_get_top_value(trigger_counter) + 1;
+
+	return (uint32_t)(((uint64_t)now + ticks) % period);
+}
+
+/**
+ * Ticks from one counter value to a later one, across a wrap.
+ * @param from The earlier value.
+ * @param to The later value.
+ * @return The elapsed ticks.
+ */
+static uint32_t trigger_ticks_since(uint32_t from, uint32_t to)
+{
+	uint64_t period = (uint64_t)counter_get_top_value(trigger_counter) + 1;
+
+	return (uint32_t)(((uint64_t)to + period - from) % period);
+}
+
+/**
+ * Counter alarm: raises the trigger line at the predicted time and arms
+ * the alarm that lowers it again. Records how far the edge was from the
+ * predicted time.
+ * @param dev The counter.
+ * @param chan_id The alarm channel.
+ * @param ticks The programmed alarm value.
+ * @param user_data Unused.
+ */
+static void trigger_alarm(const struct device *dev, uint8_t chan_id, uint32_t ticks,
+			  void *user_data)
+{
+	ARG_UNUSED(ticks);
+	ARG_UNUSED(user_data);
+
+	uint32_t now;
+
+	if (trigger_state == TRIGGER_PULSING) {
+		gpio_pin_set_dt(&trigger_gpio, 0);
+		trigger_state = TRIGGER_IDLE;
+		return;
+	}
+
+	gpio_pin_set_dt(&trigger_gpio, 1);
+	(void)counter_get_value(dev, &now);
+	telemetry_record(TELEMETRY_HIST_TRIGGER_ERROR,
+			 trigger_late_us +
+			 (uint32_t)counter_ticks_to_us(dev, trigger_ticks_since(trigger_target_ticks, now)));
+	telemetry_inc(TELEMETRY_TRIGGER_PULSE);
+
+	struct counter_alarm_cfg end = {
+		.callback = trigger_alarm,
+		.ticks = MAX(counter_us_to_ticks(dev, CONFIG_RADAR_CAMERA_TRIGGER_PULSE_US), 1),
+	};
+
+	trigger_state = TRIGGER_PULSING;
+	if (counter_set_channel_alarm(dev, chan_id, &end) != 0) {
+		gpio_pin_set_dt(&trigger_gpio, 0);
+		trigger_state = TRIGGER_IDLE;
+	}
+}
+
+/**
+ * Arms the trigger pulse for the moment a measured vehicle reaches the
+ * camera's focal point. A prediction already in the past fires at once and
+ * counts as late; a pulse still in flight makes the new one count as busy.
+ * @param s_data The measurement of the vehicle.
+ * @return True if a pulse was armed, false otherwise.
+ */
+bool camera_trigger_schedule(const sensor_data_t *s_data)
+{
+	if (!trigger_ready) {
+		return false;
+	}
+
+	// Sources without cycle stamps (simulator, dataset) only have milliseconds
+	bool stamped = s_data->duration_us != 0;
+	uint32_t duration_us = stamped ? s_data->duration_us : s_data->duration_ms * 1000;
+	// Relative to the end edge
+	int64_t target_us = predict_arrival_us(0, duration_us, CONFIG_RADAR_SENSOR_DISTANCE_MM,
+					       CONFIG_RADAR_CAMERA_DISTANCE_MM) -
+			    CONFIG_RADAR_CAMERA_TRIGGER_LEAD_US;
+	k_spinlock_key_t key = k_spin_lock(&trigger_lock);
+
+	if (trigger_state != TRIGGER_IDLE) {
+		k_spin_unlock(&trigger_lock, key);
+		telemetry_inc(TELEMETRY_TRIGGER_BUSY);
+		return false;
+	}
+
+	uint32_t now;
+	int64_t since_end_us = stamped ?
+		(int64_t)k_cyc_to_us_floor32(k_cycle_get_32() - s_data->end_cycles) :
+		(int64_t)k_ticks_to_us_floor64(k_uptime_ticks()) - s_data->timestamp_end * 1000;
+	int64_t delay_us = target_us - since_end_us;
+
+	(void)counter_get_value(trigger_counter, &now);
+	trigger_late_us = 0;
+	if (delay_us <= 0) {
+		telemetry_inc(TELEMETRY_TRIGGER_LATE);
+		trigger_late_us = (uint32_t)MIN(-delay_us, (int64_t)UINT32_MAX);
+		delay_us = 0;
+	}
+
+	// At least one tick ahead, or an absolute alarm could already be behind the counter
+	uint32_t delay_ticks = MAX(counter_us_to_ticks(trigger_counter, (uint64_t)delay_us), 1);
+	struct counter_alarm_cfg cfg = {
+		.callback = trigger_alarm,
+		.ticks = trigger_ticks_add(now, delay_ticks),
+		.flags = COUNTER_ALARM_CFG_ABSOLUTE | COUNTER_ALARM_CFG_EXPIRE_WHEN_LATE,
+	};
+
+	trigger_target_ticks = cfg.ticks;
+	trigger_state = TRIGGER_ARMED;
+	int ret = counter_set_channel_alarm(trigger_counter, CAMERA_TRIGGER_CHANNEL, &cfg);
+
+	if (ret != 0 && ret != -ETIME) {
+		trigger_state = TRIGGER_IDLE;
+		k_spin_unlock(&trigger_lock, key);
+		LOG_WRN("Camera trigger alarm failed: %d", ret);
+		return false;
+	}
+	k_spin_unlock(&trigger_lock, key);
+	return true;
+}
+
+/**
+ * Configures the trigger line and starts the counter.
+ * @return 0 on success.
+ */
+static int camera_trigger_init(void)
+{
+	if (!device_is_ready(trigger_counter) || !gpio_is_ready_dt(&trigger_gpio)) {
+		LOG_WRN("Camera trigger hardware not ready, pulse disabled");
+		return 0;
+	}
+	if (counter_get_num_of_channels(trigger_counter) <= CAMERA_TRIGGER_CHANNEL ||
+	    gpio_pin_configure_dt(&trigger_gpio, GPIO_OUTPUT_INACTIVE) != 0) {
+		LOG_WRN("Camera trigger hardware unusable, pulse disabled");
+		return 0;
+	}
+	(void)counter_start(trigger_counter);
+	trigger_ready = true;
+	return 0;
+}
+
+SYS_INIT(camera_trigger_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
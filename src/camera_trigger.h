@@ -0,0 +1,27 @@
+#ifndef CAMERA_TRIGGER_H
+#define CAMERA_TRIGGER_H
+
+#include "common.h"
+
+/*
+ * Hardware-timed camera trigger: a counter alarm raises the camera-trigger
+ * GPIO at the microsecond the vehicle is predicted to reach the camera's
+ * focal point, and a second alarm ends the pulse. Thread scheduling only
+ * affects when the alarm is armed, not when it fires.
+ */
+
+#if IS_ENABLED(CONFIG_RADAR_CAMERA_TRIGGER_PULSE)
+
+bool camera_trigger_schedule(const sensor_data_t *s_data);
+
+#else
+
+static inline bool camera_trigger_schedule(const sensor_data_t *s_data)
+{
+	ARG_UNUSED(s_data);
+	return false;
+}
+
+#endif
+
+#endif
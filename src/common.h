@@ -1,8 +1,10 @@
 #ifndef COMMON_H
 #define COMMON_H
 
-#include <zephyr/kernel.h>
+#include "radar_os.h"
+#if defined(__ZEPHYR__)
 #include <zephyr/zbus/zbus.h>
+#endif
 
 // Vehicle Types
 typedef enum {
@@ -11,14 +13,46 @@ typedef enum {
     VEHICLE_UNKNOWN
 } vehicle_type_t;
 
+/*
+ * The message structs are generated from field lists, X(kind, field) or
+ * X(kind, field, arg), which schema.h also expands into the wire encoding,
+ * so a field cannot exist in memory without being serialized. Kinds:
+ *
+ *   U8        uint8_t
+ *   BOOL      bool
+ *   ENUM      arg is the enum type and its number of values
+ *   U32       uint32_t
+ *   I64       int64_t
+ *   STR       char[arg], NUL-terminated
+ */
+#define SCHEMA_CTYPE_U8(...)     uint8_t
+#define SCHEMA_CTYPE_BOOL(...)   bool
+#define SCHEMA_CTYPE_ENUM(t, n)  t
+#define SCHEMA_CTYPE_U32(...)    uint32_t
+#define SCHEMA_CTYPE_I64(...)    int64_t
+#define SCHEMA_CTYPE_STR(n)      char
+#define SCHEMA_DIM_U8(...)
+#define SCHEMA_DIM_BOOL(...)
+#define SCHEMA_DIM_ENUM(...)
+#define SCHEMA_DIM_U32(...)
+#define SCHEMA_DIM_I64(...)
+#define SCHEMA_DIM_STR(n)        [n]
+#define SCHEMA_MEMBER(kind, field, ...) \
+    SCHEMA_CTYPE_##kind(__VA_ARGS__) field SCHEMA_DIM_##kind(__VA_ARGS__);
+#define SCHEMA_STRUCT(fields) struct { fields(SCHEMA_MEMBER) }
+
 // Data from Sensor Thread to Main Thread
-typedef struct {
-    int64_t timestamp_start;
-    int64_t timestamp_end;
-    uint32_t duration_ms;
-    uint32_t axle_count;
-    vehicle_type_t type;
-} sensor_data_t;
+#define SCHEMA_SENSOR_DATA(X) \
+    X(I64, timestamp_start) \
+    X(I64, timestamp_end) \
+    X(U32, duration_ms) \
+    X(U32, duration_us) /* From the edge cycle counter, 0 when the edges had no cycle stamp */ \
+    X(U32, end_cycles) /* radar_cycles() at the end edge */ \
+    X(U32, axle_count) \
+    X(ENUM, type, vehicle_type_t, VEHICLE_UNKNOWN + 1) \
+    X(U8, lane) /* Sensor pair that produced the measurement */ \
+    X(U32, gross_weight_kg) /* Weigh-in-motion result, 0 when not weighed */
+typedef SCHEMA_STRUCT(SCHEMA_SENSOR_DATA) sensor_data_t;
 
 // Display Status
 typedef enum {
@@ -28,38 +62,52 @@ typedef enum {
 } display_status_t;
 
 // Data for Display
-typedef struct {
-    uint32_t speed_kmh;
-    uint32_t limit_kmh;
-    vehicle_type_t type;
-    display_status_t status;
-    char plate[10]; // Optional, for result display
-    uint32_t axle_count; // For UX display
-    uint32_t warning_kmh; // Threshold for yellow status
-} display_data_t;
+#define SCHEMA_DISPLAY_DATA(X) \
+    X(U32, speed_kmh) \
+    X(U32, limit_kmh) \
+    X(ENUM, type, vehicle_type_t, VEHICLE_UNKNOWN + 1) \
+    X(ENUM, status, display_status_t, STATUS_INFRACTION + 1) \
+    X(STR, plate, 10) /* Optional, for result display */ \
+    X(U32, axle_count) /* For UX display */ \
+    X(U32, warning_kmh) /* Threshold for yellow status */ \
+    X(BOOL, congested) /* Sent while the road is congested */ \
+    X(U32, aggregate_vehicles) /* > 0: aggregate block over this many vehicles */ \
+    X(U32, occupancy_percent) /* Aggregate blocks only */ \
+    X(U32, gross_weight_kg) /* 0 when not weighed */ \
+    X(U32, weight_limit_kg) \
+    X(BOOL, overweight)
+typedef SCHEMA_STRUCT(SCHEMA_DISPLAY_DATA) display_data_t;
 
 // ZBUS: Camera Trigger
-typedef struct {
-    uint32_t speed_kmh;
-    vehicle_type_t type;
-} camera_trigger_t;
+#define SCHEMA_CAMERA_TRIGGER(X) \
+    X(U32, speed_kmh) \
+    X(ENUM, type, vehicle_type_t, VEHICLE_UNKNOWN + 1) \
+    X(U32, id) /* Matches the result to its pending infraction */ \
+    X(U8, lane) \
+    X(I64, timestamp_ms) /* When the vehicle entered the camera's view */
+typedef SCHEMA_STRUCT(SCHEMA_CAMERA_TRIGGER) camera_trigger_t;
 
 // ZBUS: Camera Result
-typedef struct {
-    char plate[10];
-    bool valid_read; // If the camera successfully read a plate
-} camera_result_t;
+#define SCHEMA_CAMERA_RESULT(X) \
+    X(STR, plate, 10) \
+    X(BOOL, valid_read) /* If the camera successfully read a plate */ \
+    X(U32, id) /* Of the trigger this result answers */
+typedef SCHEMA_STRUCT(SCHEMA_CAMERA_RESULT) camera_result_t;
 
+#if defined(__ZEPHYR__)
 // Channels
 ZBUS_CHAN_DECLARE(camera_trigger_chan);
 ZBUS_CHAN_DECLARE(camera_result_chan);
 
 // Message Queues
 extern struct k_msgq sensor_msgq;
-extern struct k_msgq display_msgq;
+#endif
 
 // Helper functions
 bool validate_plate(const char *plate);
+uint32_t plate_pack(const char *plate);
 uint32_t calculate_speed(uint32_t distance_mm, uint32_t duration_ms);
+int64_t predict_arrival_us(int64_t end_us, uint32_t duration_us, uint32_t sensor_distance_mm,
+                           uint32_t target_distance_mm);
 
 #endif
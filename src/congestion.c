@@ -0,0 +1,94 @@
+#include "congestion.h"
+#include <string.h>
+
+BUILD_ASSERT(CONFIG_RADAR_CONGESTION_EXIT_SPEED_KMH >= CONFIG_RADAR_CONGESTION_SPEED_KMH,
+	     "Congestion exit speed below the entry speed");
+BUILD_ASSERT(CONFIG_RADAR_CONGESTION_EXIT_OCCUPANCY_PERCENT <=
+		     CONFIG_RADAR_CONGESTION_OCCUPANCY_PERCENT,
+	     "Congestion exit occupancy above the entry occupancy");
+
+/**
+ * Maps a timestamp to its bucket index since boot.
+ * @param det Pointer to the detector.
+ * @param now_ms The timestamp.
+ * @return The bucket epoch.
+ */
+static inline int64_t congestion_epoch(const congestion_t *det, int64_t now_ms)
+{
+	return now_ms / (det->window_ms / CONGESTION_BUCKETS);
+}
+
+/**
+ * Initializes a congestion detector, in normal mode.
+ * @param det Pointer to the detector.
+ * @param window_ms Length of the sliding window.
+ */
+void congestion_init(congestion_t *det, uint32_t window_ms)
+{
+	memset(det->buckets, 0, sizeof(det->buckets));
+	for (int i = 0; i < CONGESTION_BUCKETS; i++) {
+		det->buckets[i].epoch = -1;
+	}
+	det->window_ms = MAX(window_ms, CONGESTION_BUCKETS);
+	det->active = false;
+}
+
+/**
+ * Sums the buckets still inside the window.
+ * @param det Pointer to the detector.
+ * @param now_ms The current timestamp.
+ * @param stats Pointer to the aggregates to fill.
+ */
+void congestion_get_stats(const congestion_t *det, int64_t now_ms, congestion_stats_t *stats)
+{
+	int64_t epoch = congestion_epoch(det, now_ms);
+	uint32_t vehicles = 0, speed_sum = 0, occupied_ms = 0;
+
+	for (int i = 0; i < CONGESTION_BUCKETS; i++) {
+		const congestion_bucket_t *b = &det->buckets[i];
+
+		if (b->epoch >= 0 && epoch - b->epoch < CONGESTION_BUCKETS) {
+			vehicles += b->vehicles;
+			speed_sum += b->speed_sum;
+			occupied_ms += b->occupied_ms;
+		}
+	}
+	stats->vehicles = vehicles;
+	stats->mean_speed_kmh = vehicles > 0 ? speed_sum / vehicles : 0;
+	stats->occupancy_percent = MIN((uint32_t)(((uint64_t)occupied_ms * 100) / det->window_ms), 100);
+}
+
+/**
+ * Adds one vehicle to the window and re-evaluates the mode.
+ * @param det Pointer to the detector.
+ * @param now_ms The time of the measurement.
+ * @param speed_kmh The measured speed.
+ * @param occupied_ms How long the vehicle occupied the detection zone.
+ * @return True if the road is congested, false otherwise.
+ */
+bool congestion_update(congestion_t *det, int64_t now_ms, uint32_t speed_kmh, uint32_t occupied_ms)
+{
+	int64_t epoch = congestion_epoch(det, now_ms);
+	congestion_bucket_t *b = &det->buckets[epoch % CONGESTION_BUCKETS];
+	congestion_stats_t stats;
+
+	if (b->epoch != epoch) {
+		b->epoch = epoch;
+		b->vehicles = 0;
+		b->speed_sum = 0;
+		b->occupied_ms = 0;
+	}
+	b->vehicles++;
+	b->speed_sum += speed_kmh;
+	b->occupied_ms += occupied_ms;
+
+	congestion_get_stats(det, now_ms, &stats);
+	if (!det->active) {
+		det->active = stats.mean_speed_kmh < CONFIG_RADAR_CONGESTION_SPEED_KMH &&
+			      stats.occupancy_percent >= CONFIG_RADAR_CONGESTION_OCCUPANCY_PERCENT;
+	} else {
+		det->active = stats.mean_speed_kmh < CONFIG_RADAR_CONGESTION_EXIT_SPEED_KMH &&
+			      stats.occupancy_percent >= CONFIG_RADAR_CONGESTION_EXIT_OCCUPANCY_PERCENT;
+	}
+	return det->active;
+}
@@ -0,0 +1,54 @@
+#ifndef CONGESTION_H
+#define CONGESTION_H
+
+#include "radar_os.h"
+
+#ifndef CONFIG_RADAR_CONGESTION_WINDOW_MS
+#define CONFIG_RADAR_CONGESTION_WINDOW_MS 60000
+#endif
+#ifndef CONFIG_RADAR_CONGESTION_SPEED_KMH
+#define CONFIG_RADAR_CONGESTION_SPEED_KMH 20
+#endif
+#ifndef CONFIG_RADAR_CONGESTION_OCCUPANCY_PERCENT
+#define CONFIG_RADAR_CONGESTION_OCCUPANCY_PERCENT 30
+#endif
+#ifndef CONFIG_RADAR_CONGESTION_EXIT_SPEED_KMH
+#define CONFIG_RADAR_CONGESTION_EXIT_SPEED_KMH 30
+#endif
+#ifndef CONFIG_RADAR_CONGESTION_EXIT_OCCUPANCY_PERCENT
+#define CONFIG_RADAR_CONGESTION_EXIT_OCCUPANCY_PERCENT 15
+#endif
+
+// The window slides in steps of one bucket
+#define CONGESTION_BUCKETS 6
+
+typedef struct {
+	int64_t epoch;        // Bucket index since boot, window_ms / CONGESTION_BUCKETS wide
+	uint32_t vehicles;
+	uint32_t speed_sum;   // km/h
+	uint32_t occupied_ms; // Time the zone between the sensors was occupied
+} congestion_bucket_t;
+
+// Aggregates over the current window
+typedef struct {
+	uint32_t vehicles;
+	uint32_t mean_speed_kmh;
+	uint32_t occupancy_percent;
+} congestion_stats_t;
+
+/*
+ * Stop-and-go detector: the road is congested when the mean speed over the
+ * window is low and the detection zone is occupied for a large share of it.
+ * Separate exit thresholds give hysteresis, so the mode does not flap.
+ */
+typedef struct {
+	congestion_bucket_t buckets[CONGESTION_BUCKETS];
+	uint32_t window_ms;
+	bool active;
+} congestion_t;
+
+void congestion_init(congestion_t *det, uint32_t window_ms);
+bool congestion_update(congestion_t *det, int64_t now_ms, uint32_t speed_kmh, uint32_t occupied_ms);
+void congestion_get_stats(const congestion_t *det, int64_t now_ms, congestion_stats_t *stats);
+
+#endif
@@ -0,0 +1,289 @@
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/logging/log_backend.h>
+#include <zephyr/logging/log_backend_std.h>
+#include <zephyr/logging/log_output.h>
+#include <zephyr/sys/printk-hooks.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <string.h>
+#include "console_ring.h"
+
+// Bytes handed to uart_fifo_fill() per call, at most the ring's contiguous run
+#define CONSOLE_RING_CHUNK 64
+// printk characters gathered before one copy into the ring
+#define CONSOLE_RING_LINE 32
+
+static const struct device *const console_uart = DEVICE_DT_GET(DT_CHOSEN(zephyr_console));
+
+RING_BUF_DECLARE(console_ring, CONFIG_RADAR_CONSOLE_RING_SIZE);
+static struct k_spinlock console_lock;
+static K_SEM_DEFINE(console_space, 0, K_SEM_MAX_LIMIT);
+static console_ring_stats_t console_stats;
+static bool console_tx_active;
+static uint32_t console_waiters;
+static uint8_t console_line[CONSOLE_RING_LINE];
+static size_t console_line_len;
+// Polled until the interrupt path is up, and again after a panic
+static bool console_polled = true;
+
+/**
+ * UART interrupt: moves the next contiguous run of the ring into the TX
+ * FIFO and turns the TX interrupt off once the ring is empty.
+ * @param dev The console UART.
+ * @param user_data Unused.
+ */
+static void console_ring_isr(const struct device *dev, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (!uart_irq_update(dev) || !uart_irq_tx_ready(dev)) {
+		return;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&console_lock);
+	uint8_t *data;
+	uint32_t len = ring_buf_get_claim(&console_ring, &data, CONSOLE_RING_CHUNK);
+
+	if (len == 0) {
+		(void)ring_buf_get_finish(&console_ring, 0);
+		uart_irq_tx_disable(dev);
+		console_tx_active = false;
+		k_spin_unlock(&console_lock, key);
+		return;
+	}
+
+	int sent = uart_fifo_fill(dev, data, len);
+
+	(void)ring_buf_get_finish(&console_ring, sent > 0 ? sent : 0);
+	console_stats.tx_irqs++;
+	uint32_t wake = sent > 0 ? console_waiters : 0;
+	console_waiters -= wake;
+	k_spin_unlock(&console_lock, key);
+
+	while (wake-- > 0) {
+		k_sem_give(&console_space);
+	}
+}
+
+/**
+ * Copies as much of a block as fits into the ring and starts the TX
+ * interrupt if it was idle.
+ * @param data The bytes.
+ * @param len The number of bytes.
+ * @param may_block Whether the caller may wait for space.
+ * @param wait Set to whether the caller should wait for space and retry.
+ * @return The number of bytes accepted.
+ */
+static size_t console_ring_put(const uint8_t *data, size_t len, bool may_block, bool *wait)
+{
+	k_spinlock_key_t key = k_spin_lock(&console_lock);
+	uint32_t put = ring_buf_put(&console_ring, data, len);
+	bool start = put > 0 && !console_tx_active;
+
+	console_stats.written += put;
+	console_stats.peak_used = MAX(console_stats.peak_used, ring_buf_size_get(&console_ring));
+	if (start) {
+		console_tx_active = true;
+	}
+
+	*wait = IS_ENABLED(CONFIG_RADAR_CONSOLE_RING_OVERFLOW_BLOCK) && put < len && may_block;
+	if (*wait) {
+		console_waiters++;
+	} else {
+		console_stats.dropped += len - put;
+	}
+	k_spin_unlock(&console_lock, key);
+
+	if (start) {
+		uart_irq_tx_enable(console_uart);
+	}
+	return put;
+}
+
+/**
+ * Queues bytes for the console, dropping or waiting for what does not fit.
+ * @param data The bytes.
+ * @param len The number of bytes.
+ * @param may_block Whether the caller may wait for space; only a thread
+ * that holds no lock may.
+ * @return The number of bytes accepted.
+ */
+static size_t console_ring_send(const uint8_t *data, size_t len, bool may_block)
+{
+	if (console_polled) {
+		for (size_t i = 0; i < len; i++) {
+			uart_poll_out(console_uart, data[i]);
+		}
+		return len;
+	}
+
+	size_t done = 0;
+	bool wait;
+
+	while (true) {
+		done += console_ring_put(data + done, len - done, may_block, &wait);
+		if (!wait) {
+			return done;
+		}
+		(void)k_sem_take(&console_space, K_FOREVER);
+	}
+}
+
+/**
+ * Queues bytes for the console. Never busy-waits on the UART; what does
+ * not fit is dropped, or waited for from threads with the blocking
+ * overflow policy.
+ * @param data The bytes.
+ * @param len The number of bytes.
+ * @return The number of bytes accepted.
+ */
+size_t console_ring_write(const uint8_t *data, size_t len)
+{
+	return console_ring_send(data, len, !k_is_in_isr());
+}
+
+/**
+ * Copies the ring counters.
+ * @param stats Pointer to the counters to fill.
+ */
+void console_ring_get_stats(console_ring_stats_t *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&console_lock);
+
+	*stats = console_stats;
+	stats->used = ring_buf_size_get(&console_ring);
+	k_spin_unlock(&console_lock, key);
+}
+
+/**
+ * Panic: stops the interrupt path, drains the ring by polling and keeps
+ * polling from then on, so fatal error output is never lost.
+ */
+static void console_ring_panic(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&console_lock);
+	uint8_t c;
+
+	uart_irq_tx_disable(console_uart);
+	console_tx_active = false;
+	console_polled = true;
+	while (ring_buf_get(&console_ring, &c, 1) == 1) {
+		uart_poll_out(console_uart, c);
+	}
+	for (size_t i = 0; i < console_line_len; i++) {
+		uart_poll_out(console_uart, console_line[i]);
+	}
+	console_line_len = 0;
+	k_spin_unlock(&console_lock, key);
+}
+
+/**
+ * printk hook: gathers characters into a short line and copies it into the
+ * ring at each newline or when it is full, so the ring and the TX
+ * interrupt are touched once per line rather than once per character.
+ * @param c The character.
+ * @return The character.
+ */
+static int console_ring_printk_out(int c)
+{
+	if (console_polled) {
+		uart_poll_out(console_uart, (unsigned char)c);
+		return c;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&console_lock);
+
+	console_line[console_line_len++] = (uint8_t)c;
+	if (c != '\n' && console_line_len < sizeof(console_line)) {
+		k_spin_unlock(&console_lock, key);
+		return c;
+	}
+
+	uint8_t line[CONSOLE_RING_LINE];
+	size_t len = console_line_len;
+
+	memcpy(line, console_line, len);
+	console_line_len = 0;
+	k_spin_unlock(&console_lock, key);
+
+	(void)console_ring_send(line, len, !k_is_in_isr());
+	return c;
+}
+
+#if defined(CONFIG_LOG) && !defined(CONFIG_LOG_MODE_MINIMAL)
+
+static uint8_t console_log_buf[CONFIG_RADAR_CONSOLE_RING_LOG_BUF_SIZE];
+
+/**
+ * log_output sink: formatted log text into the ring.
+ * @param data The bytes.
+ * @param length The number of bytes.
+ * @param ctx Unused.
+ * @return The number of bytes consumed.
+ */
+static int console_ring_log_out(uint8_t *data, size_t length, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	// May run under the logging lock in immediate mode, so never waits
+	(void)console_ring_send(data, length, false);
+	return (int)length;
+}
+
+LOG_OUTPUT_DEFINE(console_log_output, console_ring_log_out, console_log_buf,
+		  sizeof(console_log_buf));
+
+static void console_log_process(const struct log_backend *const backend,
+				union log_msg_generic *msg)
+{
+	ARG_UNUSED(backend);
+
+	log_output_msg_process(&console_log_output, &msg->log, log_backend_std_get_flags());
+}
+
+static void console_log_panic(const struct log_backend *const backend)
+{
+	ARG_UNUSED(backend);
+
+	console_ring_panic();
+	log_backend_std_panic(&console_log_output);
+}
+
+static void console_log_dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	ARG_UNUSED(backend);
+
+	log_backend_std_dropped(&console_log_output, cnt);
+}
+
+static const struct log_backend_api console_log_api = {
+	.process = console_log_process,
+	.panic = console_log_panic,
+	.dropped = IS_ENABLED(CONFIG_LOG_MODE_IMMEDIATE) ? NULL : console_log_dropped,
+};
+
+LOG_BACKEND_DEFINE(console_log_backend, console_log_api, true);
+
+#endif
+
+/**
+ * Takes over the console UART from the polled console driver.
+ * @return 0 on success, -ENODEV if the UART is not ready.
+ */
+static int console_ring_init(void)
+{
+	if (!device_is_ready(console_uart)) {
+		return -ENODEV;
+	}
+	if (uart_irq_callback_user_data_set(console_uart, console_ring_isr, NULL) != 0) {
+		return -ENOTSUP;
+	}
+	console_polled = false;
+	__printk_hook_install(console_ring_printk_out);
+	return 0;
+}
+
+// After the UART console driver, so this hook replaces its polled one
+SYS_INIT(console_ring_init, POST_KERNEL, 99);
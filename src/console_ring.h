@@ -0,0 +1,43 @@
+#ifndef CONSOLE_RING_H
+#define CONSOLE_RING_H
+
+#include <zephyr/kernel.h>
+
+/*
+ * Interrupt-driven console output. printk, the log backend and the display
+ * console sink copy their text into one RAM ring and return; the UART TX
+ * interrupt drains it in FIFO-sized chunks. Writers never busy-wait on the
+ * UART. After a panic the ring is flushed and output falls back to polling.
+ */
+
+typedef struct {
+	uint32_t written;   // Bytes accepted into the ring
+	uint32_t dropped;   // Bytes lost to a full ring
+	uint32_t used;      // Bytes waiting in the ring
+	uint32_t peak_used; // Ring high watermark in bytes
+	uint32_t tx_irqs;   // TX interrupts that moved data
+} console_ring_stats_t;
+
+#if IS_ENABLED(CONFIG_RADAR_CONSOLE_RING)
+
+size_t console_ring_write(const uint8_t *data, size_t len);
+void console_ring_get_stats(console_ring_stats_t *stats);
+
+#endif
+
+/**
+ * Writes a finished block of text to the console in one go: a single copy
+ * into the ring when it is enabled, printk otherwise.
+ * @param text The text.
+ * @param len The length of the text in bytes.
+ */
+static inline void console_write(const char *text, size_t len)
+{
+#if IS_ENABLED(CONFIG_RADAR_CONSOLE_RING)
+	(void)console_ring_write((const uint8_t *)text, len);
+#else
+	printk("%.*s", (int)len, text);
+#endif
+}
+
+#endif
@@ -0,0 +1,179 @@
+#include <string.h>
+#include "dataset.h"
+
+/**
+ * Gets a little-endian 32-bit value.
+ * @param p Pointer to its first byte.
+ * @return The value.
+ */
+static inline uint32_t get_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * Parses an unsigned decimal field and the separator after it.
+ * @param ds Pointer to the dataset, positioned on the field.
+ * @param end End of the line.
+ * @param value Pointer to the value to fill.
+ * @return True if the field held at least one digit and fits 32 bits.
+ */
+static bool csv_field(dataset_t *ds, size_t end, uint32_t *value)
+{
+	uint64_t v = 0;
+	size_t start = ds->pos;
+
+	while (ds->pos < end && ds->data[ds->pos] >= '0' && ds->data[ds->pos] <= '9') {
+		v = v * 10 + (ds->data[ds->pos++] - '0');
+		if (v > UINT32_MAX) {
+			return false;
+		}
+	}
+	if (ds->pos == start) {
+		return false;
+	}
+	if (ds->pos < end && ds->data[ds->pos] == ',') {
+		ds->pos++;
+	}
+	*value = (uint32_t)v;
+	return true;
+}
+
+/**
+ * Parses one CSV row.
+ * @param ds Pointer to the dataset, positioned at the start of the row.
+ * @param end End of the row, without the line break.
+ * @param s_data Pointer to the measurement to fill.
+ * @return True if the row is a valid vehicle.
+ */
+static bool csv_row(dataset_t *ds, size_t end, sensor_data_t *s_data)
+{
+	uint32_t timestamp_ms;
+	uint32_t lane;
+	uint32_t duration_ms;
+	uint32_t axles;
+	uint32_t gross_weight_kg = 0;
+
+	if (!csv_field(ds, end, &timestamp_ms) || !csv_field(ds, end, &lane) ||
+	    !csv_field(ds, end, &duration_ms) || !csv_field(ds, end, &axles) || ds->pos == end) {
+		return false;
+	}
+	char type = (char)ds->data[ds->pos++];
+	if (ds->pos < end && ds->data[ds->pos] == ',') {
+		ds->pos++;
+		if (!csv_field(ds, end, &gross_weight_kg)) {
+			return false;
+		}
+	}
+	if (ds->pos != end || (type != 'L' && type != 'H') || lane > UINT8_MAX ||
+	    duration_ms == 0 || axles == 0) {
+		return false;
+	}
+
+	s_data->timestamp_start = timestamp_ms;
+	s_data->duration_ms = duration_ms;
+	s_data->timestamp_end = s_data->timestamp_start + duration_ms;
+	s_data->axle_count = axles;
+	s_data->type = type == 'H' ? VEHICLE_HEAVY : VEHICLE_LIGHT;
+	s_data->lane = (uint8_t)lane;
+	s_data->gross_weight_kg = gross_weight_kg;
+	return true;
+}
+
+/**
+ * Reads the next vehicle of a CSV dataset.
+ * @param ds Pointer to the dataset.
+ * @param s_data Pointer to the measurement to fill.
+ * @return True if a vehicle was read, false at the end of the data.
+ */
+static bool csv_next(dataset_t *ds, sensor_data_t *s_data)
+{
+	while (ds->pos < ds->size) {
+		const uint8_t *nl = memchr(&ds->data[ds->pos], '\n', ds->size - ds->pos);
+		size_t next = nl != NULL ? (size_t)(nl - ds->data) + 1 : ds->size;
+		size_t end = nl != NULL ? next - 1 : ds->size;
+
+		if (end > ds->pos && ds->data[end - 1] == '\r') {
+			end--;
+		}
+		ds->line++;
+		bool skip = end == ds->pos || ds->data[ds->pos] == '#' ||
+			    (ds->line == 1 && (ds->data[ds->pos] < '0' || ds->data[ds->pos] > '9'));
+		bool valid = !skip && csv_row(ds, end, s_data);
+
+		ds->pos = next;
+		if (valid) {
+			return true;
+		}
+		if (!skip) {
+			ds->errors++;
+		}
+	}
+	return false;
+}
+
+/**
+ * Reads the next vehicle of a binary dataset.
+ * @param ds Pointer to the dataset.
+ * @param s_data Pointer to the measurement to fill.
+ * @return True if a vehicle was read, false at the end of the data.
+ */
+static bool binary_next(dataset_t *ds, sensor_data_t *s_data)
+{
+	while (ds->size - ds->pos >= DATASET_RECORD_SIZE) {
+		const uint8_t *p = &ds->data[ds->pos];
+		uint32_t duration_ms = (uint32_t)p[4] | ((uint32_t)p[5] << 8);
+
+		ds->pos += DATASET_RECORD_SIZE;
+		if (duration_ms == 0 || p[7] == 0 || p[8] > VEHICLE_HEAVY) {
+			ds->errors++;
+			continue;
+		}
+		s_data->timestamp_start = get_le32(p);
+		s_data->duration_ms = duration_ms;
+		s_data->timestamp_end = s_data->timestamp_start + duration_ms;
+		s_data->lane = p[6];
+		s_data->axle_count = p[7];
+		s_data->type = p[8] == 1 ? VEHICLE_HEAVY : VEHICLE_LIGHT;
+		s_data->gross_weight_kg = get_le32(p + 12);
+		return true;
+	}
+	if (ds->pos != ds->size) {
+		// Truncated last record
+		ds->errors++;
+		ds->pos = ds->size;
+	}
+	return false;
+}
+
+/**
+ * Opens a dataset held in memory; the format is told by the magic.
+ * @param ds Pointer to the dataset.
+ * @param data The file contents. Must stay valid while the dataset is read.
+ * @param size Their size in bytes.
+ */
+void dataset_open(dataset_t *ds, const void *data, size_t size)
+{
+	ds->data = data;
+	ds->size = size;
+	ds->pos = 0;
+	ds->line = 0;
+	ds->errors = 0;
+	ds->format = DATASET_CSV;
+	if (size >= DATASET_MAGIC_SIZE && memcmp(data, DATASET_MAGIC, DATASET_MAGIC_SIZE) == 0) {
+		ds->format = DATASET_BINARY;
+		ds->pos = DATASET_MAGIC_SIZE;
+	}
+}
+
+/**
+ * Reads the next vehicle, skipping and counting malformed rows.
+ * @param ds Pointer to the dataset.
+ * @param s_data Pointer to the measurement to fill; timestamps are the
+ *               dataset's own.
+ * @return True if a vehicle was read, false at the end of the data.
+ */
+RADAR_HOT bool dataset_next(dataset_t *ds, sensor_data_t *s_data)
+{
+	return ds->format == DATASET_BINARY ? binary_next(ds, s_data) : csv_next(ds, s_data);
+}
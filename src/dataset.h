@@ -0,0 +1,43 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include "radar_os.h"
+#include "common.h"
+
+/*
+ * Recorded traffic datasets, parsed in place from a buffer that holds the
+ * whole file (a memory-mapped file on native_sim). Two formats:
+ *
+ * CSV, one vehicle per line:
+ *     timestamp_ms,lane,duration_ms,axles,type[,gross_weight_kg]
+ * type is L or H. A first line that does not start with a digit is taken
+ * as a header; empty lines and lines starting with '#' are skipped.
+ *
+ * Binary: DATASET_MAGIC, then DATASET_RECORD_SIZE bytes per vehicle,
+ * little-endian: le32 timestamp_ms, le16 duration_ms, u8 lane, u8 axles,
+ * u8 type (0 light, 1 heavy), 3 bytes padding, le32 gross_weight_kg.
+ * scripts/dataset_gen.py writes both.
+ */
+
+#define DATASET_MAGIC       "RDRVDS01"
+#define DATASET_MAGIC_SIZE  8
+#define DATASET_RECORD_SIZE 16
+
+typedef enum {
+	DATASET_CSV,
+	DATASET_BINARY,
+} dataset_format_t;
+
+typedef struct {
+	const uint8_t *data;
+	size_t size;
+	size_t pos;
+	dataset_format_t format;
+	uint32_t line;   // CSV line of the last row read, 1-based
+	uint32_t errors; // Malformed rows skipped
+} dataset_t;
+
+void dataset_open(dataset_t *ds, const void *data, size_t size);
+bool dataset_next(dataset_t *ds, sensor_data_t *s_data);
+
+#endif
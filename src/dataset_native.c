@@ -0,0 +1,49 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "dataset_native.h"
+
+/**
+ * Maps a dataset file read-only into the process.
+ * @param path Path of the file on the host.
+ * @param size Pointer to the size to fill.
+ * @return The contents, or NULL if the file cannot be opened or is empty.
+ */
+const void *dataset_native_map(const char *path, size_t *size)
+{
+	struct stat st;
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0) {
+		return NULL;
+	}
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		return NULL;
+	}
+	void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	close(fd);
+	if (data == MAP_FAILED) {
+		return NULL;
+	}
+	// Read once, front to back
+	(void)madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+	*size = (size_t)st.st_size;
+	return data;
+}
+
+/**
+ * Reads the host's monotonic clock. Simulated time does not track the
+ * host when native_sim runs unthrottled, so rates are measured on this.
+ * @return Nanoseconds since an arbitrary point.
+ */
+uint64_t dataset_native_wall_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
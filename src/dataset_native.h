@@ -0,0 +1,15 @@
+#ifndef DATASET_NATIVE_H
+#define DATASET_NATIVE_H
+
+/*
+ * Host side of the dataset replay on native_sim. Built into the native
+ * simulator runner, so it uses the host's libc; keep Zephyr headers out.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+const void *dataset_native_map(const char *path, size_t *size);
+uint64_t dataset_native_wall_ns(void);
+
+#endif
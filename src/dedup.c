@@ -0,0 +1,145 @@
+#include "dedup.h"
+#include <string.h>
+
+BUILD_ASSERT((CONFIG_RADAR_DEDUP_SLOTS & (CONFIG_RADAR_DEDUP_SLOTS - 1)) == 0,
+	     "CONFIG_RADAR_DEDUP_SLOTS must be a power of two");
+BUILD_ASSERT(CONFIG_RADAR_DEDUP_SLOTS >= DEDUP_PROBES, "Set smaller than the probe window");
+
+/**
+ * Maps a key to its home slot.
+ * @param key The key to hash.
+ * @return The home slot index.
+ */
+static inline uint32_t dedup_home(uint32_t key)
+{
+	uint32_t h = key * 2654435761u;
+	return (h ^ (h >> 16)) & (CONFIG_RADAR_DEDUP_SLOTS - 1);
+}
+
+/**
+ * Checks whether an entry is still inside its time window.
+ * @param set Pointer to the set.
+ * @param entry Pointer to the entry.
+ * @param now_ms The current timestamp.
+ * @return True if the entry is live, false otherwise.
+ */
+static inline bool dedup_live(const dedup_set_t *set, const dedup_entry_t *entry, int64_t now_ms)
+{
+	int64_t age = now_ms - entry->stamp_ms;
+	return entry->used && age <= set->window_ms && -age <= set->window_ms;
+}
+
+/**
+ * Initializes a time-bounded set.
+ * @param set Pointer to the set.
+ * @param window_ms How long an entry stays live after its stamp.
+ */
+void dedup_set_init(dedup_set_t *set, uint32_t window_ms)
+{
+	memset(set->slots, 0, sizeof(set->slots));
+	set->window_ms = window_ms;
+}
+
+/**
+ * Looks up a live entry.
+ * @param set Pointer to the set.
+ * @param key The key to look up.
+ * @param now_ms The current timestamp.
+ * @return The live entry, or NULL if there is none.
+ */
+const dedup_entry_t *dedup_set_find(const dedup_set_t *set, uint32_t key, int64_t now_ms)
+{
+	uint32_t home = dedup_home(key);
+
+	for (uint32_t i = 0; i < DEDUP_PROBES; i++) {
+		const dedup_entry_t *e = &set->slots[(home + i) & (CONFIG_RADAR_DEDUP_SLOTS - 1)];
+		if (e->key == key && dedup_live(set, e, now_ms)) {
+			return e;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Inserts or refreshes an entry. When every probed slot is live, the
+ * oldest one is evicted, so the set never grows or fails.
+ * @param set Pointer to the set.
+ * @param key The key to insert.
+ * @param value The value stored with the key.
+ * @param now_ms The entry's timestamp.
+ */
+void dedup_set_insert(dedup_set_t *set, uint32_t key, uint32_t value, int64_t now_ms)
+{
+	uint32_t home = dedup_home(key);
+	dedup_entry_t *victim = NULL;
+
+	for (uint32_t i = 0; i < DEDUP_PROBES; i++) {
+		dedup_entry_t *e = &set->slots[(home + i) & (CONFIG_RADAR_DEDUP_SLOTS - 1)];
+		if ((e->used && e->key == key) || !dedup_live(set, e, now_ms)) {
+			victim = e;
+			break;
+		}
+		if (victim == NULL || e->stamp_ms < victim->stamp_ms) {
+			victim = e;
+		}
+	}
+
+	victim->key = key;
+	victim->value = value;
+	victim->stamp_ms = now_ms;
+	victim->used = true;
+}
+
+static inline uint32_t dedup_vehicle_key(uint8_t lane, int64_t bucket)
+{
+	return ((uint32_t)lane << 24) | ((uint32_t)bucket & 0x00FFFFFFu);
+}
+
+/**
+ * Checks a measurement against recent ones on the same lane and records it.
+ * Timestamps are bucketed by the window, so a neighbour within the window is
+ * always in the same or an adjacent bucket: three lookups, independent of load.
+ * Only one measurement per lane and bucket is kept, so the window must stay
+ * below the headway of two real vehicles.
+ * @param set Pointer to the vehicle set.
+ * @param lane The lane of the measurement.
+ * @param timestamp_ms The measurement timestamp.
+ * @param speed_kmh The measured speed.
+ * @param speed_tolerance_kmh Maximum speed difference for a duplicate.
+ * @return True if the measurement duplicates a recent one, false otherwise.
+ */
+bool dedup_vehicle_check(dedup_set_t *set, uint8_t lane, int64_t timestamp_ms, uint32_t speed_kmh,
+			 uint32_t speed_tolerance_kmh)
+{
+	int64_t bucket = timestamp_ms / (set->window_ms > 0 ? set->window_ms : 1);
+
+	for (int64_t b = bucket - 1; b <= bucket + 1; b++) {
+		const dedup_entry_t *e = dedup_set_find(set, dedup_vehicle_key(lane, b), timestamp_ms);
+		if (e == NULL) {
+			continue;
+		}
+		uint32_t diff = (e->value > speed_kmh) ? e->value - speed_kmh : speed_kmh - e->value;
+		if (diff <= speed_tolerance_kmh) {
+			return true;
+		}
+	}
+
+	dedup_set_insert(set, dedup_vehicle_key(lane, bucket), speed_kmh, timestamp_ms);
+	return false;
+}
+
+/**
+ * Checks a packed plate against recent reads and records it.
+ * @param set Pointer to the plate set.
+ * @param packed_plate The plate packed with plate_pack().
+ * @param now_ms The current timestamp.
+ * @return True if the plate was read within the window, false otherwise.
+ */
+bool dedup_plate_check(dedup_set_t *set, uint32_t packed_plate, int64_t now_ms)
+{
+	if (dedup_set_find(set, packed_plate, now_ms) != NULL) {
+		return true;
+	}
+	dedup_set_insert(set, packed_plate, 0, now_ms);
+	return false;
+}
@@ -0,0 +1,40 @@
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include "radar_os.h"
+
+#ifndef CONFIG_RADAR_DEDUP_SLOTS
+#define CONFIG_RADAR_DEDUP_SLOTS 16
+#endif
+#ifndef CONFIG_RADAR_DEDUP_WINDOW_MS
+#define CONFIG_RADAR_DEDUP_WINDOW_MS 30
+#endif
+#ifndef CONFIG_RADAR_DEDUP_SPEED_TOLERANCE_KMH
+#define CONFIG_RADAR_DEDUP_SPEED_TOLERANCE_KMH 5
+#endif
+
+// Slots probed per lookup; bounds every operation to O(1)
+#define DEDUP_PROBES 4
+
+typedef struct {
+	uint32_t key;
+	uint32_t value;
+	int64_t stamp_ms;
+	bool used;
+} dedup_entry_t;
+
+// Open-addressed set whose entries expire window_ms after their stamp
+typedef struct {
+	dedup_entry_t slots[CONFIG_RADAR_DEDUP_SLOTS];
+	uint32_t window_ms;
+} dedup_set_t;
+
+void dedup_set_init(dedup_set_t *set, uint32_t window_ms);
+const dedup_entry_t *dedup_set_find(const dedup_set_t *set, uint32_t key, int64_t now_ms);
+void dedup_set_insert(dedup_set_t *set, uint32_t key, uint32_t value, int64_t now_ms);
+
+bool dedup_vehicle_check(dedup_set_t *set, uint8_t lane, int64_t timestamp_ms, uint32_t speed_kmh,
+			 uint32_t speed_tolerance_kmh);
+bool dedup_plate_check(dedup_set_t *set, uint32_t packed_plate, int64_t now_ms);
+
+#endif
@@ -0,0 +1,176 @@
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include "display_fanout.h"
+#include "flight_recorder.h"
+#include "telemetry.h"
+
+LOG_MODULE_REGISTER(display_fanout, CONFIG_RADAR_LOG_LEVEL);
+
+// Runtime state of one sink, guarded by its lock
+typedef struct {
+	struct k_spinlock lock;
+	struct k_sem ready;
+	display_data_t slot;
+	uint32_t slot_cycles;
+	bool slot_full;
+	bool enabled;
+	display_sink_stats_t stats;
+} display_sink_state_t;
+
+K_THREAD_STACK_ARRAY_DEFINE(display_sink_stacks, DISPLAY_SINK_COUNT, CONFIG_RADAR_DISPLAY_STACK_SIZE);
+static struct k_thread display_sink_threads[DISPLAY_SINK_COUNT];
+static display_sink_state_t display_sink_states[DISPLAY_SINK_COUNT];
+
+/**
+ * Offers a frame to every enabled sink. Never blocks: a sink that has not
+ * taken its previous frame yet loses it to this one.
+ * @param data The frame.
+ */
+void display_publish(const display_data_t *data)
+{
+	uint32_t now = k_cycle_get_32();
+
+	for (size_t i = 0; i < display_sink_count; i++) {
+		display_sink_state_t *sink = &display_sink_states[i];
+		k_spinlock_key_t key = k_spin_lock(&sink->lock);
+
+		if (!sink->enabled) {
+			k_spin_unlock(&sink->lock, key);
+			continue;
+		}
+		if (sink->slot_full) {
+			sink->stats.dropped++;
+			telemetry_inc(TELEMETRY_DISPLAY_DROPPED);
+			FLIGHT_RECORD(FLIGHT_EV_DROP, 1, i);
+		}
+		sink->slot = *data;
+		sink->slot_cycles = now;
+		sink->slot_full = true;
+		sink->stats.published++;
+		k_spin_unlock(&sink->lock, key);
+		k_sem_give(&sink->ready);
+	}
+}
+
+/**
+ * Counts the sinks holding a frame they have not taken yet.
+ * @return The number of full slots.
+ */
+uint32_t display_fanout_pending(void)
+{
+	uint32_t pending = 0;
+
+	for (size_t i = 0; i < display_sink_count; i++) {
+		display_sink_state_t *sink = &display_sink_states[i];
+		k_spinlock_key_t key = k_spin_lock(&sink->lock);
+
+		pending += sink->slot_full ? 1 : 0;
+		k_spin_unlock(&sink->lock, key);
+	}
+	return pending;
+}
+
+/**
+ * Copies the counters of one sink.
+ * @param index The sink index in display_sinks.
+ * @param stats Pointer to the counters to fill.
+ */
+void display_fanout_get_stats(size_t index, display_sink_stats_t *stats)
+{
+	display_sink_state_t *sink = &display_sink_states[index];
+	k_spinlock_key_t key = k_spin_lock(&sink->lock);
+
+	*stats = sink->stats;
+	k_spin_unlock(&sink->lock, key);
+}
+
+/**
+ * Logs frames, drops and render latency of every enabled sink.
+ */
+void display_fanout_log_stats(void)
+{
+	for (size_t i = 0; i < display_sink_count; i++) {
+		display_sink_stats_t stats;
+
+		if (!display_sink_states[i].enabled) {
+			continue;
+		}
+		display_fanout_get_stats(i, &stats);
+		LOG_INF("Display %s: rendered=%u dropped=%u latency mean=%u max=%u us",
+			display_sinks[i].name, stats.rendered, stats.dropped,
+			stats.rendered > 0 ? (uint32_t)(stats.latency_sum_us / stats.rendered) : 0,
+			stats.latency_max_us);
+	}
+}
+
+/**
+ * Sink thread: renders the newest frame of its slot whenever one arrives.
+ * @param p1 Pointer to the sink descriptor.
+ * @param p2 Pointer to the sink's runtime state.
+ * @param p3 Unused.
+ */
+static void display_sink_thread(void *p1, void *p2, void *p3)
+{
+	const display_sink_t *desc = p1;
+	display_sink_state_t *sink = p2;
+	display_data_t frame;
+
+	while (1) {
+		k_sem_take(&sink->ready, K_FOREVER);
+		telemetry_inc(TELEMETRY_WAKEUP);
+
+		k_spinlock_key_t key = k_spin_lock(&sink->lock);
+		if (!sink->slot_full) {
+			// Several gives for one coalesced frame
+			k_spin_unlock(&sink->lock, key);
+			continue;
+		}
+		frame = sink->slot;
+		uint32_t published = sink->slot_cycles;
+		sink->slot_full = false;
+		k_spin_unlock(&sink->lock, key);
+
+		uint32_t t0 = k_cycle_get_32();
+		desc->render(&frame);
+		uint32_t done = k_cycle_get_32();
+		uint32_t latency_us = k_cyc_to_us_floor32(done - published);
+
+		telemetry_add_cycles(frame.congested ? TELEMETRY_MODE_CONGESTED : TELEMETRY_MODE_NORMAL,
+				     done - t0, 0);
+
+		key = k_spin_lock(&sink->lock);
+		sink->stats.rendered++;
+		sink->stats.latency_sum_us += latency_us;
+		sink->stats.latency_max_us = MAX(sink->stats.latency_max_us, latency_us);
+		k_spin_unlock(&sink->lock, key);
+	}
+}
+
+/**
+ * Brings up every sink and starts its thread. Sinks whose init fails are
+ * left disabled and never receive frames.
+ * @return 0 on success.
+ */
+static int display_fanout_init(void)
+{
+	for (size_t i = 0; i < display_sink_count; i++) {
+		const display_sink_t *desc = &display_sinks[i];
+		display_sink_state_t *sink = &display_sink_states[i];
+
+		k_sem_init(&sink->ready, 0, 1);
+		if (desc->init != NULL && desc->init() != 0) {
+			LOG_WRN("Display sink %s not available", desc->name);
+			continue;
+		}
+		sink->enabled = true;
+		k_tid_t tid = k_thread_create(&display_sink_threads[i], display_sink_stacks[i],
+					      K_THREAD_STACK_SIZEOF(display_sink_stacks[i]),
+					      display_sink_thread, (void *)desc, sink, NULL,
+					      desc->priority, 0, K_NO_WAIT);
+		k_thread_name_set(tid, desc->name);
+	}
+	return 0;
+}
+
+SYS_INIT(display_fanout_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
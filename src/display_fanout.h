@@ -0,0 +1,49 @@
+#ifndef DISPLAY_FANOUT_H
+#define DISPLAY_FANOUT_H
+
+#include <zephyr/kernel.h>
+#include "common.h"
+
+/*
+ * Display fan-out: display_publish() hands every frame to all sinks. Each
+ * sink has a one-frame coalescing slot and its own thread, so a slow sink
+ * only ever drops its own stale frames and never holds up the producer
+ * or the other sinks.
+ */
+
+// Sinks in this build: the console plus the optional ones; one thread and stack each
+#define DISPLAY_SINK_COUNT                                                                         \
+	(1 + IS_ENABLED(CONFIG_RADAR_DISPLAY_SINK_FRAMEBUFFER) +                                   \
+	 IS_ENABLED(CONFIG_RADAR_DISPLAY_SINK_LED) + IS_ENABLED(CONFIG_RADAR_DISPLAY_SINK_UART))
+
+typedef struct {
+	uint32_t published;      // Frames offered to the sink
+	uint32_t rendered;
+	uint32_t dropped;        // Frames overwritten before the sink got to them
+	uint32_t latency_max_us; // Publish until render done
+	uint64_t latency_sum_us;
+} display_sink_stats_t;
+
+// Sink descriptor; its runtime state is private to display_fanout.c
+typedef struct {
+	const char *name;
+	int (*init)(void); // Optional; a sink whose init fails stays disabled
+	void (*render)(const display_data_t *data);
+	int priority;
+} display_sink_t;
+
+#define DISPLAY_SINK(_name, _init, _render, _priority)                                             \
+	{                                                                                          \
+		.name = _name, .init = _init, .render = _render, .priority = _priority,            \
+	}
+
+// Defined with the renderers in display_sinks.c
+extern const display_sink_t display_sinks[];
+extern const size_t display_sink_count;
+
+void display_publish(const display_data_t *data);
+uint32_t display_fanout_pending(void);
+void display_fanout_get_stats(size_t index, display_sink_stats_t *stats);
+void display_fanout_log_stats(void);
+
+#endif
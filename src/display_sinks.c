@@ -0,0 +1,269 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/uart.h>
+#include "common.h"
+#include "console_ring.h"
+#include "display_fanout.h"
+
+LOG_MODULE_REGISTER(display_sinks, CONFIG_RADAR_LOG_LEVEL);
+
+#define ANSI_COLOR_RED     "\x1b[31m"
+#define ANSI_COLOR_GREEN   "\x1b[32m"
+#define ANSI_COLOR_YELLOW  "\x1b[33m"
+#define ANSI_COLOR_RESET   "\x1b[0m"
+
+// Longest status block with colour codes, plate and axle count
+#define CONSOLE_BLOCK_MAX 320
+
+/**
+ * Appends formatted text to a console block, truncating at its end.
+ * @param buf The block.
+ * @param len The current length of the block.
+ * @param fmt The format string.
+ * @return The new length of the block.
+ */
+static size_t console_append(char *buf, size_t len, const char *fmt, ...) {
+    va_list ap;
+
+    if (len >= CONSOLE_BLOCK_MAX - 1) {
+        return len;
+    }
+    va_start(ap, fmt);
+    int n = vsnprintk(buf + len, CONSOLE_BLOCK_MAX - len, fmt, ap);
+    va_end(ap);
+    if (n < 0) {
+        return len;
+    }
+    return MIN(len + (size_t)n, (size_t)CONSOLE_BLOCK_MAX - 1);
+}
+
+/**
+ * Console sink: the full status block, formatted in RAM and written to the
+ * console in one piece.
+ * @param data Pointer to the frame.
+ */
+static void display_render_console(const display_data_t *data) {
+    char buf[CONSOLE_BLOCK_MAX];
+    size_t len = 0;
+
+    // Congestion: one summary block stands in for the slow vehicles
+    if (data->aggregate_vehicles > 0) {
+        len = console_append(buf, len, "\n%s========================================%s\n", ANSI_COLOR_YELLOW, ANSI_COLOR_RESET);
+        len = console_append(buf, len, "%s RADAR STATUS: CONGESTIONAMENTO %s\n", ANSI_COLOR_YELLOW, ANSI_COLOR_RESET);
+        len = console_append(buf, len, " Veiculos: %u | Media: %u km/h | Ocupacao: %u%%\n",
+                             data->aggregate_vehicles, data->speed_kmh, data->occupancy_percent);
+        len = console_append(buf, len, "%s========================================%s\n\n", ANSI_COLOR_YELLOW, ANSI_COLOR_RESET);
+        console_write(buf, len);
+        return;
+    }
+
+    const char *color = ANSI_COLOR_RESET;
+    const char *status_str = "UNKNOWN";
+
+    // Determine the color and status string based on the status
+    switch (data->status) {
+        case STATUS_NORMAL:
+            color = ANSI_COLOR_GREEN;
+            status_str = "NORMAL";
+            break;
+        case STATUS_WARNING:
+            color = ANSI_COLOR_YELLOW;
+            status_str = "WARNING";
+            break;
+        case STATUS_INFRACTION:
+            color = ANSI_COLOR_RED;
+            status_str = "INFRACTION";
+            break;
+    }
+
+    // Format the display data
+    len = console_append(buf, len, "\n%s========================================%s\n", color, ANSI_COLOR_RESET);
+    len = console_append(buf, len, "%s RADAR STATUS: %s %s\n", color, status_str, ANSI_COLOR_RESET);
+    len = console_append(buf, len, " Velocidade: %d km/h\n", data->speed_kmh);
+    if (data->limit_kmh > 0) {
+        len = console_append(buf, len, " Limite: %d km/h (Alerta \xE2\x89\xA5 %d km/h)\n", data->limit_kmh, data->warning_kmh);
+    } else {
+        len = console_append(buf, len, " Limite: %d km/h\n", data->limit_kmh);
+    }
+    {
+        const char *tipo = "Desconhecido";
+        switch (data->type) {
+            case VEHICLE_LIGHT: tipo = "Leve"; break;
+            case VEHICLE_HEAVY: tipo = "Pesado"; break;
+            case VEHICLE_UNKNOWN: default: tipo = "Desconhecido"; break;
+        }
+        len = console_append(buf, len, " Veiculo: %s", tipo);
+    }
+    if (data->axle_count > 0) {
+        len = console_append(buf, len, " (Eixos: %d)", data->axle_count);
+    }
+    len = console_append(buf, len, "\n");
+    if (data->gross_weight_kg > 0) {
+        len = console_append(buf, len, " Peso: %u kg (Limite: %u kg)%s\n", data->gross_weight_kg,
+                             data->weight_limit_kg, data->overweight ? " EXCESSO" : "");
+    }
+
+    // If the plate is not empty, add the plate
+    if (data->plate[0] != '\0') {
+        len = console_append(buf, len, " Placa: %s\n", data->plate);
+    }
+    // End of the display data
+    len = console_append(buf, len, "%s========================================%s\n\n", color, ANSI_COLOR_RESET);
+    console_write(buf, len);
+}
+
+#if IS_ENABLED(CONFIG_RADAR_DISPLAY_SINK_FRAMEBUFFER)
+
+#define FB_MAX_WIDTH 64
+
+static const struct device *const fb_dev = DEVICE_DT_GET(DT_NODELABEL(dummy_display));
+static struct display_capabilities fb_caps;
+static uint8_t fb_row[FB_MAX_WIDTH * 4];
+
+/**
+ * Sets up the framebuffer sink.
+ * @return 0 on success, negative errno if the display cannot be used.
+ */
+static int display_init_framebuffer(void) {
+    if (!device_is_ready(fb_dev)) {
+        return -ENODEV;
+    }
+    display_get_capabilities(fb_dev, &fb_caps);
+    if (fb_caps.current_pixel_format != PIXEL_FORMAT_ARGB_8888 &&
+        fb_caps.current_pixel_format != PIXEL_FORMAT_RGB_888 &&
+        fb_caps.current_pixel_format != PIXEL_FORMAT_RGB_565) {
+        return -ENOTSUP;
+    }
+    display_blanking_off(fb_dev);
+    return 0;
+}
+
+/**
+ * Framebuffer sink: fills the panel with the status color.
+ * @param data Pointer to the frame.
+ */
+static void display_render_framebuffer(const display_data_t *data) {
+    // Green, yellow, red
+    static const uint8_t rgb[][3] = {{0, 200, 0}, {230, 200, 0}, {220, 0, 0}};
+    const uint8_t *c = rgb[data->aggregate_vehicles > 0 ? STATUS_WARNING : data->status];
+    uint16_t width = MIN(fb_caps.x_resolution, FB_MAX_WIDTH);
+    size_t bpp = fb_caps.current_pixel_format == PIXEL_FORMAT_RGB_565 ? 2 :
+                 fb_caps.current_pixel_format == PIXEL_FORMAT_RGB_888 ? 3 : 4;
+
+    for (uint16_t x = 0; x < width; x++) {
+        uint8_t *px = &fb_row[x * bpp];
+        if (bpp == 2) {
+            uint16_t v = ((c[0] & 0xf8) << 8) | ((c[1] & 0xfc) << 3) | (c[2] >> 3);
+            px[0] = v >> 8;
+            px[1] = v & 0xff;
+        } else if (bpp == 3) {
+            px[0] = c[0];
+            px[1] = c[1];
+            px[2] = c[2];
+        } else {
+            px[0] = c[2];
+            px[1] = c[1];
+            px[2] = c[0];
+            px[3] = 0xff;
+        }
+    }
+
+    struct display_buffer_descriptor desc = {
+        .buf_size = width * bpp,
+        .width = width,
+        .height = 1,
+        .pitch = width,
+    };
+    for (uint16_t y = 0; y < fb_caps.y_resolution; y++) {
+        display_write(fb_dev, 0, y, &desc, fb_row);
+    }
+}
+
+#endif
+
+#if IS_ENABLED(CONFIG_RADAR_DISPLAY_SINK_LED)
+
+static const struct gpio_dt_spec led_green = GPIO_DT_SPEC_GET(DT_ALIAS(led0), gpios);
+static const struct gpio_dt_spec led_red = GPIO_DT_SPEC_GET(DT_ALIAS(led1), gpios);
+
+/**
+ * Sets up the LED sink.
+ * @return 0 on success, negative errno if the LEDs cannot be used.
+ */
+static int display_init_led(void) {
+    if (!gpio_is_ready_dt(&led_green) || !gpio_is_ready_dt(&led_red)) {
+        return -ENODEV;
+    }
+    int ret = gpio_pin_configure_dt(&led_green, GPIO_OUTPUT_INACTIVE);
+    return ret != 0 ? ret : gpio_pin_configure_dt(&led_red, GPIO_OUTPUT_INACTIVE);
+}
+
+/**
+ * LED sink: green for normal, both for warning, red for infraction.
+ * @param data Pointer to the frame.
+ */
+static void display_render_led(const display_data_t *data) {
+    display_status_t status = data->aggregate_vehicles > 0 ? STATUS_NORMAL : data->status;
+
+    gpio_pin_set_dt(&led_green, status != STATUS_INFRACTION);
+    gpio_pin_set_dt(&led_red, status != STATUS_NORMAL);
+}
+
+#endif
+
+#if IS_ENABLED(CONFIG_RADAR_DISPLAY_SINK_UART)
+
+static const struct device *const sign_uart = DEVICE_DT_GET(DT_ALIAS(sign_uart));
+
+/**
+ * Sets up the UART sign sink.
+ * @return 0 on success, -ENODEV if the UART is not ready.
+ */
+static int display_init_uart(void) {
+    return device_is_ready(sign_uart) ? 0 : -ENODEV;
+}
+
+/**
+ * UART sign sink: one fixed-format line per frame, sent byte by byte.
+ * @param data Pointer to the frame.
+ */
+static void display_render_uart(const display_data_t *data) {
+    static const char *const status_str[] = {"OK", "ALERTA", "INFRACAO"};
+    char line[48];
+    int len;
+
+    if (data->aggregate_vehicles > 0) {
+        len = snprintf(line, sizeof(line), "LENTO %3u KM/H %3u VEIC\r\n", data->speed_kmh,
+                       data->aggregate_vehicles);
+    } else {
+        len = snprintf(line, sizeof(line), "%3u KM/H %s%s %s\r\n", data->speed_kmh,
+                       status_str[data->status], data->overweight ? " PESO" : "", data->plate);
+    }
+    for (int i = 0; i < len && i < (int)sizeof(line); i++) {
+        uart_poll_out(sign_uart, line[i]);
+    }
+}
+
+#endif
+
+// The fast sinks run above the slow ones
+const display_sink_t display_sinks[] = {
+#if IS_ENABLED(CONFIG_RADAR_DISPLAY_SINK_LED)
+    DISPLAY_SINK("led", display_init_led, display_render_led, 6),
+#endif
+    DISPLAY_SINK("console", NULL, display_render_console, 7),
+#if IS_ENABLED(CONFIG_RADAR_DISPLAY_SINK_FRAMEBUFFER)
+    DISPLAY_SINK("framebuffer", display_init_framebuffer, display_render_framebuffer, 7),
+#endif
+#if IS_ENABLED(CONFIG_RADAR_DISPLAY_SINK_UART)
+    DISPLAY_SINK("uart_sign", display_init_uart, display_render_uart, 8),
+#endif
+};
+
+const size_t display_sink_count = ARRAY_SIZE(display_sinks);
+
+BUILD_ASSERT(ARRAY_SIZE(display_sinks) == DISPLAY_SINK_COUNT, "Keep DISPLAY_SINK_COUNT in step with the sinks");
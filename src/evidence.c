@@ -0,0 +1,441 @@
+#include "evidence.h"
+#include <string.h>
+
+// Fixed point of the DCT: 13-bit constants, 2 extra bits kept between the passes
+#define DCT_CONST_BITS 13
+#define DCT_PASS1_BITS 2
+#define DCT_FIX(x)     ((int32_t)((x) * (1 << DCT_CONST_BITS) + 0.5))
+#define DCT_DESCALE(x, n) (((x) + (1 << ((n) - 1))) >> (n))
+
+#define FIX_0_298631336 DCT_FIX(0.298631336)
+#define FIX_0_390180644 DCT_FIX(0.390180644)
+#define FIX_0_541196100 DCT_FIX(0.541196100)
+#define FIX_0_765366865 DCT_FIX(0.765366865)
+#define FIX_0_899976223 DCT_FIX(0.899976223)
+#define FIX_1_175875602 DCT_FIX(1.175875602)
+#define FIX_1_501321110 DCT_FIX(1.501321110)
+#define FIX_1_847759065 DCT_FIX(1.847759065)
+#define FIX_1_961570560 DCT_FIX(1.961570560)
+#define FIX_2_053119869 DCT_FIX(2.053119869)
+#define FIX_2_562915447 DCT_FIX(2.562915447)
+#define FIX_3_072711026 DCT_FIX(3.072711026)
+
+// Natural index of each coefficient in zigzag order
+static const uint8_t evidence_zigzag[64] = {
+	0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,
+	12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,
+	35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+	58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+};
+
+// ITU T.81 Annex K: luminance quantization table at quality 50, natural order
+static const uint8_t evidence_luma_quant[64] = {
+	16, 11, 10, 16, 24,  40,  51,  61,  12, 12, 14, 19, 26,  58,  60,  55,
+	14, 13, 16, 24, 40,  57,  69,  56,  14, 17, 22, 29, 51,  87,  80,  62,
+	18, 22, 37, 56, 68,  109, 103, 77,  24, 35, 55, 64, 81,  104, 113, 92,
+	49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99,
+};
+
+// Annex K luminance Huffman tables: codes per length, then symbols
+static const uint8_t evidence_dc_bits[16] = {0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0};
+static const uint8_t evidence_dc_symbols[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+static const uint8_t evidence_ac_bits[16] = {0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d};
+static const uint8_t evidence_ac_symbols[162] = {
+	0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61,
+	0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52,
+	0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25,
+	0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45,
+	0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64,
+	0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83,
+	0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99,
+	0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6,
+	0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3,
+	0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8,
+	0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa,
+};
+
+#define EVIDENCE_EOB 0x00 // Rest of the block is zero
+#define EVIDENCE_ZRL 0xf0 // Sixteen zeros
+
+// Entropy-coded output: bits gather MSB first, 0xFF bytes get a stuffed 0x00
+typedef struct {
+	uint8_t *out;
+	size_t len;
+	size_t capacity;
+	uint32_t acc;
+	uint32_t bits; // Pending bits in acc
+	bool overflow;
+} evidence_writer_t;
+
+/**
+ * Builds the code table of one canonical Huffman table (T.81 Annex C).
+ * @param bits Number of codes of each length, 1 to 16 bits.
+ * @param symbols The symbols in code order.
+ * @param count The number of symbols.
+ * @param code Output code of each symbol.
+ * @param size Output length of each symbol's code.
+ */
+static void evidence_huffman(const uint8_t bits[16], const uint8_t *symbols, size_t count,
+			     uint16_t *code, uint8_t *size)
+{
+	uint16_t next = 0;
+	size_t k = 0;
+
+	for (uint32_t len = 1; len <= 16; len++) {
+		for (uint32_t i = 0; i < bits[len - 1] && k < count; i++, k++) {
+			code[symbols[k]] = next++;
+			size[symbols[k]] = (uint8_t)len;
+		}
+		next <<= 1;
+	}
+}
+
+/**
+ * Prepares an encoder for a quality level.
+ * @param enc Pointer to the encoder.
+ * @param quality 1 (smallest) to 100 (best), scaled like the IJG encoder.
+ */
+void evidence_init(evidence_encoder_t *enc, uint8_t quality)
+{
+	uint32_t q = MIN(MAX(quality, 1), 100);
+	uint32_t scale = q < 50 ? 5000 / q : 200 - 2 * q;
+
+	memset(enc, 0, sizeof(*enc));
+	for (uint32_t i = 0; i < 64; i++) {
+		uint32_t natural = evidence_zigzag[i];
+		uint32_t step = (evidence_luma_quant[natural] * scale + 50) / 100;
+
+		step = MIN(MAX(step, 1), 255);
+		enc->quant[i] = (uint8_t)step;
+		enc->divisor[natural] = (uint16_t)(step * 8);
+	}
+	evidence_huffman(evidence_dc_bits, evidence_dc_symbols, sizeof(evidence_dc_symbols),
+			 enc->dc_code, enc->dc_size);
+	evidence_huffman(evidence_ac_bits, evidence_ac_symbols, sizeof(evidence_ac_symbols),
+			 enc->ac_code, enc->ac_size);
+}
+
+/**
+ * Forward 8x8 DCT in place, integer only: rows, then columns, with the
+ * Loeffler-Ligtenberg-Moschytz factorization (12 multiplies per 8 points).
+ * The output is 8 times the orthonormal DCT, which the quantizer divides
+ * out along with the quantization step.
+ * @param block Level-shifted samples (-128..127) in, coefficients out.
+ */
+void evidence_fdct(int16_t block[64])
+{
+	int32_t ws[64];
+
+	for (uint32_t pass = 0; pass < 2; pass++) {
+		// Rows from block into ws, then columns from ws back into block
+		for (uint32_t i = 0; i < 8; i++) {
+			int32_t d[8];
+
+			for (uint32_t k = 0; k < 8; k++) {
+				d[k] = pass == 0 ? block[i * 8 + k] : ws[k * 8 + i];
+			}
+
+			int32_t tmp0 = d[0] + d[7];
+			int32_t tmp7 = d[0] - d[7];
+			int32_t tmp1 = d[1] + d[6];
+			int32_t tmp6 = d[1] - d[6];
+			int32_t tmp2 = d[2] + d[5];
+			int32_t tmp5 = d[2] - d[5];
+			int32_t tmp3 = d[3] + d[4];
+			int32_t tmp4 = d[3] - d[4];
+
+			// Even part
+			int32_t tmp10 = tmp0 + tmp3;
+			int32_t tmp13 = tmp0 - tmp3;
+			int32_t tmp11 = tmp1 + tmp2;
+			int32_t tmp12 = tmp1 - tmp2;
+			int32_t z1 = (tmp12 + tmp13) * FIX_0_541196100;
+			int32_t out[8];
+
+			// Odd part
+			int32_t z5 = (tmp4 + tmp5 + tmp6 + tmp7) * FIX_1_175875602;
+			int32_t o1 = (tmp4 + tmp7) * -FIX_0_899976223;
+			int32_t o2 = (tmp5 + tmp6) * -FIX_2_562915447;
+			int32_t o3 = (tmp4 + tmp6) * -FIX_1_961570560 + z5;
+			int32_t o4 = (tmp5 + tmp7) * -FIX_0_390180644 + z5;
+			int32_t odd[4] = {
+				tmp7 * FIX_1_501321110 + o1 + o4, tmp6 * FIX_3_072711026 + o2 + o3,
+				tmp5 * FIX_2_053119869 + o2 + o4, tmp4 * FIX_0_298631336 + o1 + o3,
+			};
+
+			if (pass == 0) {
+				const uint32_t n = DCT_CONST_BITS - DCT_PASS1_BITS;
+
+				out[0] = (tmp10 + tmp11) * (1 << DCT_PASS1_BITS);
+				out[4] = (tmp10 - tmp11) * (1 << DCT_PASS1_BITS);
+				out[2] = DCT_DESCALE(z1 + tmp13 * FIX_0_765366865, n);
+				out[6] = DCT_DESCALE(z1 - tmp12 * FIX_1_847759065, n);
+				for (uint32_t k = 0; k < 4; k++) {
+					out[2 * k + 1] = DCT_DESCALE(odd[k], n);
+				}
+				for (uint32_t k = 0; k < 8; k++) {
+					ws[i * 8 + k] = out[k];
+				}
+			} else {
+				const uint32_t n = DCT_CONST_BITS + DCT_PASS1_BITS;
+
+				out[0] = DCT_DESCALE(tmp10 + tmp11, DCT_PASS1_BITS);
+				out[4] = DCT_DESCALE(tmp10 - tmp11, DCT_PASS1_BITS);
+				out[2] = DCT_DESCALE(z1 + tmp13 * FIX_0_765366865, n);
+				out[6] = DCT_DESCALE(z1 - tmp12 * FIX_1_847759065, n);
+				for (uint32_t k = 0; k < 4; k++) {
+					out[2 * k + 1] = DCT_DESCALE(odd[k], n);
+				}
+				for (uint32_t k = 0; k < 8; k++) {
+					block[k * 8 + i] = (int16_t)out[k];
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Appends one byte, stuffing a zero after 0xFF.
+ * @param w Pointer to the writer.
+ * @param byte The byte.
+ */
+static inline void evidence_put_byte(evidence_writer_t *w, uint8_t byte)
+{
+	if (w->len + 2 > w->capacity) {
+		w->overflow = true;
+		return;
+	}
+	w->out[w->len++] = byte;
+	if (byte == 0xff) {
+		w->out[w->len++] = 0;
+	}
+}
+
+/**
+ * Appends a code of up to 16 bits to the entropy-coded data.
+ * @param w Pointer to the writer.
+ * @param code The code, right aligned.
+ * @param size Its length in bits.
+ */
+static inline void evidence_put_bits(evidence_writer_t *w, uint32_t code, uint32_t size)
+{
+	w->acc = (w->acc << size) | (code & ((1u << size) - 1));
+	w->bits += size;
+	while (w->bits >= 8) {
+		w->bits -= 8;
+		evidence_put_byte(w, (uint8_t)(w->acc >> w->bits));
+	}
+}
+
+/**
+ * Size category of a coefficient: the bits needed for its magnitude.
+ * @param v The coefficient.
+ * @return 0 for 0, up to 11 for DC differences.
+ */
+static inline uint32_t evidence_category(int32_t v)
+{
+	uint32_t m = (uint32_t)(v < 0 ? -v : v);
+
+	return m == 0 ? 0 : 32 - (uint32_t)__builtin_clz(m);
+}
+
+/**
+ * Appends the amplitude bits of a coefficient: its value for positive
+ * ones, its one's complement for negative ones.
+ * @param w Pointer to the writer.
+ * @param v The coefficient.
+ * @param size Its size category.
+ */
+static inline void evidence_put_amplitude(evidence_writer_t *w, int32_t v, uint32_t size)
+{
+	evidence_put_bits(w, (uint32_t)(v < 0 ? v - 1 : v), size);
+}
+
+/**
+ * Quantizes and entropy-codes one transformed block.
+ * @param enc Pointer to the encoder.
+ * @param w Pointer to the writer.
+ * @param block The DCT coefficients, natural order.
+ * @param prev_dc The quantized DC of the previous block, updated.
+ */
+static void evidence_put_block(const evidence_encoder_t *enc, evidence_writer_t *w,
+			       const int16_t block[64], int32_t *prev_dc)
+{
+	int32_t q[64];
+
+	// Round to nearest; only the magnitude is divided so both signs round alike
+	for (uint32_t i = 0; i < 64; i++) {
+		int32_t c = block[evidence_zigzag[i]];
+		uint32_t d = enc->divisor[evidence_zigzag[i]];
+		int32_t m = (int32_t)(((uint32_t)(c < 0 ? -c : c) + d / 2) / d);
+
+		q[i] = c < 0 ? -m : m;
+	}
+
+	int32_t diff = q[0] - *prev_dc;
+	uint32_t size = evidence_category(diff);
+
+	*prev_dc = q[0];
+	evidence_put_bits(w, enc->dc_code[size], enc->dc_size[size]);
+	evidence_put_amplitude(w, diff, size);
+
+	uint32_t run = 0;
+
+	for (uint32_t i = 1; i < 64; i++) {
+		if (q[i] == 0) {
+			run++;
+			continue;
+		}
+		while (run > 15) {
+			evidence_put_bits(w, enc->ac_code[EVIDENCE_ZRL], enc->ac_size[EVIDENCE_ZRL]);
+			run -= 16;
+		}
+		size = evidence_category(q[i]);
+		uint32_t symbol = (run << 4) | size;
+
+		evidence_put_bits(w, enc->ac_code[symbol], enc->ac_size[symbol]);
+		evidence_put_amplitude(w, q[i], size);
+		run = 0;
+	}
+	if (run > 0) {
+		evidence_put_bits(w, enc->ac_code[EVIDENCE_EOB], enc->ac_size[EVIDENCE_EOB]);
+	}
+}
+
+static inline uint8_t *evidence_put_be16(uint8_t *p, uint32_t v)
+{
+	*p++ = (uint8_t)(v >> 8);
+	*p++ = (uint8_t)v;
+	return p;
+}
+
+/**
+ * Writes one Huffman table as a DHT segment body.
+ * @param p Where to write.
+ * @param id Table class and id byte.
+ * @param bits Number of codes of each length.
+ * @param symbols The symbols.
+ * @param count The number of symbols.
+ * @return The byte after the table.
+ */
+static uint8_t *evidence_put_table(uint8_t *p, uint8_t id, const uint8_t bits[16],
+				   const uint8_t *symbols, size_t count)
+{
+	*p++ = id;
+	memcpy(p, bits, 16);
+	memcpy(p + 16, symbols, count);
+	return p + 16 + count;
+}
+
+/**
+ * Writes the markers ahead of the entropy-coded data: SOI, JFIF, the
+ * quantization table, frame header, Huffman tables and scan header.
+ * @param enc Pointer to the encoder.
+ * @param width Frame width.
+ * @param height Frame height.
+ * @param out Output, EVIDENCE_HEADER_SIZE bytes.
+ */
+static void evidence_put_header(const evidence_encoder_t *enc, uint16_t width, uint16_t height,
+				uint8_t *out)
+{
+	static const uint8_t jfif[] = {0xff, 0xd8, 0xff, 0xe0, 0, 16, 'J', 'F', 'I', 'F', 0,
+				       1,    1,    0,    0,    1, 0,  1,   0,   0};
+	uint8_t *p = out;
+
+	memcpy(p, jfif, sizeof(jfif));
+	p += sizeof(jfif);
+
+	// DQT: one 8-bit table, id 0
+	p = evidence_put_be16(p, 0xffdb);
+	p = evidence_put_be16(p, 2 + 1 + 64);
+	*p++ = 0;
+	memcpy(p, enc->quant, 64);
+	p += 64;
+
+	// SOF0: baseline, 8-bit samples, one component
+	p = evidence_put_be16(p, 0xffc0);
+	p = evidence_put_be16(p, 2 + 6 + 3);
+	*p++ = 8;
+	p = evidence_put_be16(p, height);
+	p = evidence_put_be16(p, width);
+	*p++ = 1;
+	*p++ = 1;    // Component id
+	*p++ = 0x11; // No subsampling
+	*p++ = 0;    // Quantization table 0
+
+	// DHT: DC table 0, AC table 0
+	p = evidence_put_be16(p, 0xffc4);
+	p = evidence_put_be16(p, 2 + 17 + sizeof(evidence_dc_symbols) + 17 +
+					 sizeof(evidence_ac_symbols));
+	p = evidence_put_table(p, 0x00, evidence_dc_bits, evidence_dc_symbols,
+			       sizeof(evidence_dc_symbols));
+	p = evidence_put_table(p, 0x10, evidence_ac_bits, evidence_ac_symbols,
+			       sizeof(evidence_ac_symbols));
+
+	// SOS: the one component with tables 0, full spectrum
+	p = evidence_put_be16(p, 0xffda);
+	p = evidence_put_be16(p, 2 + 1 + 2 + 3);
+	*p++ = 1;
+	*p++ = 1;
+	*p++ = 0x00;
+	*p++ = 0;
+	*p++ = 63;
+	*p++ = 0;
+}
+
+/**
+ * Compresses a grayscale frame into a baseline JPEG. Blocks past the right
+ * or bottom edge repeat the last column or row.
+ * @param enc Pointer to the encoder.
+ * @param pixels The frame, 8 bits per pixel.
+ * @param width Frame width.
+ * @param height Frame height.
+ * @param stride Bytes from one row to the next.
+ * @param out Output buffer.
+ * @param capacity Its size.
+ * @return The length of the JPEG, or 0 if it does not fit the buffer.
+ */
+size_t evidence_encode(const evidence_encoder_t *enc, const uint8_t *pixels, uint16_t width,
+		       uint16_t height, size_t stride, uint8_t *out, size_t capacity)
+{
+	evidence_writer_t w = {.out = out, .len = EVIDENCE_HEADER_SIZE, .capacity = capacity};
+	int32_t prev_dc = 0;
+	int16_t block[64];
+
+	if (width == 0 || height == 0 || capacity < EVIDENCE_HEADER_SIZE + 2) {
+		return 0;
+	}
+	evidence_put_header(enc, width, height, out);
+
+	for (uint32_t by = 0; by < height && !w.overflow; by += EVIDENCE_BLOCK) {
+		for (uint32_t bx = 0; bx < width; bx += EVIDENCE_BLOCK) {
+			for (uint32_t y = 0; y < EVIDENCE_BLOCK; y++) {
+				const uint8_t *row = pixels + MIN(by + y, height - 1u) * stride;
+
+				if (bx + EVIDENCE_BLOCK <= width) {
+					for (uint32_t x = 0; x < EVIDENCE_BLOCK; x++) {
+						block[y * 8 + x] = (int16_t)(row[bx + x] - 128);
+					}
+				} else {
+					for (uint32_t x = 0; x < EVIDENCE_BLOCK; x++) {
+						block[y * 8 + x] =
+							(int16_t)(row[MIN(bx + x, width - 1u)] - 128);
+					}
+				}
+			}
+			evidence_fdct(block);
+			evidence_put_block(enc, &w, block, &prev_dc);
+		}
+	}
+
+	// Pad the last byte with one bits, then EOI
+	if (w.bits > 0) {
+		evidence_put_bits(&w, 0x7f, 8 - w.bits);
+	}
+	if (w.overflow || w.len + 2 > capacity) {
+		return 0;
+	}
+	out[w.len++] = 0xff;
+	out[w.len++] = 0xd9;
+	return w.len;
+}
@@ -0,0 +1,37 @@
+#ifndef EVIDENCE_H
+#define EVIDENCE_H
+
+#include "radar_os.h"
+
+#ifndef CONFIG_RADAR_EVIDENCE_QUALITY
+#define CONFIG_RADAR_EVIDENCE_QUALITY 50
+#endif
+
+#define EVIDENCE_BLOCK 8
+// Markers, tables and frame header ahead of the entropy-coded data
+#define EVIDENCE_HEADER_SIZE 324
+
+/*
+ * Evidence frame compression: grayscale baseline JPEG, so any viewer opens
+ * the evidence. Each 8x8 block goes through an integer DCT (the LLM
+ * factorization with 13-bit fixed-point constants and 32-bit products,
+ * no floating point), is quantized with the standard luminance table scaled to
+ * the quality, and run-length/Huffman coded with the standard tables.
+ * Everything that depends only on the quality is precomputed in the
+ * encoder, so a frame costs no table setup.
+ */
+typedef struct {
+	uint16_t divisor[64];    // Quantizer in natural order, times the DCT's gain of 8
+	uint8_t quant[64];       // Quantization table as written to the stream, zigzag order
+	uint16_t ac_code[256];   // Huffman code of each AC symbol (run << 4 | size)
+	uint8_t ac_size[256];    // Its length in bits, 0 for unused symbols
+	uint16_t dc_code[12];    // Huffman code of each DC size category
+	uint8_t dc_size[12];
+} evidence_encoder_t;
+
+void evidence_init(evidence_encoder_t *enc, uint8_t quality);
+void evidence_fdct(int16_t block[64]);
+size_t evidence_encode(const evidence_encoder_t *enc, const uint8_t *pixels, uint16_t width,
+		       uint16_t height, size_t stride, uint8_t *out, size_t capacity);
+
+#endif
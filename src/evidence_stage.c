@@ -0,0 +1,216 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include "evidence.h"
+#include "evidence_stage.h"
+
+LOG_MODULE_REGISTER(evidence, CONFIG_RADAR_LOG_LEVEL);
+
+BUILD_ASSERT(CONFIG_RADAR_EVIDENCE_MAX_BYTES > EVIDENCE_HEADER_SIZE,
+	     "Compressed frames would not even hold the JPEG header");
+
+// A captured frame on its way to the worker, owned by whoever holds the job
+typedef struct {
+	lpr_frame_t *frame;
+	uint32_t id;
+} evidence_job_t;
+
+typedef struct {
+	uint32_t id;   // Trigger id of the infraction
+	uint8_t *jpeg; // Block of evidence_jpeg_slab
+	size_t len;
+} evidence_entry_t;
+
+K_MEM_SLAB_DEFINE_STATIC(evidence_frame_slab, sizeof(lpr_frame_t), CONFIG_RADAR_EVIDENCE_FRAMES, 4);
+K_MEM_SLAB_DEFINE_STATIC(evidence_jpeg_slab, CONFIG_RADAR_EVIDENCE_MAX_BYTES,
+			 CONFIG_RADAR_EVIDENCE_STORE, 4);
+// Never full: there are no more jobs than frame buffers
+K_MSGQ_DEFINE(evidence_msgq, sizeof(evidence_job_t), CONFIG_RADAR_EVIDENCE_FRAMES, 4);
+
+static evidence_encoder_t encoder;
+static evidence_encoder_t encoder_fallback; // Half the quality, for frames that do not fit
+// Thread context only; a mutex keeps interrupts on while evidence is copied out
+static K_MUTEX_DEFINE(store_lock);
+static evidence_entry_t store[CONFIG_RADAR_EVIDENCE_STORE];
+static size_t store_head; // Oldest entry
+static size_t store_count;
+static evidence_stats_t stats;
+
+static void evidence_work_handler(void);
+RADAR_WORKER_DEFINE(evidence_worker, evidence_work_handler, CONFIG_RADAR_EVIDENCE_STACK_SIZE,
+		    CONFIG_RADAR_EVIDENCE_PRIORITY);
+
+/**
+ * Takes a block for the compressed frame. Once every block holds stored
+ * evidence, the oldest is given up for it.
+ * @return The block.
+ */
+static uint8_t *evidence_jpeg_alloc(void)
+{
+	void *block;
+
+	if (k_mem_slab_alloc(&evidence_jpeg_slab, &block, K_NO_WAIT) != 0) {
+		k_mutex_lock(&store_lock, K_FOREVER);
+
+		block = store[store_head].jpeg;
+		store_head = (store_head + 1) % CONFIG_RADAR_EVIDENCE_STORE;
+		store_count--;
+		stats.evicted++;
+		k_mutex_unlock(&store_lock);
+	}
+	return block;
+}
+
+/**
+ * Compresses one captured frame, frees its buffer and stores the result.
+ * @param job The frame and its trigger id.
+ */
+static void evidence_compress(const evidence_job_t *job)
+{
+	const uint8_t *pixels = &job->frame->pixels[0][0];
+	uint8_t *jpeg = evidence_jpeg_alloc();
+	uint32_t used = k_mem_slab_num_used_get(&evidence_jpeg_slab);
+	uint32_t start = k_cycle_get_32();
+	bool retried = false;
+	size_t len = evidence_encode(&encoder, pixels, LPR_WIDTH, LPR_HEIGHT, LPR_WIDTH, jpeg,
+				     CONFIG_RADAR_EVIDENCE_MAX_BYTES);
+
+	if (len == 0) {
+		retried = true;
+		len = evidence_encode(&encoder_fallback, pixels, LPR_WIDTH, LPR_HEIGHT, LPR_WIDTH, jpeg,
+				      CONFIG_RADAR_EVIDENCE_MAX_BYTES);
+	}
+	uint32_t cycles = k_cycle_get_32() - start;
+
+	k_mem_slab_free(&evidence_frame_slab, job->frame);
+
+	k_mutex_lock(&store_lock, K_FOREVER);
+	stats.retried += retried;
+	stats.peak_jpeg = MAX(stats.peak_jpeg, used);
+	if (len == 0) {
+		stats.dropped++;
+		k_mutex_unlock(&store_lock);
+		k_mem_slab_free(&evidence_jpeg_slab, jpeg);
+		LOG_WRN("Evidence of vehicle %u over %u bytes, dropped", job->id,
+			CONFIG_RADAR_EVIDENCE_MAX_BYTES);
+		return;
+	}
+	store[(store_head + store_count) % CONFIG_RADAR_EVIDENCE_STORE] = (evidence_entry_t){
+		.id = job->id,
+		.jpeg = jpeg,
+		.len = len,
+	};
+	store_count++;
+	stats.frames++;
+	stats.raw_bytes += sizeof(lpr_frame_t);
+	stats.jpeg_bytes += len;
+	stats.cycles += cycles;
+	k_mutex_unlock(&store_lock);
+
+	LOG_DBG("Evidence of vehicle %u: %u bytes in %u us", job->id, (uint32_t)len,
+		k_cyc_to_us_floor32(cycles));
+}
+
+/**
+ * Work handler: compresses every frame queued so far.
+ */
+static void evidence_work_handler(void)
+{
+	evidence_job_t job;
+
+	while (k_msgq_get(&evidence_msgq, &job, K_NO_WAIT) == 0) {
+		evidence_compress(&job);
+	}
+}
+
+/**
+ * Takes a buffer to capture a frame into. Waits for the worker when all
+ * buffers are taken, which holds the camera back instead of losing
+ * evidence.
+ * @return The frame buffer, to be passed to evidence_submit().
+ */
+lpr_frame_t *evidence_frame_alloc(void)
+{
+	void *block;
+
+	(void)k_mem_slab_alloc(&evidence_frame_slab, &block, K_FOREVER);
+
+	uint32_t used = k_mem_slab_num_used_get(&evidence_frame_slab);
+
+	k_mutex_lock(&store_lock, K_FOREVER);
+	stats.peak_frames = MAX(stats.peak_frames, used);
+	k_mutex_unlock(&store_lock);
+	return block;
+}
+
+/**
+ * Hands a captured frame over for compression. The buffer belongs to the
+ * stage from here on.
+ * @param frame The frame, from evidence_frame_alloc().
+ * @param id The trigger id of the infraction it shows.
+ */
+void evidence_submit(lpr_frame_t *frame, uint32_t id)
+{
+	evidence_job_t job = {.frame = frame, .id = id};
+
+	(void)k_msgq_put(&evidence_msgq, &job, K_NO_WAIT);
+	radar_worker_submit(&evidence_worker);
+}
+
+/**
+ * Copies the stored evidence of an infraction.
+ * @param id The trigger id.
+ * @param out Output buffer.
+ * @param capacity Its size.
+ * @return The JPEG's length, or 0 if it is not stored or does not fit.
+ */
+size_t evidence_copy(uint32_t id, uint8_t *out, size_t capacity)
+{
+	size_t len = 0;
+	k_mutex_lock(&store_lock, K_FOREVER);
+
+	for (size_t i = 0; i < store_count; i++) {
+		const evidence_entry_t *e = &store[(store_head + i) % CONFIG_RADAR_EVIDENCE_STORE];
+
+		if (e->id == id && e->len <= capacity) {
+			memcpy(out, e->jpeg, e->len);
+			len = e->len;
+			break;
+		}
+	}
+	k_mutex_unlock(&store_lock);
+	return len;
+}
+
+/**
+ * Gets the stage statistics.
+ * @param out Pointer to the copy.
+ */
+void evidence_get_stats(evidence_stats_t *out)
+{
+	k_mutex_lock(&store_lock, K_FOREVER);
+	*out = stats;
+	k_mutex_unlock(&store_lock);
+}
+
+/**
+ * Peak RAM the stage has used: raw and compressed buffers at their
+ * highest, plus the encoder tables.
+ * @param s The stage statistics.
+ * @return Bytes.
+ */
+size_t evidence_peak_ram(const evidence_stats_t *s)
+{
+	return s->peak_frames * sizeof(lpr_frame_t) + s->peak_jpeg * CONFIG_RADAR_EVIDENCE_MAX_BYTES +
+	       sizeof(encoder) + sizeof(encoder_fallback);
+}
+
+static int evidence_stage_init(void)
+{
+	evidence_init(&encoder, CONFIG_RADAR_EVIDENCE_QUALITY);
+	evidence_init(&encoder_fallback, CONFIG_RADAR_EVIDENCE_QUALITY / 2);
+	return 0;
+}
+
+SYS_INIT(evidence_stage_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
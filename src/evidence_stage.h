@@ -0,0 +1,32 @@
+#ifndef EVIDENCE_STAGE_H
+#define EVIDENCE_STAGE_H
+
+#include "lpr.h"
+
+/*
+ * Evidence stage: frames are captured straight into blocks of a memory
+ * slab, read by the camera in place, then handed by pointer to a
+ * low-priority worker that compresses them and gives the block back. The
+ * compressed frames go to blocks of a second slab, the most recent ones
+ * kept by trigger id. No frame is ever copied.
+ */
+
+typedef struct {
+	uint32_t frames;      // Frames compressed
+	uint32_t retried;     // Compressed again at half the quality to fit
+	uint32_t dropped;     // Did not fit even then
+	uint32_t evicted;     // Stored frames overwritten by newer ones
+	uint64_t raw_bytes;   // Input of the compressed frames
+	uint64_t jpeg_bytes;  // Their output
+	uint64_t cycles;      // Spent compressing
+	uint32_t peak_frames; // Most raw frame buffers taken at once
+	uint32_t peak_jpeg;   // Most compressed frame buffers taken at once
+} evidence_stats_t;
+
+lpr_frame_t *evidence_frame_alloc(void);
+void evidence_submit(lpr_frame_t *frame, uint32_t id);
+size_t evidence_copy(uint32_t id, uint8_t *out, size_t capacity);
+void evidence_get_stats(evidence_stats_t *stats);
+size_t evidence_peak_ram(const evidence_stats_t *stats);
+
+#endif
@@ -0,0 +1,161 @@
+#include "flight_recorder.h"
+#include <string.h>
+
+BUILD_ASSERT((CONFIG_RADAR_FLIGHT_RECORDER_EVENTS & (CONFIG_RADAR_FLIGHT_RECORDER_EVENTS - 1)) == 0,
+	     "CONFIG_RADAR_FLIGHT_RECORDER_EVENTS must be a power of two");
+BUILD_ASSERT(FLIGHT_EV_COUNT <= 16, "Event types must fit in 4 bits");
+
+// Survives warm resets (fault, watchdog, sys_reboot) on Zephyr targets
+#if defined(__ZEPHYR__)
+__noinit
+#endif
+flight_ring_t flight_ring;
+
+static const char *const type_names[FLIGHT_EV_COUNT] = {
+	[FLIGHT_EV_BOOT] = "boot",
+	[FLIGHT_EV_EDGE_START] = "edge_start",
+	[FLIGHT_EV_EDGE_END] = "edge_end",
+	[FLIGHT_EV_FINALIZE] = "finalize",
+	[FLIGHT_EV_SPEED] = "speed",
+	[FLIGHT_EV_TRIGGER] = "trigger",
+	[FLIGHT_EV_RESULT] = "result",
+	[FLIGHT_EV_LOG_ADD] = "log_add",
+	[FLIGHT_EV_DROP] = "drop",
+};
+
+/**
+ * Validates the ring left in RAM by the previous boot and records a boot
+ * event. A ring with a bad header (cold boot) is cleared first.
+ * @return True if events from the previous boot were kept, false otherwise.
+ */
+bool flight_recorder_init(void)
+{
+	bool kept = flight_ring.magic == FLIGHT_RECORDER_MAGIC &&
+		    flight_ring.size == CONFIG_RADAR_FLIGHT_RECORDER_EVENTS;
+
+	if (!kept) {
+		memset(&flight_ring, 0, sizeof(flight_ring));
+		flight_ring.magic = FLIGHT_RECORDER_MAGIC;
+		flight_ring.size = CONFIG_RADAR_FLIGHT_RECORDER_EVENTS;
+	}
+	flight_ring.boots++;
+	flight_recorder_record(FLIGHT_EV_BOOT, 0, (uint16_t)flight_ring.boots);
+	return kept;
+}
+
+/**
+ * Reads one event out of the ring. It is rejected if its writer has not
+ * finished (either half has the wrong lap tag) or a writer of a later lap
+ * may have overwritten it during the read.
+ * @param seq The event's sequence number.
+ * @param raw Set to the event as one 64-bit word.
+ * @return True if the event is whole.
+ */
+bool flight_recorder_read(uint32_t seq, uint64_t *raw)
+{
+	const volatile uint64_t *slot =
+		&flight_ring.events[seq & (CONFIG_RADAR_FLIGHT_RECORDER_EVENTS - 1)];
+	uint64_t word = *slot;
+	uint64_t tag = flight_recorder_tag(seq);
+
+	radar_atomic_fence();
+	if (((word >> 28) & 0xf) != tag || ((word >> 36) & 0xf) != tag ||
+	    (uint32_t)radar_atomic_get(&flight_ring.head) - seq > CONFIG_RADAR_FLIGHT_RECORDER_EVENTS) {
+		return false;
+	}
+	*raw = word;
+	return true;
+}
+
+/**
+ * Splits a packed ring word into its fields.
+ * @param raw The packed event.
+ * @param event Pointer to the event to fill.
+ */
+void flight_recorder_unpack(uint64_t raw, flight_event_t *event)
+{
+	event->time_ms = (uint32_t)raw & FLIGHT_TIME_MASK;
+	event->type = (uint8_t)((raw >> 32) & 0xf);
+	event->arg = (uint8_t)(raw >> 40);
+	event->value = (uint16_t)(raw >> 48);
+}
+
+/**
+ * Copies the recorded events, oldest first. Torn events are left out.
+ * @param out Output array.
+ * @param max_events Capacity of the output array.
+ * @return The number of events copied.
+ */
+size_t flight_recorder_snapshot(flight_event_t *out, size_t max_events)
+{
+	uint32_t head = (uint32_t)radar_atomic_get(&flight_ring.head);
+	uint32_t count = MIN(head, (uint32_t)CONFIG_RADAR_FLIGHT_RECORDER_EVENTS);
+	size_t copied = 0;
+
+	for (uint32_t i = 0; i < count && copied < max_events; i++) {
+		uint64_t raw;
+
+		if (flight_recorder_read(head - count + i, &raw)) {
+			flight_recorder_unpack(raw, &out[copied++]);
+		}
+	}
+	return copied;
+}
+
+/**
+ * Gets the printable name of an event type.
+ * @param type The event type.
+ * @return The name, or "?" for unknown types.
+ */
+const char *flight_recorder_type_name(uint8_t type)
+{
+	return type < FLIGHT_EV_COUNT ? type_names[type] : "?";
+}
+
+#if defined(__ZEPHYR__) && IS_ENABLED(CONFIG_RADAR_FLIGHT_RECORDER)
+
+#include <zephyr/sys/printk.h>
+
+/**
+ * Prints the ring straight from RAM, oldest first. Each line carries the raw
+ * word for scripts/flight_decode.py. Needs no stack buffer, so it is safe
+ * from the fatal error handler.
+ * @param why Header describing why the ring is printed.
+ */
+void flight_recorder_print(const char *why)
+{
+	uint32_t head = (uint32_t)radar_atomic_get(&flight_ring.head);
+	uint32_t count = MIN(head, (uint32_t)CONFIG_RADAR_FLIGHT_RECORDER_EVENTS);
+
+	printk("FR BEGIN %s: %u events, boot %u\n", why, count, flight_ring.boots);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t seq = head - count + i;
+		uint64_t raw;
+		flight_event_t ev;
+
+		if (!flight_recorder_read(seq, &raw)) {
+			printk("FR TORN seq=%u\n", seq);
+			continue;
+		}
+		flight_recorder_unpack(raw, &ev);
+		printk("FR %08x%08x t=%u %s arg=%u value=%u\n", (uint32_t)(raw >> 32), (uint32_t)raw,
+		       ev.time_ms, flight_recorder_type_name(ev.type), ev.arg, ev.value);
+	}
+	printk("FR END\n");
+}
+
+/**
+ * Prints what the previous boot left behind, then starts this boot's events.
+ * @return 0 on success.
+ */
+static int flight_recorder_boot(void)
+{
+	if (flight_recorder_init()) {
+		flight_recorder_print("previous boot");
+	}
+	return 0;
+}
+
+SYS_INIT(flight_recorder_boot, APPLICATION, 0);
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include "radar_os.h"
+
+#ifndef CONFIG_RADAR_FLIGHT_RECORDER_EVENTS
+#define CONFIG_RADAR_FLIGHT_RECORDER_EVENTS 64
+#endif
+
+// Ring header magic; anything else in noinit RAM means the ring is garbage
+#define FLIGHT_RECORDER_MAGIC 0x46524543u /* "FREC" */
+
+typedef enum {
+	FLIGHT_EV_BOOT,       // value: boot count
+	FLIGHT_EV_EDGE_START, // Start sensor edge
+	FLIGHT_EV_EDGE_END,   // End sensor edge
+	FLIGHT_EV_FINALIZE,   // arg: axles, value: duration in ms
+	FLIGHT_EV_SPEED,      // arg: display status, value: speed in km/h
+	FLIGHT_EV_TRIGGER,    // value: speed in km/h
+	FLIGHT_EV_RESULT,     // arg: valid read
+	FLIGHT_EV_LOG_ADD,    // arg: vehicle type, value: speed in km/h
+	FLIGHT_EV_DROP,       // arg: 0 sensor_msgq, 1 display sink; value: sink index
+	FLIGHT_EV_COUNT
+} flight_event_type_t;
+
+/*
+ * Event packed into one 64-bit word and written with a single store:
+ * bits 0-27 uptime in ms (wraps every 74 hours), 28-31 lap tag, 32-35 type,
+ * 36-39 lap tag, 40-47 arg, 48-63 value. A 32-bit core splits the store in
+ * two; both halves carry the tag of the lap that wrote them, so a reader
+ * tells an event torn by a preempted or crashed writer from a whole one.
+ */
+#define FLIGHT_TIME_MASK 0x0fffffffu
+
+typedef struct {
+	uint32_t time_ms;
+	uint8_t type;
+	uint8_t arg;
+	uint16_t value;
+} flight_event_t;
+
+typedef struct {
+	uint32_t magic;
+	uint32_t size;
+	uint32_t boots;
+	radar_atomic_t head; // Total events ever recorded; slot is head % size
+	uint64_t events[CONFIG_RADAR_FLIGHT_RECORDER_EVENTS];
+} flight_ring_t;
+
+extern flight_ring_t flight_ring;
+
+/**
+ * Gets the lap tag an event carries. Lap 0 has tag 1, so a zeroed slot
+ * never passes for a written one.
+ * @param seq The event's sequence number.
+ * @return The tag, 4 bits.
+ */
+static inline uint32_t flight_recorder_tag(uint32_t seq)
+{
+	return (seq / CONFIG_RADAR_FLIGHT_RECORDER_EVENTS + 1) & 0xf;
+}
+
+/**
+ * Records an event. Lock-free; safe from ISR and any thread.
+ * @param type The event type.
+ * @param arg Small event argument.
+ * @param value Event value.
+ */
+static inline void flight_recorder_record(flight_event_type_t type, uint8_t arg, uint16_t value)
+{
+	uint32_t seq = (uint32_t)radar_atomic_inc(&flight_ring.head);
+	uint64_t tag = flight_recorder_tag(seq);
+
+	flight_ring.events[seq & (CONFIG_RADAR_FLIGHT_RECORDER_EVENTS - 1)] =
+		((uint64_t)radar_uptime_ms() & FLIGHT_TIME_MASK) | (tag << 28) | ((uint64_t)type << 32) |
+		(tag << 36) | ((uint64_t)arg << 40) | ((uint64_t)value << 48);
+}
+
+#if IS_ENABLED(CONFIG_RADAR_FLIGHT_RECORDER)
+#define FLIGHT_RECORD(type, arg, value) flight_recorder_record(type, arg, value)
+#else
+#define FLIGHT_RECORD(type, arg, value) do { } while (0)
+#endif
+
+bool flight_recorder_init(void);
+size_t flight_recorder_snapshot(flight_event_t *out, size_t max_events);
+bool flight_recorder_read(uint32_t seq, uint64_t *raw);
+void flight_recorder_unpack(uint64_t raw, flight_event_t *event);
+const char *flight_recorder_type_name(uint8_t type);
+#if defined(__ZEPHYR__)
+void flight_recorder_print(const char *why);
+#endif
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef FSM_H
+#define FSM_H
+
+#include "radar_os.h"
+
+/*
+ * Table-driven state machines, specialized at compile time.
+ *
+ * A machine is an X-macro table with one row per (state, event) pair:
+ *
+ *     #define MY_TABLE(X)                          \
+ *         X(STATE, EVENT, guard, action, next)     \
+ *         ...
+ *
+ * guard(m, arg) decides whether the row fires. action(m, arg) runs before
+ * the machine enters next and returns true if it produced output. A false
+ * guard, or a pair without a row, leaves the machine where it is. Guards and
+ * actions are static inline functions or function-like macros.
+ *
+ * FSM_DISPATCH_DEFINE() expands the table into a single switch over
+ * state * event_count + event, with every guard and action inlined into its
+ * case. The compiler lowers it to a jump table (or, for small tables, a few
+ * compares), so no table is left to interpret at runtime.
+ */
+
+// Guard for rows that always fire
+#define FSM_ALWAYS(m, arg) true
+// Action for rows that only change state
+#define FSM_NOP(m, arg)    false
+
+#define FSM_CASE(_state, _event, _guard, _action, _next)                                           \
+	case (unsigned int)(_state) * fsm_event_count + (unsigned int)(_event):                    \
+		if (!(_guard(m, arg))) {                                                           \
+			return false;                                                              \
+		} else {                                                                           \
+			bool out = _action(m, arg);                                                \
+			m->state = (_next);                                                        \
+			return out;                                                                \
+		}
+
+/**
+ * Defines a dispatch function for a transition table.
+ * @param _name The name of the function: bool _name(_machine_t *m, unsigned int event, _arg_t arg).
+ *              It returns what the fired action returned, false if no row fired.
+ * @param _machine_t The machine type; it needs a state member.
+ * @param _arg_t The type of the event argument handed to guards and actions.
+ * @param _event_count The number of events.
+ * @param _table The X-macro transition table.
+ */
+#define FSM_DISPATCH_DEFINE(_name, _machine_t, _arg_t, _event_count, _table)                       \
+	static inline bool _name(_machine_t *m, unsigned int event, _arg_t arg)                    \
+	{                                                                                          \
+		enum { fsm_event_count = (_event_count) };                                         \
+		switch ((unsigned int)m->state * fsm_event_count + event) {                        \
+			_table(FSM_CASE)                                                           \
+		default:                                                                           \
+			return false;                                                              \
+		}                                                                                  \
+	}
+
+#endif
@@ -0,0 +1,234 @@
+#include "histogram.h"
+#include <string.h>
+
+// Dump header: magic, format version, sub-bucket bits, reserved
+#define HISTOGRAM_MAGIC   0x48
+#define HISTOGRAM_VERSION 1
+
+BUILD_ASSERT(HISTOGRAM_SUB_BITS >= 1 && HISTOGRAM_SUB_BITS <= 7, "Unsupported sub-bucket bits");
+
+/**
+ * Clears every bucket. Not atomic with respect to concurrent records.
+ * @param hist Pointer to the histogram.
+ */
+void histogram_reset(histogram_t *hist)
+{
+	memset(hist->counts, 0, sizeof(hist->counts));
+}
+
+/**
+ * Copies a live histogram. Each bucket is read atomically; records that
+ * race with the copy land in this snapshot or the next one.
+ * @param hist Pointer to the histogram.
+ * @param snap Pointer to the snapshot to fill.
+ */
+void histogram_snapshot(const histogram_t *hist, histogram_snapshot_t *snap)
+{
+	snap->total = 0;
+	for (uint32_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+		snap->counts[i] = (uint32_t)radar_atomic_get((radar_atomic_t *)&hist->counts[i]);
+		snap->total += snap->counts[i];
+	}
+}
+
+/**
+ * Adds one snapshot into another, e.g. to combine per-lane histograms.
+ * @param dst Pointer to the snapshot accumulating the result.
+ * @param src Pointer to the snapshot to add.
+ */
+void histogram_merge(histogram_snapshot_t *dst, const histogram_snapshot_t *src)
+{
+	for (uint32_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+		dst->counts[i] += src->counts[i];
+	}
+	dst->total += src->total;
+}
+
+/**
+ * Gets the lowest value that maps to a bucket.
+ * @param bucket The bucket index.
+ * @return The lower bound, inclusive.
+ */
+uint32_t histogram_bucket_low(uint32_t bucket)
+{
+	if (bucket < HISTOGRAM_SUB_BUCKETS) {
+		return bucket;
+	}
+	uint32_t shift = (bucket >> HISTOGRAM_SUB_BITS) - 1u;
+	uint32_t sub = bucket & (HISTOGRAM_SUB_BUCKETS - 1u);
+
+	return (HISTOGRAM_SUB_BUCKETS + sub) << shift;
+}
+
+/**
+ * Gets the highest value that maps to a bucket.
+ * @param bucket The bucket index.
+ * @return The upper bound, inclusive.
+ */
+uint32_t histogram_bucket_high(uint32_t bucket)
+{
+	if (bucket < HISTOGRAM_SUB_BUCKETS) {
+		return bucket;
+	}
+	uint32_t shift = (bucket >> HISTOGRAM_SUB_BITS) - 1u;
+
+	return histogram_bucket_low(bucket) + ((1u << shift) - 1u);
+}
+
+/**
+ * Gets the value below which a fraction of the samples fall.
+ * @param snap Pointer to the snapshot.
+ * @param per_10k The percentile in hundredths of a percent (9990 = p99.9).
+ * @return The upper bound of the bucket holding that sample, 0 if empty.
+ */
+uint32_t histogram_percentile(const histogram_snapshot_t *snap, uint32_t per_10k)
+{
+	if (snap->total == 0) {
+		return 0;
+	}
+	per_10k = MIN(per_10k, 10000u);
+
+	uint64_t rank = ((uint64_t)snap->total * per_10k + 9999u) / 10000u;
+	uint64_t seen = 0;
+
+	rank = MAX(rank, 1u);
+	for (uint32_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+		seen += snap->counts[i];
+		if (seen >= rank) {
+			return histogram_bucket_high(i);
+		}
+	}
+	return histogram_max(snap);
+}
+
+/**
+ * Gets the largest recorded value, to bucket precision.
+ * @param snap Pointer to the snapshot.
+ * @return The upper bound of the highest non-empty bucket, 0 if empty.
+ */
+uint32_t histogram_max(const histogram_snapshot_t *snap)
+{
+	for (uint32_t i = HISTOGRAM_BUCKETS; i-- > 0;) {
+		if (snap->counts[i] != 0) {
+			return histogram_bucket_high(i);
+		}
+	}
+	return 0;
+}
+
+/**
+ * Writes a LEB128 varint.
+ * @param buf Output buffer.
+ * @param pos Write position.
+ * @param len Size of the output buffer.
+ * @param value The value to write.
+ * @return The position after the varint, 0 if it does not fit.
+ */
+static size_t put_varint(uint8_t *buf, size_t pos, size_t len, uint32_t value)
+{
+	do {
+		if (pos >= len) {
+			return 0;
+		}
+		uint8_t byte = value & 0x7f;
+		value >>= 7;
+		buf[pos++] = byte | (value ? 0x80 : 0);
+	} while (value);
+	return pos;
+}
+
+/**
+ * Reads a LEB128 varint.
+ * @param buf Input buffer.
+ * @param pos Read position.
+ * @param len Length of the input.
+ * @param value Pointer to the decoded value.
+ * @return The position after the varint, 0 if truncated or too long.
+ */
+static size_t get_varint(const uint8_t *buf, size_t pos, size_t len, uint32_t *value)
+{
+	*value = 0;
+	for (uint32_t shift = 0; shift < 35; shift += 7) {
+		if (pos >= len) {
+			return 0;
+		}
+		uint8_t byte = buf[pos++];
+		*value |= (uint32_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return pos;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Serializes a snapshot. Format: 'H', version, sub-bucket bits, 0, then
+ * varint total, then a (varint index gap, varint count) pair for every
+ * non-empty bucket. A sparse histogram encodes in a few dozen bytes.
+ * @param snap Pointer to the snapshot.
+ * @param buf Output buffer; HISTOGRAM_DUMP_MAX bytes always suffice.
+ * @param len Size of the output buffer.
+ * @return The number of bytes written, 0 if the buffer is too small.
+ */
+size_t histogram_encode(const histogram_snapshot_t *snap, uint8_t *buf, size_t len)
+{
+	if (len < 4) {
+		return 0;
+	}
+	buf[0] = HISTOGRAM_MAGIC;
+	buf[1] = HISTOGRAM_VERSION;
+	buf[2] = HISTOGRAM_SUB_BITS;
+	buf[3] = 0;
+
+	size_t pos = put_varint(buf, 4, len, snap->total);
+	uint32_t next = 0;
+
+	for (uint32_t i = 0; i < HISTOGRAM_BUCKETS && pos > 0; i++) {
+		if (snap->counts[i] == 0) {
+			continue;
+		}
+		pos = put_varint(buf, pos, len, i - next);
+		if (pos > 0) {
+			pos = put_varint(buf, pos, len, snap->counts[i]);
+		}
+		next = i + 1;
+	}
+	return pos;
+}
+
+/**
+ * Parses a dump written by histogram_encode().
+ * @param buf The dump.
+ * @param len Length of the dump.
+ * @param snap Pointer to the snapshot to fill.
+ * @return True if the dump is well formed and matches this build's layout.
+ */
+bool histogram_decode(const uint8_t *buf, size_t len, histogram_snapshot_t *snap)
+{
+	if (len < 4 || buf[0] != HISTOGRAM_MAGIC || buf[1] != HISTOGRAM_VERSION ||
+	    buf[2] != HISTOGRAM_SUB_BITS) {
+		return false;
+	}
+	memset(snap, 0, sizeof(*snap));
+
+	uint32_t total;
+	size_t pos = get_varint(buf, 4, len, &total);
+	uint32_t next = 0;
+
+	while (pos > 0 && pos < len) {
+		uint32_t gap, count;
+
+		pos = get_varint(buf, pos, len, &gap);
+		if (pos == 0 || gap >= HISTOGRAM_BUCKETS - next) {
+			return false;
+		}
+		pos = get_varint(buf, pos, len, &count);
+		if (pos == 0) {
+			return false;
+		}
+		snap->counts[next + gap] = count;
+		snap->total += count;
+		next += gap + 1;
+	}
+	return pos == len && snap->total == total;
+}
@@ -0,0 +1,73 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include "radar_os.h"
+
+#ifndef CONFIG_RADAR_HISTOGRAM_SUB_BUCKET_BITS
+#define CONFIG_RADAR_HISTOGRAM_SUB_BUCKET_BITS 3
+#endif
+
+/*
+ * Log-linear histogram of uint32_t values (cycles, microseconds, bytes...).
+ * Values below 2^S are counted exactly; above that every power of two is
+ * split into 2^S linear sub-buckets, so any value is within 1/2^S of its
+ * bucket's bounds. S = 3 gives 240 buckets and 12.5% worst-case error.
+ */
+#define HISTOGRAM_SUB_BITS    CONFIG_RADAR_HISTOGRAM_SUB_BUCKET_BITS
+#define HISTOGRAM_SUB_BUCKETS (1u << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS     ((32 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+// Worst-case size of histogram_encode() output
+#define HISTOGRAM_DUMP_MAX (4 + 5 + HISTOGRAM_BUCKETS * (2 + 5))
+
+// Live histogram: one atomic counter per bucket, recorded lock-free
+typedef struct {
+	radar_atomic_t counts[HISTOGRAM_BUCKETS];
+} histogram_t;
+
+// Plain copy of a histogram for queries, merging and dumping
+typedef struct {
+	uint32_t counts[HISTOGRAM_BUCKETS];
+	uint32_t total;
+} histogram_snapshot_t;
+
+/**
+ * Maps a value to its bucket.
+ * @param value The value.
+ * @return The bucket index.
+ */
+static inline uint32_t histogram_bucket(uint32_t value)
+{
+	if (value < HISTOGRAM_SUB_BUCKETS) {
+		return value;
+	}
+	uint32_t msb = 31u - (uint32_t)__builtin_clz(value);
+	uint32_t shift = msb - HISTOGRAM_SUB_BITS;
+
+	// Group shift+1, sub-bucket from the bits right below the leading one
+	return ((shift + 1u) << HISTOGRAM_SUB_BITS) | ((value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1u));
+}
+
+/**
+ * Records one value. Safe from ISR and thread context.
+ * @param hist Pointer to the histogram.
+ * @param value The value to record.
+ */
+static inline void histogram_record(histogram_t *hist, uint32_t value)
+{
+	(void)radar_atomic_inc(&hist->counts[histogram_bucket(value)]);
+}
+
+void histogram_reset(histogram_t *hist);
+void histogram_snapshot(const histogram_t *hist, histogram_snapshot_t *snap);
+void histogram_merge(histogram_snapshot_t *dst, const histogram_snapshot_t *src);
+
+uint32_t histogram_bucket_low(uint32_t bucket);
+uint32_t histogram_bucket_high(uint32_t bucket);
+uint32_t histogram_percentile(const histogram_snapshot_t *snap, uint32_t per_10k);
+uint32_t histogram_max(const histogram_snapshot_t *snap);
+
+size_t histogram_encode(const histogram_snapshot_t *snap, uint8_t *buf, size_t len);
+bool histogram_decode(const uint8_t *buf, size_t len, histogram_snapshot_t *snap);
+
+#endif
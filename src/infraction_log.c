@@ -1,45 +1,364 @@
 #include "infraction_log.h"
+#include "schema.h"
 #include <string.h>
 
-#ifndef CONFIG_RADAR_INFRACTION_LOG_SIZE
-#define CONFIG_RADAR_INFRACTION_LOG_SIZE 32
+#ifndef CONFIG_RADAR_INFRACTION_EXPORT_CHUNK
+#define CONFIG_RADAR_INFRACTION_EXPORT_CHUNK 2
 #endif
+#ifndef CONFIG_RADAR_INFRACTION_CHAIN_BATCH
+#define CONFIG_RADAR_INFRACTION_CHAIN_BATCH 8
+#endif
+#ifndef CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINT_INTERVAL
+#define CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINT_INTERVAL 16
+#endif
+#ifndef CONFIG_RADAR_INFRACTION_CHAIN_STACK_SIZE
+#define CONFIG_RADAR_INFRACTION_CHAIN_STACK_SIZE 1024
+#endif
+#ifndef CONFIG_RADAR_INFRACTION_CHAIN_PRIORITY
+#define CONFIG_RADAR_INFRACTION_CHAIN_PRIORITY 10
+#endif
+
+// Claim attempts before a producer gives up a slot still held by a lap behind
+#define INFRACTION_LOG_CLAIM_SPINS 64
 
+// Slots are indexed by seq % size, which only stays continuous across the
+// uint32_t wrap of seq when the size divides 2^32
+BUILD_ASSERT((CONFIG_RADAR_INFRACTION_LOG_SIZE & (CONFIG_RADAR_INFRACTION_LOG_SIZE - 1)) == 0,
+	     "CONFIG_RADAR_INFRACTION_LOG_SIZE must be a power of two");
+
+#define LOST_BITS (8 * sizeof(radar_atomic_val_t))
+
+#define CHAIN_TAG_RECORD 'R'
+#define CHAIN_TAG_GAP    'G'
+// Tag, then the record in its wire schema
+#define CHAIN_RECORD_SIZE (1 + SCHEMA_INFRACTION_RECORD_SIZE)
+
+/*
+ * Multi-producer ring: a writer reserves a sequence number with one
+ * fetch-add and owns slot seq % size. Each slot has a generation that is
+ * odd while a writer copies into it, so readers never wait on writers:
+ * they copy a slot and keep the copy only if the generation did not move.
+ * commit_seq is the end of the committed prefix; every writer pushes it
+ * forward over the finished slots after its own commit, so a writer
+ * preempted mid-copy holds back visibility, never the other writers.
+ */
 static infraction_record_t records[CONFIG_RADAR_INFRACTION_LOG_SIZE];
-static size_t head_index;
-static size_t total_count;
-static uint32_t count_light;
-static uint32_t count_heavy;
-static uint32_t count_valid_read;
-static uint32_t count_invalid_read;
-static struct k_spinlock log_lock;
+static radar_atomic_t slot_gen[CONFIG_RADAR_INFRACTION_LOG_SIZE];
+// One bit per slot: the producer of the lap after the slot's record gave up
+static radar_atomic_t slot_lost[(CONFIG_RADAR_INFRACTION_LOG_SIZE + LOST_BITS - 1) / LOST_BITS];
+static radar_atomic_t reserve_seq; // Next sequence number to hand out
+static radar_atomic_t commit_seq;  // Records below this one are committed
+static radar_atomic_t count_light;
+static radar_atomic_t count_heavy;
+static radar_atomic_t count_valid_read;
+static radar_atomic_t count_invalid_read;
+static radar_atomic_t count_lost;
+
+#if IS_ENABLED(CONFIG_RADAR_INFRACTION_CHAIN)
+// Chain state, written by the worker under chain_lock
+static radar_lock_t chain_lock;
+static uint32_t chain_seq; // Next sequence number to fold into the chain
+static uint8_t chain_digest[SHA256_DIGEST_SIZE];
+static bool chain_started;
+static infraction_checkpoint_t checkpoints[CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINTS];
+static size_t checkpoint_head;
+static size_t checkpoint_count;
+static infraction_chain_stats_t chain_stats;
+
+// Dedicated queue below every pipeline thread, so hashing only uses idle
+// time. The system work queue runs at a cooperative priority and would hold
+// the pipeline threads off for a whole batch
+static void chain_work_handler(void);
+RADAR_WORKER_DEFINE(chain_worker, chain_work_handler, CONFIG_RADAR_INFRACTION_CHAIN_STACK_SIZE,
+		    CONFIG_RADAR_INFRACTION_CHAIN_PRIORITY);
+#endif
+
+static inline uint8_t *put_le32(uint8_t *p, uint32_t v)
+{
+	for (int i = 0; i < 4; i++) {
+		*p++ = (uint8_t)(v >> (8 * i));
+	}
+	return p;
+}
+
+/**
+ * Links one record into the hash chain: next = SHA-256(prev || encoded record).
+ * The record goes through its wire schema, so the digest depends neither
+ * on struct padding nor on whatever follows the plate's terminator.
+ * @param prev The previous chain digest (all zero for the first record).
+ * @param record The record to fold in.
+ * @param next Output digest.
+ */
+void infraction_chain_link(const uint8_t prev[SHA256_DIGEST_SIZE], const infraction_record_t *record,
+			   uint8_t next[SHA256_DIGEST_SIZE])
+{
+	uint8_t buf[CHAIN_RECORD_SIZE];
+
+	buf[0] = CHAIN_TAG_RECORD;
+	(void)schema_encode_infraction_record(record, buf + 1, sizeof(buf) - 1);
+
+	sha256_ctx_t ctx;
+	sha256_init(&ctx);
+	sha256_update(&ctx, prev, SHA256_DIGEST_SIZE);
+	sha256_update(&ctx, buf, sizeof(buf));
+	sha256_final(&ctx, next);
+}
+
+/**
+ * Copies a slot out of the ring without blocking its writers.
+ * @param idx The slot.
+ * @param out Pointer to the copy.
+ * @return True if the copy is a whole committed record, false if the slot
+ *         was never written or a writer held it during the copy.
+ */
+static bool slot_copy(size_t idx, infraction_record_t *out)
+{
+	radar_atomic_val_t gen = radar_atomic_get(&slot_gen[idx]);
+
+	if (gen == 0 || (gen & 1) != 0) {
+		return false;
+	}
+	*out = records[idx];
+	radar_atomic_fence();
+	return radar_atomic_get(&slot_gen[idx]) == gen;
+}
+
+/**
+ * Copies a committed record out of the ring.
+ * @param seq Its sequence number.
+ * @param out Pointer to the copy.
+ * @return True on success, false if it has been overwritten meanwhile.
+ */
+static bool log_read(uint32_t seq, infraction_record_t *out)
+{
+	return slot_copy(seq % CONFIG_RADAR_INFRACTION_LOG_SIZE, out) && out->seq == seq;
+}
+
+/**
+ * Gets the end of the committed prefix.
+ * @return The sequence number of the next record readers will see.
+ */
+static inline uint32_t log_end(void)
+{
+	return (uint32_t)radar_atomic_get(&commit_seq);
+}
+
+/**
+ * Gets the number of committed records still in the ring.
+ * @param end The end of the committed prefix.
+ * @return The number of records.
+ */
+static inline uint32_t log_count(uint32_t end)
+{
+	return MIN(end, (uint32_t)CONFIG_RADAR_INFRACTION_LOG_SIZE);
+}
+
+/**
+ * Tells whether the producer of the lap after a slot's record gave it up.
+ * @param idx The slot.
+ * @return True if the slot is marked.
+ */
+static inline bool lost_marked(size_t idx)
+{
+	return (radar_atomic_get(&slot_lost[idx / LOST_BITS]) &
+		(radar_atomic_val_t)(1UL << (idx % LOST_BITS))) != 0;
+}
+
+/**
+ * Sets or clears the lost mark of a slot.
+ * @param idx The slot.
+ * @param marked The new state of the mark.
+ */
+static void lost_mark(size_t idx, bool marked)
+{
+	radar_atomic_t *word = &slot_lost[idx / LOST_BITS];
+	radar_atomic_val_t bit = (radar_atomic_val_t)(1UL << (idx % LOST_BITS));
+	radar_atomic_val_t old;
+	radar_atomic_val_t new_value;
+
+	do {
+		old = radar_atomic_get(word);
+		new_value = marked ? (old | bit) : (old & ~bit);
+		if (new_value == old) {
+			return;
+		}
+	} while (!radar_atomic_cas(word, old, new_value));
+}
+
+/**
+ * Moves commit_seq over every finished slot. A slot is finished once it
+ * holds its record or a later lap's one, or holds the previous lap's
+ * record and is marked lost.
+ */
+static void log_publish(void)
+{
+	while (1) {
+		radar_atomic_val_t end = radar_atomic_get(&commit_seq);
+		size_t idx = (uint32_t)end % CONFIG_RADAR_INFRACTION_LOG_SIZE;
+		infraction_record_t rec;
+
+		if (!slot_copy(idx, &rec)) {
+			return;
+		}
+		if ((int32_t)(rec.seq - (uint32_t)end) < 0 &&
+		    (rec.seq != (uint32_t)end - CONFIG_RADAR_INFRACTION_LOG_SIZE || !lost_marked(idx))) {
+			return;
+		}
+		// Losing the race means another writer moved it: look again
+		(void)radar_atomic_cas(&commit_seq, end, end + 1);
+	}
+}
+
+#if IS_ENABLED(CONFIG_RADAR_INFRACTION_CHAIN)
+/**
+ * Folds a gap marker into the chain for records that were overwritten
+ * before the worker could hash them, so the loss stays visible.
+ * @param prev The previous chain digest.
+ * @param first_seq The first lost sequence number.
+ * @param missing The number of lost records.
+ * @param next Output digest.
+ */
+static void chain_link_gap(const uint8_t prev[SHA256_DIGEST_SIZE], uint32_t first_seq,
+			   uint32_t missing, uint8_t next[SHA256_DIGEST_SIZE])
+{
+	uint8_t buf[1 + 4 + 4];
+	uint8_t *p = buf;
+
+	*p++ = CHAIN_TAG_GAP;
+	p = put_le32(p, first_seq);
+	(void)put_le32(p, missing);
+
+	sha256_ctx_t ctx;
+	sha256_init(&ctx);
+	sha256_update(&ctx, prev, SHA256_DIGEST_SIZE);
+	sha256_update(&ctx, buf, sizeof(buf));
+	sha256_final(&ctx, next);
+}
 
 /**
- * Adds an infraction record to the log.
+ * Work handler that hashes pending records in batches. The worker is the
+ * only writer of chain_seq, so it reads records without any lock and
+ * takes chain_lock only to publish the new digest.
+ */
+static void chain_work_handler(void)
+{
+	for (int n = 0; n < CONFIG_RADAR_INFRACTION_CHAIN_BATCH; n++) {
+		infraction_record_t rec;
+		uint8_t prev[SHA256_DIGEST_SIZE];
+		uint8_t next[SHA256_DIGEST_SIZE];
+		uint32_t end = log_end();
+
+		if (chain_seq == end) {
+			return;
+		}
+		// The writers lapped us: skip to the oldest record still in the ring
+		uint32_t seq = end - chain_seq > CONFIG_RADAR_INFRACTION_LOG_SIZE ?
+				       end - CONFIG_RADAR_INFRACTION_LOG_SIZE : chain_seq;
+		while (seq != end && !log_read(seq, &rec)) {
+			seq++;
+		}
+		if (seq == end) {
+			// Everything left is being overwritten right now
+			break;
+		}
+		uint32_t missing = seq - chain_seq;
+
+		memcpy(prev, chain_digest, sizeof(prev));
+		uint32_t t0 = radar_cycles();
+		if (missing > 0) {
+			chain_link_gap(prev, chain_seq, missing, prev);
+		}
+		infraction_chain_link(prev, &rec, next);
+		uint32_t elapsed = radar_cycles() - t0;
+
+		radar_lock_key_t key = radar_lock(&chain_lock);
+		memcpy(chain_digest, next, sizeof(chain_digest));
+		chain_seq = seq + 1;
+		chain_started = true;
+		chain_stats.hashed++;
+		chain_stats.gaps += missing;
+		chain_stats.hash_cycles += elapsed;
+		chain_stats.hashed_bytes += SHA256_DIGEST_SIZE + CHAIN_RECORD_SIZE;
+		if (((rec.seq + 1) % CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINT_INTERVAL) == 0) {
+			checkpoints[checkpoint_head].seq = rec.seq;
+			memcpy(checkpoints[checkpoint_head].digest, next, SHA256_DIGEST_SIZE);
+			checkpoint_head = (checkpoint_head + 1) % CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINTS;
+			if (checkpoint_count < CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINTS) {
+				checkpoint_count++;
+			}
+		}
+		radar_unlock(&chain_lock, key);
+	}
+
+	// Batch exhausted with work left: let queued items run, then continue
+	radar_worker_submit(&chain_worker);
+}
+#endif
+
+/**
+ * Adds an infraction record to the log. Safe to call from any number of
+ * threads and ISRs at once and never waits: producers only contend on the
+ * slot when they lap the whole ring, and one that cannot claim its slot
+ * gives the record up and counts it as lost. The type and read counters
+ * count every record handed in, lost or not.
  * @param record The infraction record to add.
  */
 void infraction_log_add(const infraction_record_t *record)
 {
-	k_spinlock_key_t key = k_spin_lock(&log_lock);
+	uint32_t seq = (uint32_t)radar_atomic_inc(&reserve_seq);
+	size_t idx = seq % CONFIG_RADAR_INFRACTION_LOG_SIZE;
+	radar_atomic_val_t gen;
+	bool claimed = false;
+	bool lost = false;
 
-	records[head_index] = *record;
-	head_index = (head_index + 1) % CONFIG_RADAR_INFRACTION_LOG_SIZE;
-	if (total_count < CONFIG_RADAR_INFRACTION_LOG_SIZE) {
-		total_count++;
+	// Claim the slot: odd generation while we copy
+	for (uint32_t spins = 0; !claimed && !lost; spins++) {
+		gen = radar_atomic_get(&slot_gen[idx]);
+		if ((gen & 1) == 0 && radar_atomic_cas(&slot_gen[idx], gen, gen + 1)) {
+			// Any mark is for the previous lap, which commit_seq has passed
+			lost_mark(idx, false);
+			claimed = true;
+		} else if ((uint32_t)radar_atomic_get(&reserve_seq) - seq >
+			   CONFIG_RADAR_INFRACTION_LOG_SIZE) {
+			// A producer a full lap ahead owns the slot: the record is lost
+			// either way, readers and the chain see it as overwritten
+			lost = true;
+		} else if (spins >= INFRACTION_LOG_CLAIM_SPINS) {
+			// The holder is a lap behind, likely preempted mid-copy by us, and
+			// cannot finish while we spin: give the record up and mark the
+			// slot so commit_seq passes it once the holder is done
+			lost_mark(idx, true);
+			lost = true;
+			log_publish();
+		}
+	}
+
+	if (claimed) {
+		// A producer a full lap ahead got here first: this record is already overwritten
+		if (gen == 0 || (int32_t)(records[idx].seq - seq) < 0) {
+			records[idx] = *record;
+			records[idx].seq = seq;
+		} else {
+			lost = true;
+		}
+		radar_atomic_set(&slot_gen[idx], gen + 2);
+		log_publish();
+	}
+	if (lost) {
+		radar_atomic_inc(&count_lost);
 	}
 
 	if (record->type == VEHICLE_HEAVY) {
-		count_heavy++;
+		radar_atomic_inc(&count_heavy);
 	} else if (record->type == VEHICLE_LIGHT) {
-		count_light++;
-	}
-	if (record->valid_read) {
-		count_valid_read++;
-	} else {
-		count_invalid_read++;
+		radar_atomic_inc(&count_light);
 	}
+	radar_atomic_inc(record->valid_read ? &count_valid_read : &count_invalid_read);
 
-	k_spin_unlock(&log_lock, key);
+#if IS_ENABLED(CONFIG_RADAR_INFRACTION_CHAIN)
+	// Hashing is deferred; submitting an already queued item is a no-op
+	radar_worker_submit(&chain_worker);
+#endif
 }
 
 /**
@@ -54,23 +373,78 @@ size_t infraction_log_get_recent(size_t max_records, infraction_record_t *out_re
 		return 0;
 	}
 
-	k_spinlock_key_t key = k_spin_lock(&log_lock);
+	uint32_t end = log_end();
+	uint32_t available = log_count(end);
+	size_t copied = 0;
 
-	size_t available = total_count;
-	if (available > CONFIG_RADAR_INFRACTION_LOG_SIZE) {
-		available = CONFIG_RADAR_INFRACTION_LOG_SIZE;
+	/* Copy from newest to oldest, skipping slots a writer is overwriting */
+	for (uint32_t i = 0; i < available && copied < max_records; i++) {
+		if (log_read(end - 1 - i, &out_records[copied])) {
+			copied++;
+		}
 	}
-	size_t to_copy = (max_records < available) ? max_records : available;
+	return copied;
+}
 
-	/* Copy from newest to oldest into out_records[0..to_copy-1] */
-	for (size_t i = 0; i < to_copy; i++) {
-		/* Newest element is at (head_index - 1 + size) % size */
-		size_t idx = (head_index + CONFIG_RADAR_INFRACTION_LOG_SIZE - 1 - i) % CONFIG_RADAR_INFRACTION_LOG_SIZE;
-		out_records[i] = records[idx];
+/**
+ * Positions a cursor on the oldest record currently in the log.
+ * @param cursor Pointer to the cursor.
+ */
+void infraction_cursor_init(infraction_cursor_t *cursor)
+{
+	uint32_t end = log_end();
+
+	cursor->next_seq = end - log_count(end);
+	cursor->lost = 0;
+}
+
+/**
+ * Streams records from the cursor position to the current end of the log.
+ * Records are copied out a chunk at a time and handed to the callback, so
+ * the caller's stack only holds one chunk. Writers never wait for the
+ * copy. Records appended after the call starts are left for the next call.
+ * @param cursor Pointer to the cursor, advanced past every delivered record.
+ * @param cb The callback that receives each chunk.
+ * @param user_data Pointer passed through to the callback.
+ * @return The number of records delivered.
+ */
+size_t infraction_log_visit(infraction_cursor_t *cursor, infraction_visit_cb_t cb, void *user_data)
+{
+	infraction_record_t chunk[CONFIG_RADAR_INFRACTION_EXPORT_CHUNK];
+	size_t visited = 0;
+	bool more = true;
+	uint32_t end_seq = log_end();
+
+	while (more && (int32_t)(end_seq - cursor->next_seq) > 0) {
+		size_t n = 0;
+
+		// Records the writers overwrote since the last chunk are skipped and counted
+		uint32_t end = log_end();
+		if (end - cursor->next_seq > CONFIG_RADAR_INFRACTION_LOG_SIZE) {
+			uint32_t skipped = end - CONFIG_RADAR_INFRACTION_LOG_SIZE - cursor->next_seq;
+
+			cursor->lost += skipped;
+			cursor->next_seq += skipped;
+		}
+		// Stop at the snapshot end even if the skip above jumped past it
+		while (n < ARRAY_SIZE(chunk) && (int32_t)(end_seq - cursor->next_seq) > 0) {
+			if (log_read(cursor->next_seq, &chunk[n])) {
+				n++;
+			} else {
+				cursor->lost++;
+			}
+			cursor->next_seq++;
+		}
+
+		if (n == 0) {
+			// Everything up to the snapshot end was overwritten
+			break;
+		}
+		visited += n;
+		more = cb(chunk, n, user_data);
 	}
 
-	k_spin_unlock(&log_lock, key);
-	return to_copy;
+	return visited;
 }
 
 /**
@@ -82,20 +456,92 @@ size_t infraction_log_get_recent(size_t max_records, infraction_record_t *out_re
  */
 void infraction_log_get_counters(uint32_t *light_count, uint32_t *heavy_count, uint32_t *valid_reads, uint32_t *invalid_reads)
 {
-	k_spinlock_key_t key = k_spin_lock(&log_lock);
 	if (light_count) {
-		*light_count = count_light;
+		*light_count = (uint32_t)radar_atomic_get(&count_light);
 	}
 	if (heavy_count) {
-		*heavy_count = count_heavy;
+		*heavy_count = (uint32_t)radar_atomic_get(&count_heavy);
 	}
 	if (valid_reads) {
-		*valid_reads = count_valid_read;
+		*valid_reads = (uint32_t)radar_atomic_get(&count_valid_read);
 	}
 	if (invalid_reads) {
-		*invalid_reads = count_invalid_read;
+		*invalid_reads = (uint32_t)radar_atomic_get(&count_invalid_read);
+	}
+}
+
+/**
+ * Gets the number of records given up or overwritten before they were
+ * committed, because producers lapped the ring.
+ * @return The number of records.
+ */
+uint32_t infraction_log_get_lost(void)
+{
+	return (uint32_t)radar_atomic_get(&count_lost);
+}
+
+/**
+ * Gets the current head of the hash chain.
+ * @param out The sequence number of the last hashed record and its digest.
+ * @return True if at least one record has been hashed, false otherwise.
+ */
+bool infraction_log_get_chain_head(infraction_checkpoint_t *out)
+{
+#if IS_ENABLED(CONFIG_RADAR_INFRACTION_CHAIN)
+	radar_lock_key_t key = radar_lock(&chain_lock);
+	bool started = chain_started;
+	if (started) {
+		out->seq = chain_seq - 1;
+		memcpy(out->digest, chain_digest, SHA256_DIGEST_SIZE);
 	}
-	k_spin_unlock(&log_lock, key);
+	radar_unlock(&chain_lock, key);
+	return started;
+#else
+	ARG_UNUSED(out);
+	return false;
+#endif
 }
 
+/**
+ * Gets the most recent periodic checkpoints, newest first.
+ * @param max_checkpoints The maximum number of checkpoints to get.
+ * @param out The array to store the checkpoints.
+ * @return The number of checkpoints copied.
+ */
+size_t infraction_log_get_checkpoints(size_t max_checkpoints, infraction_checkpoint_t *out)
+{
+#if IS_ENABLED(CONFIG_RADAR_INFRACTION_CHAIN)
+	if (max_checkpoints == 0 || out == NULL) {
+		return 0;
+	}
+
+	radar_lock_key_t key = radar_lock(&chain_lock);
+	size_t to_copy = (max_checkpoints < checkpoint_count) ? max_checkpoints : checkpoint_count;
+	for (size_t i = 0; i < to_copy; i++) {
+		size_t idx = (checkpoint_head + CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINTS - 1 - i) %
+			     CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINTS;
+		out[i] = checkpoints[idx];
+	}
+	radar_unlock(&chain_lock, key);
+	return to_copy;
+#else
+	ARG_UNUSED(max_checkpoints);
+	ARG_UNUSED(out);
+	return 0;
+#endif
+}
 
+/**
+ * Gets the hashing statistics of the chain worker.
+ * @param out Pointer to the statistics.
+ */
+void infraction_log_get_chain_stats(infraction_chain_stats_t *out)
+{
+#if IS_ENABLED(CONFIG_RADAR_INFRACTION_CHAIN)
+	radar_lock_key_t key = radar_lock(&chain_lock);
+	*out = chain_stats;
+	radar_unlock(&chain_lock, key);
+#else
+	memset(out, 0, sizeof(*out));
+#endif
+}
@@ -1,23 +1,80 @@
 #ifndef INFRACTION_LOG_H
 #define INFRACTION_LOG_H
 
-#include <zephyr/kernel.h>
+#include "radar_os.h"
 #include "common.h"
+#include "sha256.h"
+
+#ifndef CONFIG_RADAR_INFRACTION_LOG_SIZE
+#define CONFIG_RADAR_INFRACTION_LOG_SIZE 32
+#endif
+#ifndef CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINTS
+#define CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINTS 8
+#endif
+
+// Fields as in common.h; schema.h derives the wire encoding from the same list
+#define SCHEMA_INFRACTION_RECORD(X)                                                                \
+	X(I64, timestamp_ms)                                                                       \
+	X(ENUM, type, vehicle_type_t, VEHICLE_UNKNOWN + 1)                                         \
+	X(U32, speed_kmh)                                                                          \
+	X(U32, limit_kmh)                                                                          \
+	X(U32, gross_weight_kg) /* 0 when not weighed */                                           \
+	X(BOOL, valid_read)                                                                        \
+	X(STR, plate, 10)                                                                          \
+	X(U32, seq) /* Assigned by the log on insertion */
+typedef SCHEMA_STRUCT(SCHEMA_INFRACTION_RECORD) infraction_record_t;
+
+// Chain digest after hashing every record up to and including seq
+typedef struct {
+	uint32_t seq;
+	uint8_t digest[SHA256_DIGEST_SIZE];
+} infraction_checkpoint_t;
 
 typedef struct {
-	int64_t timestamp_ms;
-	vehicle_type_t type;
-	uint32_t speed_kmh;
-	uint32_t limit_kmh;
-	bool valid_read;
-	char plate[10];
-} infraction_record_t;
+	uint32_t hashed;       // Records folded into the chain
+	uint32_t gaps;         // Records overwritten before the worker reached them
+	uint64_t hash_cycles;  // Cycles spent hashing in the worker
+	uint64_t hashed_bytes; // Bytes fed to SHA-256
+} infraction_chain_stats_t;
 
+/**
+ * Visitor for streaming exports. Records are oldest first and only valid
+ * for the duration of the call.
+ * @param records The chunk of records.
+ * @param count The number of records in the chunk.
+ * @param user_data The pointer given to infraction_log_visit().
+ * @return True to continue, false to stop after this chunk.
+ */
+typedef bool (*infraction_visit_cb_t)(const infraction_record_t *records, size_t count, void *user_data);
+
+// Resumable position in the log; persist next_seq to resume later
+typedef struct {
+	uint32_t next_seq; // Sequence number of the next record to visit
+	uint32_t lost;     // Records overwritten before this cursor reached them
+} infraction_cursor_t;
+
+// Lock-free, any number of concurrent producers; readers only see committed records
 void infraction_log_add(const infraction_record_t *record);
 size_t infraction_log_get_recent(size_t max_records, infraction_record_t *out_records);
 
+void infraction_cursor_init(infraction_cursor_t *cursor);
+size_t infraction_log_visit(infraction_cursor_t *cursor, infraction_visit_cb_t cb, void *user_data);
+
 void infraction_log_get_counters(uint32_t *light_count, uint32_t *heavy_count, uint32_t *valid_reads, uint32_t *invalid_reads);
+uint32_t infraction_log_get_lost(void);
 
-#endif
+/**
+ * Links one record into the hash chain: next = SHA-256(prev || encoded record).
+ * Exposed so exported logs can be verified against the checkpoints.
+ * @param prev The previous chain digest (all zero for the first record).
+ * @param record The record to fold in.
+ * @param next Output digest.
+ */
+void infraction_chain_link(const uint8_t prev[SHA256_DIGEST_SIZE], const infraction_record_t *record,
+			   uint8_t next[SHA256_DIGEST_SIZE]);
 
+bool infraction_log_get_chain_head(infraction_checkpoint_t *out);
+size_t infraction_log_get_checkpoints(size_t max_checkpoints, infraction_checkpoint_t *out);
+void infraction_log_get_chain_stats(infraction_chain_stats_t *out);
 
+#endif
@@ -0,0 +1,722 @@
+#include <string.h>
+#include "lpr.h"
+
+/*
+ * The row kernels use GCC vector extensions: 16 pixels per operation on
+ * hosts with SSE or NEON, lowered to word and byte operations on cores
+ * without SIMD such as the Cortex-M3, which also lacks the DSP extension
+ * the CMSIS SIMD intrinsics need.
+ */
+typedef uint8_t lpr_u8x8 __attribute__((vector_size(8)));
+typedef uint8_t lpr_u8x16 __attribute__((vector_size(16)));
+typedef uint16_t lpr_u16x8 __attribute__((vector_size(16)));
+
+// Lane shuffles only pay off with real SIMD registers
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define LPR_VECTOR_SCAN 1
+#endif
+
+// Longest run of weak rows or columns bridged inside a plate: an inter-glyph gap
+#define LPR_ROW_GAP 1
+#define LPR_COL_GAP LPR_CHAR_ADVANCE
+// Search margin around the best window, where the crop may grow
+#define LPR_MARGIN_X (LPR_PLATE_WIDTH / 4)
+#define LPR_MARGIN_Y (LPR_PLATE_HEIGHT / 2)
+#define LPR_SEARCH_Y_STEP 2
+
+static inline lpr_u8x16 load_u8x16(const uint8_t *p)
+{
+	lpr_u8x16 v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline lpr_u16x8 load_u16x8(const uint16_t *p)
+{
+	lpr_u16x8 v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+/**
+ * Marks the vertical edges of one row: pixels whose left and right
+ * neighbours differ by more than the threshold. Plate characters are
+ * dense in vertical strokes; grilles and bumpers are mostly horizontal.
+ * @param row The frame row.
+ * @param edges Output, 1 for an edge pixel and 0 otherwise.
+ */
+static void lpr_edge_row(const uint8_t *row, uint8_t *edges)
+{
+	const uint8_t threshold = CONFIG_RADAR_LPR_EDGE_THRESHOLD;
+	uint32_t x = 1;
+
+	edges[0] = 0;
+	edges[LPR_WIDTH - 1] = 0;
+	for (; x + 16 <= LPR_WIDTH - 1; x += 16) {
+		lpr_u8x16 left = load_u8x16(&row[x - 1]);
+		lpr_u8x16 right = load_u8x16(&row[x + 1]);
+		lpr_u8x16 rising = (lpr_u8x16)(right > left);
+		lpr_u8x16 diff = ((right - left) & rising) | ((left - right) & ~rising);
+		lpr_u8x16 edge = (lpr_u8x16)(diff > threshold) & 1;
+
+		memcpy(&edges[x], &edge, sizeof(edge));
+	}
+	for (; x < LPR_WIDTH - 1; x++) {
+		int diff = row[x + 1] - row[x - 1];
+
+		edges[x] = (diff > threshold || -diff > threshold) ? 1 : 0;
+	}
+}
+
+/**
+ * Builds one integral image row: the running sum of the row's edges
+ * added to the row above.
+ * @param edges The row's edge map.
+ * @param above The integral row above.
+ * @param row The integral row to fill.
+ */
+static inline void lpr_scan_row(const uint8_t *edges, const uint16_t *above, uint16_t *row)
+{
+	uint16_t run = 0;
+
+	row[0] = 0;
+#if defined(LPR_VECTOR_SCAN)
+	// Prefix sum of eight lanes in three shift-and-add steps, then the carry of the previous eight
+	const lpr_u16x8 zero = {0};
+
+	for (uint32_t x = 0; x < LPR_WIDTH; x += 8) {
+		lpr_u8x8 bytes;
+
+		memcpy(&bytes, &edges[x], sizeof(bytes));
+		lpr_u16x8 v = __builtin_convertvector(bytes, lpr_u16x8);
+		v += __builtin_shuffle(v, zero, (lpr_u16x8){8, 0, 1, 2, 3, 4, 5, 6});
+		v += __builtin_shuffle(v, zero, (lpr_u16x8){8, 8, 0, 1, 2, 3, 4, 5});
+		v += __builtin_shuffle(v, zero, (lpr_u16x8){8, 8, 8, 8, 0, 1, 2, 3});
+		v += run;
+		run = v[7];
+		v += load_u16x8(&above[x + 1]);
+		memcpy(&row[x + 1], &v, sizeof(v));
+	}
+#else
+	for (uint32_t x = 0; x < LPR_WIDTH; x++) {
+		run += edges[x];
+		row[x + 1] = above[x + 1] + run;
+	}
+#endif
+}
+
+/**
+ * Builds the integral image of the frame's vertical edge map.
+ * @param frame Pointer to the frame.
+ * @param ii Pointer to the integral image to fill.
+ */
+RADAR_HOT void lpr_integral(const lpr_frame_t *frame, lpr_integral_t *ii)
+{
+	uint8_t edges[LPR_WIDTH];
+
+	memset(ii->sum[0], 0, sizeof(ii->sum[0]));
+	for (uint32_t y = 0; y < LPR_HEIGHT; y++) {
+		uint16_t *row = ii->sum[y + 1];
+
+		lpr_edge_row(frame->pixels[y], edges);
+		lpr_scan_row(edges, ii->sum[y], row);
+		memset(&row[LPR_WIDTH + 1], 0, (LPR_INTEGRAL_STRIDE - LPR_WIDTH - 1) * sizeof(row[0]));
+	}
+}
+
+/**
+ * Counts the edge pixels in a box.
+ * @param ii Pointer to the integral image.
+ * @param x0 First column.
+ * @param y0 First row.
+ * @param x1 Column after the last.
+ * @param y1 Row after the last.
+ * @return The edge count.
+ */
+static inline uint32_t lpr_box(const lpr_integral_t *ii, uint32_t x0, uint32_t y0, uint32_t x1,
+			       uint32_t y1)
+{
+	return (uint16_t)(ii->sum[y1][x1] - ii->sum[y0][x1] - ii->sum[y1][x0] + ii->sum[y0][x0]);
+}
+
+/**
+ * Grows a span around a centre over a profile while the entries stay
+ * strong, bridging weak runs up to a gap.
+ * @param profile Edge counts per row or column.
+ * @param count Entries in the profile.
+ * @param centre Index the span starts from.
+ * @param min Least count of a strong entry.
+ * @param gap Longest weak run bridged.
+ * @param lo Output, first strong index of the span.
+ * @param hi Output, index after the last strong one.
+ */
+static void lpr_span(const uint16_t *profile, uint32_t count, uint32_t centre, uint32_t min,
+		     uint32_t gap, uint32_t *lo, uint32_t *hi)
+{
+	uint32_t first = centre;
+	uint32_t last = centre;
+
+	for (uint32_t i = centre; i-- > 0 && first - i <= gap + 1;) {
+		if (profile[i] >= min) {
+			first = i;
+		}
+	}
+	for (uint32_t i = centre + 1; i < count && i - last <= gap + 1; i++) {
+		if (profile[i] >= min) {
+			last = i;
+		}
+	}
+	*lo = first;
+	*hi = last + 1;
+}
+
+/**
+ * Finds the plate in an edge integral image. A plate-sized window slides
+ * over the image, eight positions per vector operation, and the one with
+ * the most edges wins. The crop is then fitted to the strong rows and
+ * columns around it, so it hugs the characters.
+ * @param ii Pointer to the integral image.
+ * @param crop Output, the plate region.
+ * @return True if a window was edge-dense enough to be a plate.
+ */
+RADAR_HOT bool lpr_search(const lpr_integral_t *ii, lpr_rect_t *crop)
+{
+	const uint32_t last_x = LPR_WIDTH - LPR_PLATE_WIDTH;
+	uint16_t best = 0;
+	uint32_t best_x = 0;
+	uint32_t best_y = 0;
+
+	for (uint32_t y = 0; y + LPR_PLATE_HEIGHT <= LPR_HEIGHT; y += LPR_SEARCH_Y_STEP) {
+		const uint16_t *top = ii->sum[y];
+		const uint16_t *bottom = ii->sum[y + LPR_PLATE_HEIGHT];
+
+		for (uint32_t x = 0; x <= last_x; x += 8) {
+			lpr_u16x8 sums = load_u16x8(&bottom[x + LPR_PLATE_WIDTH]) -
+					 load_u16x8(&top[x + LPR_PLATE_WIDTH]) -
+					 load_u16x8(&bottom[x]) + load_u16x8(&top[x]);
+			lpr_u16x8 better = (lpr_u16x8)(sums > best);
+			uint64_t any[2];
+
+			memcpy(any, &better, sizeof(any));
+			if ((any[0] | any[1]) == 0) {
+				continue;
+			}
+			for (uint32_t lane = 0; lane < 8 && x + lane <= last_x; lane++) {
+				if (sums[lane] > best) {
+					best = sums[lane];
+					best_x = x + lane;
+					best_y = y;
+				}
+			}
+		}
+	}
+	if (best * 100u < LPR_MIN_EDGE_PERCENT * LPR_PLATE_WIDTH * LPR_PLATE_HEIGHT) {
+		return false;
+	}
+
+	uint16_t profile[LPR_PLATE_WIDTH + 2 * LPR_MARGIN_X];
+	uint32_t x0 = best_x > LPR_MARGIN_X ? best_x - LPR_MARGIN_X : 0;
+	uint32_t x1 = MIN(best_x + LPR_PLATE_WIDTH + LPR_MARGIN_X, LPR_WIDTH);
+	uint32_t y0 = best_y > LPR_MARGIN_Y ? best_y - LPR_MARGIN_Y : 0;
+	uint32_t y1 = MIN(best_y + LPR_PLATE_HEIGHT + LPR_MARGIN_Y, LPR_HEIGHT);
+	uint32_t lo;
+	uint32_t hi;
+
+	// Rows with a quarter of the window's mean edge count, over the window's columns
+	for (uint32_t y = y0; y < y1; y++) {
+		profile[y - y0] = lpr_box(ii, best_x, y, best_x + LPR_PLATE_WIDTH, y + 1);
+	}
+	lpr_span(profile, y1 - y0, best_y + LPR_PLATE_HEIGHT / 2 - y0,
+		 MAX(best / LPR_PLATE_HEIGHT / 4, 1u), LPR_ROW_GAP, &lo, &hi);
+	y1 = y0 + hi;
+	y0 += lo;
+
+	// Columns with an edge in an eighth of those rows
+	for (uint32_t x = x0; x < x1; x++) {
+		profile[x - x0] = lpr_box(ii, x, y0, x + 1, y1);
+	}
+	lpr_span(profile, x1 - x0, best_x + LPR_PLATE_WIDTH / 2 - x0, MAX((y1 - y0) / 8, 1u),
+		 LPR_COL_GAP, &lo, &hi);
+	x1 = x0 + hi;
+	x0 += lo;
+
+	*crop = (lpr_rect_t){.x = x0, .y = y0, .width = x1 - x0, .height = y1 - y0};
+	return true;
+}
+
+/**
+ * Locates the plate in a camera frame.
+ * @param frame Pointer to the frame.
+ * @param ii Pointer to the integral image workspace.
+ * @param crop Output, the plate region.
+ * @return True if a plate was found.
+ */
+bool lpr_locate(const lpr_frame_t *frame, lpr_integral_t *ii, lpr_rect_t *crop)
+{
+	lpr_integral(frame, ii);
+	return lpr_search(ii, crop);
+}
+
+/*
+ * Character recognition on the located crop. The ink and paper levels
+ * come from the crop itself, the text is split into characters by its
+ * ink column runs, and each character's normalized neighbourhood is
+ * matched against the font by sum of absolute differences. The Mercosul pattern fixes letters or digits per position,
+ * so each character is only matched against 26 or 10 templates.
+ */
+
+// Ink columns narrower than this are the plate border or dirt, not a character
+#define LPR_MIN_RUN      (2 * LPR_GLYPH_SCALE)
+#define LPR_CELL_WIDTH   (LPR_GLYPH_COLS * LPR_GLYPH_SCALE)
+#define LPR_CELL_HEIGHT  (LPR_GLYPH_ROWS * LPR_GLYPH_SCALE)
+// Templates are also tried this many pixels off the aligned position
+#define LPR_OCR_JITTER   1
+#define LPR_MIN_CONTRAST 32
+// Neighbourhood of a character that every template alignment and offset fits in
+#define LPR_PATCH_FIRST  ((LPR_GLYPH_COLS - 1) * LPR_GLYPH_SCALE + LPR_OCR_JITTER)
+#define LPR_PATCH_WIDTH  (LPR_PATCH_FIRST + LPR_CELL_WIDTH + LPR_OCR_JITTER)
+#define LPR_PATCH_HEIGHT (LPR_CELL_HEIGHT + 2 * LPR_OCR_JITTER)
+
+// Letters (L) and digits (N) by position, as validate_plate() checks them
+static const char lpr_pattern[LPR_PLATE_CHARS + 1] = "LLLNLNN";
+// Template offsets tried in each direction, aligned first
+static const int8_t lpr_jitter[] = {0, -LPR_OCR_JITTER, LPR_OCR_JITTER};
+/*
+ * Candidates stop once their score reaches this multiple of the best one.
+ * The runner-up is then only known to be at least that far behind, so
+ * confidences saturate at 100 - 100 / LPR_OCR_BOUND percent.
+ */
+#define LPR_OCR_BOUND 4
+
+// Rows top to bottom, bit 4 the leftmost column; digits then letters
+static const uint8_t lpr_font[36][LPR_GLYPH_ROWS] = {
+	{0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E},
+	{0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E},
+	{0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},
+	{0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},
+	{0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},
+	{0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11}, {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E},
+	{0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C},
+	{0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10},
+	{0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11},
+	{0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C},
+	{0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F},
+	{0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11},
+	{0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10},
+	{0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11},
+	{0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04},
+	{0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04},
+	{0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11},
+	{0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}, {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F},
+};
+
+/**
+ * Gets the glyph of a plate character.
+ * @param c The character, a digit or an uppercase letter.
+ * @return Its rows, or NULL if the font lacks it.
+ */
+static const uint8_t *lpr_glyph(char c)
+{
+	if (c >= '0' && c <= '9') {
+		return lpr_font[c - '0'];
+	}
+	if (c >= 'A' && c <= 'Z') {
+		return lpr_font[10 + c - 'A'];
+	}
+	return NULL;
+}
+
+/**
+ * Gets the leftmost ink column of a glyph.
+ * @param glyph The glyph rows.
+ * @return The column, 0 to LPR_GLYPH_COLS - 1.
+ */
+static uint32_t lpr_glyph_left(const uint8_t *glyph)
+{
+	uint8_t cols = 0;
+	uint32_t c = 0;
+
+	for (uint32_t r = 0; r < LPR_GLYPH_ROWS; r++) {
+		cols |= glyph[r];
+	}
+	while (c < LPR_GLYPH_COLS - 1 && !(cols & (0x10 >> c))) {
+		c++;
+	}
+	return c;
+}
+
+/**
+ * Copies the neighbourhood of a character out of the frame, normalized so
+ * that ink is 0 and paper 255. Pixels outside the frame count as paper.
+ * @param frame Pointer to the frame.
+ * @param x0 Left column of the patch, may be off the frame.
+ * @param y0 Top row of the patch, may be off the frame.
+ * @param ink Ink level of the plate.
+ * @param scale 255 / (paper - ink), Q16.
+ * @param patch Output.
+ */
+static void lpr_patch(const lpr_frame_t *frame, int32_t x0, int32_t y0, uint32_t ink,
+		      uint32_t scale, uint8_t patch[LPR_PATCH_HEIGHT][LPR_PATCH_WIDTH])
+{
+	for (int32_t r = 0; r < LPR_PATCH_HEIGHT; r++) {
+		for (int32_t c = 0; c < LPR_PATCH_WIDTH; c++) {
+			int32_t x = x0 + c;
+			int32_t y = y0 + r;
+			uint32_t v = 255;
+
+			if (x >= 0 && y >= 0 && x < LPR_WIDTH && y < LPR_HEIGHT) {
+				uint32_t p = frame->pixels[y][x];
+
+				v = p <= ink ? 0 : MIN(((p - ink) * scale) >> 16, 255u);
+			}
+			patch[r][c] = (uint8_t)v;
+		}
+	}
+}
+
+/**
+ * Scores a template against a patch: sum of absolute differences. With
+ * template pixels of 0 or 255 the difference is a plain XOR. Stops at the
+ * end of the first row that reaches the bound.
+ * @param patch The character's normalized neighbourhood.
+ * @param tmpl The template, 0 for ink and 255 for paper.
+ * @param ox Template column in the patch.
+ * @param oy Template row in the patch.
+ * @param bound Score at which to stop.
+ * @return The score, or a value of at least bound if it stopped early.
+ */
+static uint32_t lpr_sad(const uint8_t patch[LPR_PATCH_HEIGHT][LPR_PATCH_WIDTH],
+			const uint8_t tmpl[LPR_CELL_HEIGHT][LPR_CELL_WIDTH], uint32_t ox, uint32_t oy,
+			uint32_t bound)
+{
+	uint32_t sad = 0;
+
+	for (uint32_t r = 0; r < LPR_CELL_HEIGHT; r++) {
+		const uint8_t *p = &patch[oy + r][ox];
+
+		for (uint32_t c = 0; c < LPR_CELL_WIDTH; c++) {
+			sad += p[c] ^ tmpl[r][c];
+		}
+		if (sad >= bound) {
+			break;
+		}
+	}
+	return sad;
+}
+
+/**
+ * Recognizes one character.
+ * @param patch The character's normalized neighbourhood; its first ink
+ *              column sits LPR_PATCH_FIRST columns in.
+ * @param kind 'L' for a letter, 'N' for a digit.
+ * @param confidence Output, how far the best template beat the runner-up, percent.
+ * @return The character.
+ */
+static char lpr_match(const uint8_t patch[LPR_PATCH_HEIGHT][LPR_PATCH_WIDTH], char kind,
+		      uint8_t *confidence)
+{
+	char base = kind == 'L' ? 'A' : '0';
+	uint32_t count = kind == 'L' ? 26 : 10;
+	uint32_t best = UINT32_MAX;
+	uint32_t second = UINT32_MAX;
+	char found = '?';
+	uint8_t tmpl[LPR_CELL_HEIGHT][LPR_CELL_WIDTH];
+
+	for (uint32_t i = 0; i < count; i++) {
+		const uint8_t *glyph = lpr_glyph((char)(base + i));
+		// Line the template's own first ink column up with the character's
+		uint32_t ox = LPR_PATCH_FIRST - lpr_glyph_left(glyph) * LPR_GLYPH_SCALE;
+		uint32_t score = UINT32_MAX;
+		// Past this the candidate is neither best nor a close runner-up
+		uint32_t bound = MIN(second, best < UINT32_MAX / LPR_OCR_BOUND ? best * LPR_OCR_BOUND
+									 : UINT32_MAX);
+
+		for (uint32_t r = 0; r < LPR_CELL_HEIGHT; r += LPR_GLYPH_SCALE) {
+			for (uint32_t c = 0; c < LPR_CELL_WIDTH; c++) {
+				bool on = glyph[r / LPR_GLYPH_SCALE] & (0x10 >> (c / LPR_GLYPH_SCALE));
+
+				tmpl[r][c] = on ? 0 : 255;
+			}
+			for (uint32_t k = 1; k < LPR_GLYPH_SCALE; k++) {
+				memcpy(tmpl[r + k], tmpl[r], LPR_CELL_WIDTH);
+			}
+		}
+		// Aligned position first: it usually wins and bounds the others early
+		for (uint32_t j = 0; j < ARRAY_SIZE(lpr_jitter) * ARRAY_SIZE(lpr_jitter); j++) {
+			score = MIN(score, lpr_sad(patch, tmpl, ox + lpr_jitter[j % ARRAY_SIZE(lpr_jitter)],
+						   LPR_OCR_JITTER + lpr_jitter[j / ARRAY_SIZE(lpr_jitter)],
+						   MIN(score, bound)));
+		}
+		if (score < best) {
+			second = best;
+			best = score;
+			found = (char)(base + i);
+		} else if (score < second) {
+			second = score;
+		}
+	}
+	*confidence = second == 0 || second == UINT32_MAX ? 0 : (uint8_t)((second - best) * 100 / second);
+	return found;
+}
+
+/**
+ * Reads the plate in a located crop.
+ * @param frame Pointer to the frame.
+ * @param crop The plate region found by lpr_locate().
+ * @param read Output, the characters and their confidence.
+ * @return True if seven characters were read, each with at least
+ *         CONFIG_RADAR_LPR_MIN_CONFIDENCE.
+ */
+RADAR_HOT bool lpr_read(const lpr_frame_t *frame, const lpr_rect_t *crop, lpr_read_t *read)
+{
+	uint32_t x1 = crop->x + crop->width;
+	uint32_t y1 = crop->y + crop->height;
+	uint32_t area = (uint32_t)crop->width * crop->height;
+	uint32_t sum = 0;
+	uint32_t dark_sum = 0;
+	uint32_t dark = 0;
+
+	memset(read, 0, sizeof(*read));
+	if (area == 0) {
+		return false;
+	}
+
+	// Ink and paper levels: the means below and above the crop's mean
+	for (uint32_t y = crop->y; y < y1; y++) {
+		for (uint32_t x = crop->x; x < x1; x++) {
+			sum += frame->pixels[y][x];
+		}
+	}
+	uint32_t mean = sum / area;
+	for (uint32_t y = crop->y; y < y1; y++) {
+		for (uint32_t x = crop->x; x < x1; x++) {
+			if (frame->pixels[y][x] < mean) {
+				dark_sum += frame->pixels[y][x];
+				dark++;
+			}
+		}
+	}
+	if (dark == 0 || dark == area) {
+		return false;
+	}
+	uint32_t ink = dark_sum / dark;
+	uint32_t paper = (sum - dark_sum) / (area - dark);
+	if (paper < ink + LPR_MIN_CONTRAST) {
+		return false;
+	}
+	uint32_t threshold = (ink + paper) / 2;
+	uint32_t scale = (255u << 16) / (paper - ink);
+
+	// Text rows: the longest run of rows with ink that are not solid band or border
+	uint32_t top = 0;
+	uint32_t bottom = 0;
+
+	for (uint32_t y = crop->y, start = crop->y; y <= y1; y++) {
+		uint32_t row = 0;
+
+		for (uint32_t x = crop->x; y < y1 && x < x1; x++) {
+			row += frame->pixels[y][x] < threshold;
+		}
+		if (y < y1 && row >= 2 * LPR_PLATE_CHARS && row * 10 < crop->width * 9u) {
+			continue;
+		}
+		if (y - start > bottom - top) {
+			top = start;
+			bottom = y;
+		}
+		start = y + 1;
+	}
+	if (bottom - top + 2 * LPR_OCR_JITTER < LPR_CELL_HEIGHT) {
+		return false;
+	}
+
+	// Characters: runs of columns with ink, wider than the border
+	uint8_t columns[LPR_PLATE_WIDTH + 2 * LPR_MARGIN_X + 1] = {0};
+	uint32_t first[LPR_PLATE_CHARS];
+	uint32_t count = 0;
+	uint32_t run = 0;
+
+	if (crop->width >= ARRAY_SIZE(columns)) {
+		return false;
+	}
+	for (uint32_t y = top; y < bottom; y++) {
+		for (uint32_t x = crop->x; x < x1; x++) {
+			columns[x - crop->x] += frame->pixels[y][x] < threshold;
+		}
+	}
+	for (uint32_t i = 0; i <= crop->width; i++) {
+		if (columns[i] >= LPR_GLYPH_SCALE) {
+			run++;
+			continue;
+		}
+		if (run >= LPR_MIN_RUN) {
+			if (run > LPR_CELL_WIDTH + 2 * LPR_OCR_JITTER || count == LPR_PLATE_CHARS) {
+				return false;
+			}
+			first[count++] = crop->x + i - run;
+		}
+		run = 0;
+	}
+	if (count != LPR_PLATE_CHARS) {
+		return false;
+	}
+
+	uint8_t patch[LPR_PATCH_HEIGHT][LPR_PATCH_WIDTH];
+
+	read->min_confidence = 100;
+	for (uint32_t i = 0; i < LPR_PLATE_CHARS; i++) {
+		lpr_patch(frame, (int32_t)first[i] - LPR_PATCH_FIRST, (int32_t)top - LPR_OCR_JITTER, ink,
+			  scale, patch);
+		read->plate[i] = lpr_match(patch, lpr_pattern[i], &read->confidence[i]);
+		read->min_confidence = MIN(read->min_confidence, read->confidence[i]);
+	}
+	read->plate[LPR_PLATE_CHARS] = '\0';
+	return read->min_confidence >= CONFIG_RADAR_LPR_MIN_CONFIDENCE;
+}
+
+/*
+ * Synthetic frames: the front of the vehicle under a road surface
+ * gradient, with headlights, a slatted grille and the plate, plus sensor
+ * noise. The plate is drawn with the recognition font.
+ */
+
+/**
+ * Advances the scene generator (xorshift32).
+ * @param rng Pointer to the generator state.
+ * @return The next value.
+ */
+static inline uint32_t lpr_sim_next(uint32_t *rng)
+{
+	uint32_t x = *rng;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*rng = x;
+	return x;
+}
+
+/**
+ * Fills a rectangle, clipped to the frame.
+ * @param frame Pointer to the frame.
+ * @param x Left column.
+ * @param y Top row.
+ * @param width Width.
+ * @param height Height.
+ * @param value Gray level.
+ */
+static void lpr_sim_fill(lpr_frame_t *frame, uint32_t x, uint32_t y, uint32_t width,
+			 uint32_t height, uint8_t value)
+{
+	for (uint32_t r = y; r < MIN(y + height, LPR_HEIGHT); r++) {
+		memset(&frame->pixels[r][x], value, MIN(x + width, LPR_WIDTH) - x);
+	}
+}
+
+/**
+ * Draws a Mercosul plate: white, dark border, blue band on top, seven
+ * dark characters.
+ * @param frame Pointer to the frame.
+ * @param x Left column of the plate.
+ * @param y Top row of the plate.
+ * @param plate The characters.
+ * @param paper Gray level of the plate.
+ * @param ink Gray level of the characters and border.
+ */
+static void lpr_sim_plate(lpr_frame_t *frame, uint32_t x, uint32_t y, const char *plate,
+			  uint8_t paper, uint8_t ink)
+{
+	lpr_sim_fill(frame, x, y, LPR_PLATE_WIDTH, LPR_PLATE_HEIGHT, ink);
+	lpr_sim_fill(frame, x + 1, y + 1, LPR_PLATE_WIDTH - 2, LPR_PLATE_HEIGHT - 2, paper);
+	lpr_sim_fill(frame, x + 1, y + 1, LPR_PLATE_WIDTH - 2, LPR_BAND_HEIGHT, paper / 3);
+
+	for (uint32_t i = 0; i < LPR_PLATE_CHARS && plate[i] != '\0'; i++) {
+		const uint8_t *glyph = lpr_glyph(plate[i]);
+		uint32_t gx = x + LPR_TEXT_X + i * LPR_CHAR_ADVANCE;
+
+		for (uint32_t r = 0; glyph != NULL && r < LPR_GLYPH_ROWS; r++) {
+			for (uint32_t c = 0; c < LPR_GLYPH_COLS; c++) {
+				if (glyph[r] & (0x10 >> c)) {
+					lpr_sim_fill(frame, gx + c * LPR_GLYPH_SCALE,
+						     y + LPR_TEXT_Y + r * LPR_GLYPH_SCALE,
+						     LPR_GLYPH_SCALE, LPR_GLYPH_SCALE, ink);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Renders a camera frame of a vehicle carrying a plate. The seed picks
+ * the vehicle's position, paint and exposure.
+ * @param frame Pointer to the frame to fill.
+ * @param plate The plate characters, or NULL for a vehicle without plate.
+ * @param seed Scene seed.
+ * @param where Output, where the plate was drawn; may be NULL.
+ */
+void lpr_sim_render(lpr_frame_t *frame, const char *plate, uint32_t seed, lpr_rect_t *where)
+{
+	uint32_t rng = seed * 2654435761u + 1;
+	uint32_t body_w = 2 * LPR_PLATE_WIDTH + lpr_sim_next(&rng) % (LPR_WIDTH / 4);
+	uint32_t body_h = LPR_HEIGHT / 2 + lpr_sim_next(&rng) % (LPR_HEIGHT / 4);
+	uint32_t body_x = lpr_sim_next(&rng) % (LPR_WIDTH - body_w + 1);
+	uint32_t body_y = LPR_HEIGHT - body_h;
+	uint8_t paint = 50 + lpr_sim_next(&rng) % 90;
+	uint8_t paper = 180 + lpr_sim_next(&rng) % 60;
+	uint8_t ink = 20 + lpr_sim_next(&rng) % 40;
+
+	// Road, brighter towards the camera
+	for (uint32_t y = 0; y < LPR_HEIGHT; y++) {
+		memset(frame->pixels[y], 70 + y * 60 / LPR_HEIGHT, LPR_WIDTH);
+	}
+	lpr_sim_fill(frame, body_x, body_y, body_w, body_h, paint);
+
+	// Headlights in the upper corners, grille slats between them
+	uint32_t light_w = body_w / 6;
+	lpr_sim_fill(frame, body_x + 8, body_y + 8, light_w, 14, 235);
+	lpr_sim_fill(frame, body_x + body_w - 8 - light_w, body_y + 8, light_w, 14, 235);
+	for (uint32_t slat = 0; slat < 4; slat++) {
+		lpr_sim_fill(frame, body_x + 16 + light_w, body_y + 10 + slat * 6, body_w - 32 - 2 * light_w,
+			     3, paint / 2);
+	}
+
+	// Plate centred low on the body, a few pixels off either way
+	uint32_t px = body_x + (body_w - LPR_PLATE_WIDTH) / 2 + lpr_sim_next(&rng) % 17 - 8;
+	uint32_t py = body_y + body_h - LPR_PLATE_HEIGHT - 12 - lpr_sim_next(&rng) % 12;
+	if (plate != NULL) {
+		lpr_sim_plate(frame, px, py, plate, paper, ink);
+	}
+	if (where != NULL) {
+		*where = (lpr_rect_t){
+			.x = px, .y = py, .width = LPR_PLATE_WIDTH, .height = LPR_PLATE_HEIGHT};
+	}
+
+	// Sensor noise, +-8 gray levels
+	for (uint32_t y = 0; y < LPR_HEIGHT; y++) {
+		for (uint32_t x = 0; x < LPR_WIDTH; x++) {
+			int v = frame->pixels[y][x] + (int)(lpr_sim_next(&rng) % 17) - 8;
+
+			frame->pixels[y][x] = (uint8_t)MIN(MAX(v, 0), 255);
+		}
+	}
+}
+
+/**
+ * Smears mud over one character of a rendered plate, the kind of plate a
+ * reader should reject rather than guess.
+ * @param frame Pointer to the frame.
+ * @param where The plate, as lpr_sim_render() drew it.
+ * @param seed Picks the character and the mud's shade.
+ */
+void lpr_sim_smudge(lpr_frame_t *frame, const lpr_rect_t *where, uint32_t seed)
+{
+	uint32_t rng = seed * 2246822519u + 1;
+	uint32_t i = lpr_sim_next(&rng) % LPR_PLATE_CHARS;
+	uint8_t mud = 90 + lpr_sim_next(&rng) % 40;
+
+	lpr_sim_fill(frame, where->x + LPR_TEXT_X + i * LPR_CHAR_ADVANCE - LPR_GLYPH_SCALE / 2,
+		     where->y + LPR_TEXT_Y + LPR_TEXT_HEIGHT / 3, LPR_CHAR_ADVANCE,
+		     LPR_TEXT_HEIGHT / 2, mud);
+}
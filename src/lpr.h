@@ -0,0 +1,83 @@
+#ifndef LPR_H
+#define LPR_H
+
+#include "radar_os.h"
+
+#ifndef CONFIG_RADAR_LPR_FRAME_WIDTH
+#define CONFIG_RADAR_LPR_FRAME_WIDTH 320
+#endif
+#ifndef CONFIG_RADAR_LPR_FRAME_HEIGHT
+#define CONFIG_RADAR_LPR_FRAME_HEIGHT 240
+#endif
+#ifndef CONFIG_RADAR_LPR_EDGE_THRESHOLD
+#define CONFIG_RADAR_LPR_EDGE_THRESHOLD 48
+#endif
+#ifndef CONFIG_RADAR_LPR_MIN_CONFIDENCE
+#define CONFIG_RADAR_LPR_MIN_CONFIDENCE 25
+#endif
+
+#define LPR_WIDTH  CONFIG_RADAR_LPR_FRAME_WIDTH
+#define LPR_HEIGHT CONFIG_RADAR_LPR_FRAME_HEIGHT
+// Padding keeps vector loads past the last column inside the row
+#define LPR_INTEGRAL_STRIDE (LPR_WIDTH + 16)
+
+// Plate as seen at the camera's focal point: Mercosul proportions (400 x 130 mm)
+#define LPR_PLATE_WIDTH  96
+#define LPR_PLATE_HEIGHT 32
+#define LPR_PLATE_CHARS  7
+#define LPR_BAND_HEIGHT  7 // Blue band with the country name, under the top border
+#define LPR_GLYPH_COLS   5
+#define LPR_GLYPH_ROWS   7
+#define LPR_GLYPH_SCALE  2
+#define LPR_CHAR_ADVANCE ((LPR_GLYPH_COLS + 1) * LPR_GLYPH_SCALE)
+#define LPR_TEXT_WIDTH   (LPR_PLATE_CHARS * LPR_CHAR_ADVANCE - LPR_GLYPH_SCALE)
+#define LPR_TEXT_HEIGHT  (LPR_GLYPH_ROWS * LPR_GLYPH_SCALE)
+#define LPR_TEXT_X       ((LPR_PLATE_WIDTH - LPR_TEXT_WIDTH) / 2)
+#define LPR_TEXT_Y       12
+// Least share of edge pixels in the best window for it to be a plate
+#define LPR_MIN_EDGE_PERCENT 10
+
+BUILD_ASSERT(LPR_WIDTH % 16 == 0, "Frame rows are processed 16 pixels at a time");
+BUILD_ASSERT(LPR_WIDTH >= 2 * LPR_PLATE_WIDTH && LPR_HEIGHT >= 2 * LPR_PLATE_HEIGHT,
+	     "Frame too small for the plate window");
+BUILD_ASSERT(LPR_PLATE_WIDTH * LPR_PLATE_HEIGHT < UINT16_MAX,
+	     "Window sums must fit the 16-bit integral image");
+
+// 8-bit grayscale camera frame
+typedef struct {
+	uint8_t pixels[LPR_HEIGHT][LPR_WIDTH];
+} lpr_frame_t;
+
+/*
+ * Integral image of the vertical edge map: sum[y][x] counts the edge
+ * pixels above row y and left of column x. Sums wrap at 16 bits, which
+ * keeps the table at half the size; the sum over any window smaller than
+ * 64K pixels still comes out exact in modular arithmetic.
+ */
+typedef struct {
+	uint16_t sum[LPR_HEIGHT + 1][LPR_INTEGRAL_STRIDE];
+} lpr_integral_t;
+
+typedef struct {
+	uint16_t x;
+	uint16_t y;
+	uint16_t width;
+	uint16_t height;
+} lpr_rect_t;
+
+// Plate read from a crop
+typedef struct {
+	char plate[LPR_PLATE_CHARS + 1];
+	uint8_t confidence[LPR_PLATE_CHARS]; // Per character: margin over the runner-up, percent
+	uint8_t min_confidence;
+} lpr_read_t;
+
+void lpr_integral(const lpr_frame_t *frame, lpr_integral_t *ii);
+bool lpr_search(const lpr_integral_t *ii, lpr_rect_t *crop);
+bool lpr_locate(const lpr_frame_t *frame, lpr_integral_t *ii, lpr_rect_t *crop);
+bool lpr_read(const lpr_frame_t *frame, const lpr_rect_t *crop, lpr_read_t *read);
+
+void lpr_sim_render(lpr_frame_t *frame, const char *plate, uint32_t seed, lpr_rect_t *where);
+void lpr_sim_smudge(lpr_frame_t *frame, const lpr_rect_t *where, uint32_t seed);
+
+#endif
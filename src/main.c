@@ -1,84 +1,269 @@
+#include <zephyr/fatal.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
 #include <zephyr/zbus/zbus.h>
 #include <string.h>
 #include <zephyr/sys/atomic.h>
 #include "common.h"
 #include "threads.h"
 #include "infraction_log.h"
+#include "dedup.h"
+#include "camera_trigger.h"
+#include "congestion.h"
+#include "display_fanout.h"
+#include "telemetry.h"
+#include "flight_recorder.h"
 
-LOG_MODULE_REGISTER(main_control, LOG_LEVEL_INF);
+LOG_MODULE_REGISTER(main_control, CONFIG_RADAR_LOG_LEVEL);
 
 K_MSGQ_DEFINE(sensor_msgq, sizeof(sensor_data_t), CONFIG_RADAR_QUEUE_DEPTH, 4); // Message Queue for Sensor Data
-K_MSGQ_DEFINE(display_msgq, sizeof(display_data_t), CONFIG_RADAR_QUEUE_DEPTH, 4); // Message Queue for Display Data
 
-// ZBUS Channels
-ZBUS_CHAN_DEFINE(camera_trigger_chan, camera_trigger_t, NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
-ZBUS_CHAN_DEFINE(camera_result_chan, camera_result_t, NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+// ZBUS Channels, with their observers wired at build time
+ZBUS_OBS_DECLARE(camera_trigger_lis, main_camera_lis);
+ZBUS_CHAN_DEFINE(camera_trigger_chan, camera_trigger_t, NULL, NULL, ZBUS_OBSERVERS(camera_trigger_lis), ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(camera_result_chan, camera_result_t, NULL, NULL, ZBUS_OBSERVERS(main_camera_lis), ZBUS_MSG_INIT(0));
 
 // Thread Definitions
-K_THREAD_DEFINE(sensor_tid, 2048, sensor_thread_entry, NULL, NULL, NULL, 7, 0, 0);
-K_THREAD_DEFINE(display_tid, 2048, display_thread_entry, NULL, NULL, NULL, 7, 0, 0);
-K_THREAD_DEFINE(camera_tid, 2048, camera_thread_entry, NULL, NULL, NULL, 7, 0, 0);
+K_THREAD_DEFINE(sensor_tid, CONFIG_RADAR_SENSOR_STACK_SIZE, sensor_thread_entry, NULL, NULL, NULL, 7, 0, 0);
+K_THREAD_DEFINE(camera_tid, CONFIG_RADAR_CAMERA_STACK_SIZE, camera_thread_entry, NULL, NULL, NULL, 7, 0, 0);
 
-// Subscriber for Main Thread
-ZBUS_SUBSCRIBER_DEFINE(main_camera_sub, 4);
-
-// Telemetry counters
-static atomic_t vehicle_light_count;
-static atomic_t vehicle_heavy_count;
-static atomic_t status_normal_count;
-static atomic_t status_warning_count;
-static atomic_t status_infraction_count;
+// Camera results, handed over by a ZBUS listener so main() can k_poll() on them
+K_MSGQ_DEFINE(camera_result_msgq, sizeof(camera_result_t), CONFIG_RADAR_CAMERA_PLATOON_MAX, 4);
 
 /**
- * Main entry point for the telemetry thread.
- * @param p1 Pointer to the telemetry thread data.
- * @param p2 Pointer to the telemetry thread data.
- * @param p3 Pointer to the telemetry thread data.
+ * ZBUS listener for camera results. Runs in the publisher's context.
+ * @param chan Pointer to the camera result channel.
  */
-static void telemetry_thread_entry(void *p1, void *p2, void *p3)
+static void camera_result_listener(const struct zbus_channel *chan)
 {
-	while (1) {
-        // Get the telemetry counters
-		k_msleep(CONFIG_RADAR_TELEMETRY_INTERVAL_MS);
-		uint32_t light = (uint32_t)atomic_get(&vehicle_light_count);
-		uint32_t heavy = (uint32_t)atomic_get(&vehicle_heavy_count);
-		uint32_t normal = (uint32_t)atomic_get(&status_normal_count);
-		uint32_t warn = (uint32_t)atomic_get(&status_warning_count);
-		uint32_t infr = (uint32_t)atomic_get(&status_infraction_count);
-		uint32_t inf_light = 0, inf_heavy = 0, valid_reads = 0, invalid_reads = 0;
-		infraction_log_get_counters(&inf_light, &inf_heavy, &valid_reads, &invalid_reads);
-		LOG_INF("Telemetry: Vehicles [Leve=%u, Pesado=%u] | Status [Normal=%u, Alerta=%u, Infracao=%u] | Camera [Validas=%u, Invalidas=%u]",
-			light, heavy, normal, warn, infr, valid_reads, invalid_reads);
-	}
+    const camera_result_t *res = zbus_chan_const_msg(chan);
+
+    if (k_msgq_put(&camera_result_msgq, res, K_NO_WAIT) != 0) {
+        LOG_WRN("camera_result_msgq full, dropping result");
+    }
 }
 
-K_THREAD_DEFINE(telemetry_tid, 1024, telemetry_thread_entry, NULL, NULL, NULL, 8, 0, 0);
+ZBUS_LISTENER_DEFINE(main_camera_lis, camera_result_listener);
+
+static struct k_poll_event work_events[] = {
+    K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_MSGQ_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+                                    &sensor_msgq, 0),
+    K_POLL_EVENT_STATIC_INITIALIZER(K_POLL_TYPE_MSGQ_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+                                    &camera_result_msgq, 0),
+};
 
 typedef struct {
 	bool active;
+	uint32_t id; // Camera trigger id
 	int64_t timestamp_ms;
 	uint32_t speed_kmh;
 	uint32_t limit_kmh;
 	vehicle_type_t type;
+	uint32_t gross_weight_kg;
+	uint32_t weight_limit_kg;
+	bool overweight;
 } pending_infraction_t;
 
-// Pending infraction context
-static pending_infraction_t pending_infraction_ctx;
+// Infractions waiting for their plate, keyed by trigger id; a platoon keeps several in flight
+static pending_infraction_t pending_infractions[2 * CONFIG_RADAR_CAMERA_PLATOON_MAX];
+static uint32_t next_trigger_id;
+
+/**
+ * Stores the context of an infraction until its camera result arrives.
+ * Overwrites the oldest one if every slot is taken.
+ * @param ctx The infraction context.
+ */
+static void pending_add(const pending_infraction_t *ctx)
+{
+    pending_infraction_t *slot = &pending_infractions[0];
+
+    for (size_t i = 0; i < ARRAY_SIZE(pending_infractions); i++) {
+        if (!pending_infractions[i].active) {
+            slot = &pending_infractions[i];
+            break;
+        }
+        if (pending_infractions[i].timestamp_ms < slot->timestamp_ms) {
+            slot = &pending_infractions[i];
+        }
+    }
+    if (slot->active) {
+        LOG_WRN("Pending infraction %u overwritten before its camera result", slot->id);
+    }
+    *slot = *ctx;
+}
+
+/**
+ * Takes the context of the infraction a camera result belongs to.
+ * @param id The trigger id of the result.
+ * @param ctx Pointer to the context to fill; not active if it was not found.
+ */
+static void pending_take(uint32_t id, pending_infraction_t *ctx)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(pending_infractions); i++) {
+        if (pending_infractions[i].active && pending_infractions[i].id == id) {
+            *ctx = pending_infractions[i];
+            pending_infractions[i].active = false;
+            return;
+        }
+    }
+    ctx->active = false;
+}
+
+#if IS_ENABLED(CONFIG_RADAR_DEDUP)
+// Recent measurements (lane, time, speed) and recently read plates
+static dedup_set_t vehicle_dedup;
+static dedup_set_t plate_dedup;
+#endif
+
+/**
+ * Drops a measurement that repeats a recent one on the same lane
+ * (sensor bounce, overlapping windows) before it reaches the camera.
+ * @param s_data The measurement.
+ * @return True if the measurement is a duplicate, false otherwise.
+ */
+static bool suppress_duplicate_measurement(const sensor_data_t *s_data)
+{
+#if IS_ENABLED(CONFIG_RADAR_DEDUP)
+    uint32_t speed_kmh = calculate_speed(CONFIG_RADAR_SENSOR_DISTANCE_MM, s_data->duration_ms);
+    if (dedup_vehicle_check(&vehicle_dedup, s_data->lane, s_data->timestamp_start, speed_kmh,
+                            CONFIG_RADAR_DEDUP_SPEED_TOLERANCE_KMH)) {
+        telemetry_inc(TELEMETRY_DEDUP_VEHICLE);
+        LOG_WRN("Duplicate measurement suppressed (lane %u, %u km/h)", s_data->lane, speed_kmh);
+        return true;
+    }
+#endif
+    return false;
+}
+
+/**
+ * Drops a plate read that repeats a recent one, so a vehicle is logged once.
+ * @param plate The validated plate.
+ * @return True if the plate is a duplicate, false otherwise.
+ */
+static bool suppress_duplicate_plate(const char *plate)
+{
+#if IS_ENABLED(CONFIG_RADAR_DEDUP)
+    if (dedup_plate_check(&plate_dedup, plate_pack(plate), k_uptime_get())) {
+        telemetry_inc(TELEMETRY_DEDUP_PLATE);
+        LOG_WRN("Duplicate plate %s suppressed", plate);
+        return true;
+    }
+#endif
+    return false;
+}
+
+/**
+ * Checks a weighed vehicle against the gross weight limit of its type.
+ * @param s_data The measurement.
+ * @param limit_kg Pointer to the limit to fill, 0 if the vehicle was not weighed.
+ * @return True if the vehicle is overweight, false otherwise.
+ */
+static bool check_overweight(const sensor_data_t *s_data, uint32_t *limit_kg)
+{
+    *limit_kg = 0;
+#if IS_ENABLED(CONFIG_RADAR_WIM)
+    if (s_data->gross_weight_kg == 0) {
+        return false;
+    }
+    *limit_kg = (s_data->type == VEHICLE_HEAVY) ? CONFIG_RADAR_WIM_LIMIT_HEAVY_KG :
+                                                  CONFIG_RADAR_WIM_LIMIT_LIGHT_KG;
+    if ((uint64_t)s_data->gross_weight_kg * 100 >
+        (uint64_t)*limit_kg * (100 + CONFIG_RADAR_WIM_TOLERANCE_PERCENT)) {
+        telemetry_inc(TELEMETRY_OVERWEIGHT);
+        LOG_WRN("Overweight: %u kg (limit %u kg)", s_data->gross_weight_kg, *limit_kg);
+        return true;
+    }
+#endif
+    return false;
+}
+
+#if IS_ENABLED(CONFIG_RADAR_CONGESTION)
+static congestion_t congestion;
+static int64_t congestion_shown_ms;
+#endif
+
+/**
+ * Feeds a measurement to the congestion detector. While the road is
+ * congested, the display gets one aggregate block per interval instead of
+ * one block per vehicle.
+ * @param s_data The measurement.
+ * @param speed_kmh The measured speed.
+ * @return True if the road is congested, false otherwise.
+ */
+static bool congestion_track(const sensor_data_t *s_data, uint32_t speed_kmh)
+{
+#if IS_ENABLED(CONFIG_RADAR_CONGESTION)
+    bool was_active = congestion.active;
+    bool active = congestion_update(&congestion, s_data->timestamp_end, speed_kmh, s_data->duration_ms);
+    congestion_stats_t stats;
+
+    if (active == was_active && (!active ||
+        s_data->timestamp_end - congestion_shown_ms < CONFIG_RADAR_CONGESTION_DISPLAY_INTERVAL_MS)) {
+        return active;
+    }
+
+    congestion_get_stats(&congestion, s_data->timestamp_end, &stats);
+    if (active != was_active) {
+        LOG_WRN("Congestion %s: %u vehicles, mean %u km/h, occupancy %u%%",
+                active ? "detected" : "cleared", stats.vehicles, stats.mean_speed_kmh,
+                stats.occupancy_percent);
+    }
+    if (active) {
+        display_data_t d_data = {
+            .speed_kmh = stats.mean_speed_kmh,
+            .status = STATUS_NORMAL,
+            .type = VEHICLE_UNKNOWN,
+            .congested = true,
+            .aggregate_vehicles = stats.vehicles,
+            .occupancy_percent = stats.occupancy_percent,
+        };
+        display_publish(&d_data);
+        congestion_shown_ms = s_data->timestamp_end;
+    }
+    return active;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Fatal error handler: dumps the flight recorder before halting. The ring
+ * also stays in noinit RAM for the next boot and for coredumps.
+ * @param reason The fatal error reason.
+ * @param esf Pointer to the exception stack frame.
+ */
+void k_sys_fatal_error_handler(unsigned int reason, const struct arch_esf *esf) {
+    ARG_UNUSED(esf);
+
+    LOG_PANIC();
+#if IS_ENABLED(CONFIG_RADAR_FLIGHT_RECORDER)
+    flight_recorder_print("fatal error");
+#endif
+    k_fatal_halt(reason);
+}
 
 int main(void) {
     LOG_INF("Radar System Initializing...");
 
-	// Subscribe to the camera result channel
-    zbus_chan_add_obs(&camera_result_chan, &main_camera_sub, K_FOREVER);
+#if IS_ENABLED(CONFIG_RADAR_DEDUP)
+    dedup_set_init(&vehicle_dedup, CONFIG_RADAR_DEDUP_WINDOW_MS);
+    dedup_set_init(&plate_dedup, CONFIG_RADAR_DEDUP_PLATE_WINDOW_MS);
+#endif
+#if IS_ENABLED(CONFIG_RADAR_CONGESTION)
+    congestion_init(&congestion, CONFIG_RADAR_CONGESTION_WINDOW_MS);
+#endif
 
     sensor_data_t s_data;
-    const struct zbus_channel *chan; // ZBUS channel for camera results
 
     while (1) {
         // Check for new sensor data
-        if (k_msgq_get(&sensor_msgq, &s_data, K_NO_WAIT) == 0) {
+        if (k_msgq_get(&sensor_msgq, &s_data, K_NO_WAIT) == 0 &&
+            !suppress_duplicate_measurement(&s_data)) {
+            uint32_t t0 = k_cycle_get_32();
+            int64_t waited_ms = k_uptime_get() - s_data.timestamp_end;
+            telemetry_record(TELEMETRY_HIST_QUEUE_WAIT, waited_ms > 0 ? (uint32_t)waited_ms : 0);
+
             // Calculate Speed
             uint32_t distance_mm = CONFIG_RADAR_SENSOR_DISTANCE_MM;
             uint32_t speed_kmh = calculate_speed(distance_mm, s_data.duration_ms);
@@ -100,7 +285,21 @@ int main(void) {
                 }
             }
 
-            LOG_INF("Speed Calc: %d km/h (Limit: %d). Status: %d", speed_kmh, limit, status);
+            // Overweight is an infraction at any speed
+            uint32_t weight_limit_kg;
+            bool overweight = check_overweight(&s_data, &weight_limit_kg);
+            if (overweight) {
+                status = STATUS_INFRACTION;
+            }
+
+            // In congestion, vehicles within the limit only feed the aggregates
+            bool congested = congestion_track(&s_data, speed_kmh);
+            bool aggregate = congested && status == STATUS_NORMAL;
+
+            if (!aggregate) {
+                LOG_INF("Speed Calc: %d km/h (Limit: %d). Status: %d", speed_kmh, limit, status);
+            }
+            FLIGHT_RECORD(FLIGHT_EV_SPEED, status, speed_kmh);
 
             // Update Display
             display_data_t d_data;
@@ -111,131 +310,155 @@ int main(void) {
             d_data.plate[0] = '\0';
             d_data.axle_count = s_data.axle_count;
             d_data.warning_kmh = (limit * CONFIG_RADAR_WARNING_THRESHOLD_PERCENT) / 100;
+            d_data.congested = congested;
+            d_data.aggregate_vehicles = 0;
+            d_data.occupancy_percent = 0;
+            d_data.gross_weight_kg = s_data.gross_weight_kg;
+            d_data.weight_limit_kg = weight_limit_kg;
+            d_data.overweight = overweight;
 
             // Update telemetry counters
             if (s_data.type == VEHICLE_LIGHT) {
-                atomic_inc(&vehicle_light_count);
+                telemetry_inc(TELEMETRY_VEHICLE_LIGHT);
             } else if (s_data.type == VEHICLE_HEAVY) {
-                atomic_inc(&vehicle_heavy_count);
+                telemetry_inc(TELEMETRY_VEHICLE_HEAVY);
             }
             switch (status) {
-                case STATUS_NORMAL: atomic_inc(&status_normal_count); break;
-                case STATUS_WARNING: atomic_inc(&status_warning_count); break;
-                case STATUS_INFRACTION: atomic_inc(&status_infraction_count); break;
+                case STATUS_NORMAL: telemetry_inc(TELEMETRY_STATUS_NORMAL); break;
+                case STATUS_WARNING: telemetry_inc(TELEMETRY_STATUS_WARNING); break;
+                case STATUS_INFRACTION: telemetry_inc(TELEMETRY_STATUS_INFRACTION); break;
             }
-            // Send the display data to the display queue
-            {
-                int put_ret = k_msgq_put(&display_msgq, &d_data, K_NO_WAIT);
-                if (put_ret != 0) {
-                    display_data_t dropped;
-                    (void)k_msgq_get(&display_msgq, &dropped, K_NO_WAIT);
-                    put_ret = k_msgq_put(&display_msgq, &d_data, K_NO_WAIT);
-                    if (put_ret != 0) {
-                        LOG_WRN("display_msgq full, dropping update");
-                    }
-                }
+            // A dataset replay only evaluates: no display frames, no camera captures
+            if (!aggregate && !IS_ENABLED(CONFIG_RADAR_TRAFFIC_SIM_DATASET)) {
+                telemetry_notify();
+                // Hand the frame to every display sink
+                display_publish(&d_data);
             }
 
             // Trigger Camera if Infraction
-            if (status == STATUS_INFRACTION) {
+            if (status == STATUS_INFRACTION && !IS_ENABLED(CONFIG_RADAR_TRAFFIC_SIM_DATASET)) {
+                // Hardware pulse at the focal point; the ZBUS trigger below drives the plate read
+                (void)camera_trigger_schedule(&s_data);
                 camera_trigger_t trig;
+                trig.id = next_trigger_id++;
+                trig.lane = s_data.lane;
+                trig.timestamp_ms = k_uptime_get();
                 trig.speed_kmh = speed_kmh;
                 trig.type = s_data.type;
                 /* Record pending infraction context */
-                pending_infraction_ctx.active = true;
-                pending_infraction_ctx.timestamp_ms = k_uptime_get();
-                pending_infraction_ctx.speed_kmh = speed_kmh;
-                pending_infraction_ctx.limit_kmh = limit;
-                pending_infraction_ctx.type = s_data.type;
+                pending_infraction_t ctx = {
+                    .active = true,
+                    .id = trig.id,
+                    .timestamp_ms = trig.timestamp_ms,
+                    .speed_kmh = speed_kmh,
+                    .limit_kmh = limit,
+                    .type = s_data.type,
+                    .gross_weight_kg = s_data.gross_weight_kg,
+                    .weight_limit_kg = weight_limit_kg,
+                    .overweight = overweight,
+                };
+                pending_add(&ctx);
                 int pub_ret = zbus_chan_pub(&camera_trigger_chan, &trig, K_NO_WAIT);
-                if (pub_ret != 0) {
+                if (pub_ret == 0) {
+                    telemetry_inc(TELEMETRY_CAMERA_TRIGGER);
+                    FLIGHT_RECORD(FLIGHT_EV_TRIGGER, 0, speed_kmh);
+                } else {
                     LOG_WRN("ZBUS publish to camera_trigger_chan failed: %d", pub_ret);
                 }
             }
+            telemetry_add_cycles(congested ? TELEMETRY_MODE_CONGESTED : TELEMETRY_MODE_NORMAL,
+                                 k_cycle_get_32() - t0, 1);
         }
 
         // Check for Camera Results
-        if (zbus_sub_wait(&main_camera_sub, &chan, K_NO_WAIT) == 0) {
-			// Check if the channel is the camera result channel
-			if (chan == &camera_result_chan) {
-                camera_result_t res;
-				// Read the camera result
-                zbus_chan_read(&camera_result_chan, &res, K_NO_WAIT);
-                
-                // Check if the plate is valid
-                if (res.valid_read && validate_plate(res.plate)) {
-                    LOG_INF("Valid Plate: %s. Infraction Recorded.", res.plate);
-                    /* Store infraction record */
-                    infraction_record_t rec = {
-                        .timestamp_ms = pending_infraction_ctx.active ? pending_infraction_ctx.timestamp_ms : k_uptime_get(),
-                        .type = pending_infraction_ctx.active ? pending_infraction_ctx.type : VEHICLE_UNKNOWN,
-                        .speed_kmh = pending_infraction_ctx.active ? pending_infraction_ctx.speed_kmh : 0,
-                        .limit_kmh = pending_infraction_ctx.active ? pending_infraction_ctx.limit_kmh : 0,
-                        .valid_read = true
-                    };
-                    strncpy(rec.plate, res.plate, sizeof(rec.plate));
-                    rec.plate[sizeof(rec.plate)-1] = '\0';
-                    infraction_log_add(&rec);
-                    /* Send plate info to display with context */
-                    display_data_t d_data;
-                    d_data.speed_kmh = pending_infraction_ctx.active ? pending_infraction_ctx.speed_kmh : 0; 
-                    d_data.limit_kmh = pending_infraction_ctx.active ? pending_infraction_ctx.limit_kmh : 0;
-                    d_data.type = pending_infraction_ctx.active ? pending_infraction_ctx.type : VEHICLE_UNKNOWN;
-                    d_data.status = STATUS_INFRACTION;
-                    d_data.axle_count = 0;
-                    d_data.warning_kmh = (d_data.limit_kmh * CONFIG_RADAR_WARNING_THRESHOLD_PERCENT) / 100;
-                    strncpy(d_data.plate, res.plate, sizeof(d_data.plate));
-                    {
-                        int put_ret = k_msgq_put(&display_msgq, &d_data, K_NO_WAIT);
-                        if (put_ret != 0) {
-                            display_data_t dropped;
-                            (void)k_msgq_get(&display_msgq, &dropped, K_NO_WAIT);
-                            put_ret = k_msgq_put(&display_msgq, &d_data, K_NO_WAIT);
-                            if (put_ret != 0) {
-                                LOG_WRN("display_msgq full, dropping update");
-                            }
-                        }
-                    }
-                    pending_infraction_ctx.active = false;
+        camera_result_t res;
+        if (k_msgq_get(&camera_result_msgq, &res, K_NO_WAIT) == 0) {
+            telemetry_inc(TELEMETRY_CAMERA_RESULT);
+            telemetry_notify();
+            FLIGHT_RECORD(FLIGHT_EV_RESULT, res.valid_read, 0);
+            pending_infraction_t ctx;
+            pending_take(res.id, &ctx);
+            if (ctx.active) {
+                telemetry_record(TELEMETRY_HIST_CAMERA_RTT,
+                                 (uint32_t)(k_uptime_get() - ctx.timestamp_ms));
+            }
+            
+            // Check if the plate is valid
+            bool valid = res.valid_read && validate_plate(res.plate);
+            if (valid && suppress_duplicate_plate(res.plate)) {
+                // Same vehicle, already recorded under this plate
+            } else if (valid) {
+                LOG_INF("Valid Plate: %s. Infraction Recorded.", res.plate);
+                /* Store infraction record */
+                infraction_record_t rec = {
+                    .timestamp_ms = ctx.active ? ctx.timestamp_ms : k_uptime_get(),
+                    .type = ctx.active ? ctx.type : VEHICLE_UNKNOWN,
+                    .speed_kmh = ctx.active ? ctx.speed_kmh : 0,
+                    .limit_kmh = ctx.active ? ctx.limit_kmh : 0,
+                    .gross_weight_kg = ctx.active ? ctx.gross_weight_kg : 0,
+                    .valid_read = true
+                };
+                strncpy(rec.plate, res.plate, sizeof(rec.plate));
+                rec.plate[sizeof(rec.plate)-1] = '\0';
+                infraction_log_add(&rec);
+                FLIGHT_RECORD(FLIGHT_EV_LOG_ADD, rec.type, rec.speed_kmh);
+                /* Send plate info to display with context */
+                display_data_t d_data;
+                d_data.speed_kmh = ctx.active ? ctx.speed_kmh : 0; 
+                d_data.limit_kmh = ctx.active ? ctx.limit_kmh : 0;
+                d_data.type = ctx.active ? ctx.type : VEHICLE_UNKNOWN;
+                d_data.status = STATUS_INFRACTION;
+                d_data.axle_count = 0;
+                d_data.warning_kmh = (d_data.limit_kmh * CONFIG_RADAR_WARNING_THRESHOLD_PERCENT) / 100;
+                strncpy(d_data.plate, res.plate, sizeof(d_data.plate));
+                d_data.congested = false;
+                d_data.aggregate_vehicles = 0;
+                d_data.occupancy_percent = 0;
+                d_data.gross_weight_kg = ctx.active ? ctx.gross_weight_kg : 0;
+                d_data.weight_limit_kg = ctx.active ? ctx.weight_limit_kg : 0;
+                d_data.overweight = ctx.active && ctx.overweight;
+                display_publish(&d_data);
 
-                } else {
-                    LOG_WRN("Invalid Plate or Read Error");
-                    /* Still store infraction record with invalid read */
-                    infraction_record_t rec = {
-                        .timestamp_ms = pending_infraction_ctx.active ? pending_infraction_ctx.timestamp_ms : k_uptime_get(),
-                        .type = pending_infraction_ctx.active ? pending_infraction_ctx.type : VEHICLE_UNKNOWN,
-                        .speed_kmh = pending_infraction_ctx.active ? pending_infraction_ctx.speed_kmh : 0,
-                        .limit_kmh = pending_infraction_ctx.active ? pending_infraction_ctx.limit_kmh : 0,
-                        .valid_read = false
-                    };
-                    rec.plate[0] = '\0';
-                    infraction_log_add(&rec);
-                    /* Also update display with known context (no plate) */
-                    display_data_t d_data;
-                    d_data.speed_kmh = pending_infraction_ctx.active ? pending_infraction_ctx.speed_kmh : 0; 
-                    d_data.limit_kmh = pending_infraction_ctx.active ? pending_infraction_ctx.limit_kmh : 0;
-                    d_data.type = pending_infraction_ctx.active ? pending_infraction_ctx.type : VEHICLE_UNKNOWN;
-                    d_data.status = STATUS_INFRACTION;
-                    d_data.axle_count = 0;
-                    d_data.warning_kmh = (d_data.limit_kmh * CONFIG_RADAR_WARNING_THRESHOLD_PERCENT) / 100;
-                    d_data.plate[0] = '\0';
-                    {
-                        int put_ret = k_msgq_put(&display_msgq, &d_data, K_NO_WAIT);
-                        if (put_ret != 0) {
-                            display_data_t dropped;
-                            (void)k_msgq_get(&display_msgq, &dropped, K_NO_WAIT);
-                            put_ret = k_msgq_put(&display_msgq, &d_data, K_NO_WAIT);
-                            if (put_ret != 0) {
-                                LOG_WRN("display_msgq full, dropping update");
-                            }
-                        }
-                    }
-                    pending_infraction_ctx.active = false;
-                }
+            } else {
+                LOG_WRN("Invalid Plate or Read Error");
+                /* Still store infraction record with invalid read */
+                infraction_record_t rec = {
+                    .timestamp_ms = ctx.active ? ctx.timestamp_ms : k_uptime_get(),
+                    .type = ctx.active ? ctx.type : VEHICLE_UNKNOWN,
+                    .speed_kmh = ctx.active ? ctx.speed_kmh : 0,
+                    .limit_kmh = ctx.active ? ctx.limit_kmh : 0,
+                    .gross_weight_kg = ctx.active ? ctx.gross_weight_kg : 0,
+                    .valid_read = false
+                };
+                rec.plate[0] = '\0';
+                infraction_log_add(&rec);
+                FLIGHT_RECORD(FLIGHT_EV_LOG_ADD, rec.type, rec.speed_kmh);
+                /* Also update display with known context (no plate) */
+                display_data_t d_data;
+                d_data.speed_kmh = ctx.active ? ctx.speed_kmh : 0; 
+                d_data.limit_kmh = ctx.active ? ctx.limit_kmh : 0;
+                d_data.type = ctx.active ? ctx.type : VEHICLE_UNKNOWN;
+                d_data.status = STATUS_INFRACTION;
+                d_data.axle_count = 0;
+                d_data.warning_kmh = (d_data.limit_kmh * CONFIG_RADAR_WARNING_THRESHOLD_PERCENT) / 100;
+                d_data.plate[0] = '\0';
+                d_data.congested = false;
+                d_data.aggregate_vehicles = 0;
+                d_data.occupancy_percent = 0;
+                d_data.gross_weight_kg = ctx.active ? ctx.gross_weight_kg : 0;
+                d_data.weight_limit_kg = ctx.active ? ctx.weight_limit_kg : 0;
+                d_data.overweight = ctx.active && ctx.overweight;
+                display_publish(&d_data);
             }
         }
 
-        k_msleep(10);
+        // Sleep until a measurement or a camera result arrives
+        if (k_msgq_num_used_get(&sensor_msgq) == 0 && k_msgq_num_used_get(&camera_result_msgq) == 0) {
+            (void)k_poll(work_events, ARRAY_SIZE(work_events), K_FOREVER);
+            work_events[0].state = K_POLL_STATE_NOT_READY;
+            work_events[1].state = K_POLL_STATE_NOT_READY;
+            telemetry_inc(TELEMETRY_WAKEUP);
+        }
     }
     return 0;
 }
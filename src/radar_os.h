@@ -0,0 +1,220 @@
+#ifndef RADAR_OS_H
+#define RADAR_OS_H
+
+/*
+ * Thin OS layer for the portable core (FSM, validation, infraction log,
+ * dedup). On Zephyr everything maps 1:1 onto kernel primitives; the host
+ * build maps the same names onto C11 atomics and pthreads so the core can
+ * be built and benchmarked with plain CMake.
+ */
+
+#if defined(__ZEPHYR__)
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/linker/section_tags.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+
+// Per-vehicle hot path, executed from RAM when the board supports it
+#if defined(CONFIG_RADAR_HOT_RAMFUNC)
+#define RADAR_HOT __ramfunc
+#else
+#define RADAR_HOT
+#endif
+
+typedef struct k_spinlock radar_lock_t;
+typedef k_spinlock_key_t radar_lock_key_t;
+typedef atomic_t radar_atomic_t;
+typedef atomic_val_t radar_atomic_val_t;
+
+static inline radar_lock_key_t radar_lock(radar_lock_t *lock)
+{
+	return k_spin_lock(lock);
+}
+
+static inline void radar_unlock(radar_lock_t *lock, radar_lock_key_t key)
+{
+	k_spin_unlock(lock, key);
+}
+
+static inline int64_t radar_uptime_ms(void)
+{
+	return k_uptime_get();
+}
+
+static inline void radar_sleep_ms(int32_t ms)
+{
+	k_msleep(ms);
+}
+
+static inline uint32_t radar_cycles(void)
+{
+	return k_cycle_get_32();
+}
+
+static inline uint32_t radar_cycles_per_sec(void)
+{
+	return sys_clock_hw_cycles_per_sec();
+}
+
+#define radar_atomic_get(a)    atomic_get(a)
+#define radar_atomic_set(a, v) atomic_set(a, v)
+#define radar_atomic_inc(a)    atomic_inc(a)
+#define radar_atomic_add(a, v) atomic_add(a, v)
+#define radar_atomic_cas(a, old, new_value) atomic_cas(a, old, new_value)
+#define radar_atomic_fence()   barrier_dmem_fence_full()
+
+// Deferred work item running on its own work queue thread
+typedef struct {
+	struct k_work_q queue;
+	struct k_work work;
+} radar_worker_t;
+
+/**
+ * Defines a worker that runs handler() on a dedicated work queue thread.
+ * The queue is started at APPLICATION init.
+ */
+#define RADAR_WORKER_DEFINE(_name, _handler, _stack_size, _priority)                               \
+	K_THREAD_STACK_DEFINE(_name##_stack, _stack_size);                                         \
+	static radar_worker_t _name;                                                               \
+	static void _name##_trampoline(struct k_work *work)                                        \
+	{                                                                                          \
+		ARG_UNUSED(work);                                                                  \
+		_handler();                                                                        \
+	}                                                                                          \
+	static int _name##_init(void)                                                              \
+	{                                                                                          \
+		const struct k_work_queue_config cfg = {.name = #_name};                           \
+		k_work_init(&_name.work, _name##_trampoline);                                      \
+		k_work_queue_start(&_name.queue, _name##_stack,                                    \
+				   K_THREAD_STACK_SIZEOF(_name##_stack), _priority, &cfg);         \
+		return 0;                                                                          \
+	}                                                                                          \
+	SYS_INIT(_name##_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY)
+
+/**
+ * Queues the worker. Submitting an already queued worker is a no-op.
+ * @param worker Pointer to the worker.
+ */
+static inline void radar_worker_submit(radar_worker_t *worker)
+{
+	k_work_submit_to_queue(&worker->queue, &worker->work);
+}
+
+#else /* Host build */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifndef IS_ENABLED
+// Same trick as Zephyr: 1 when the macro is defined to 1, 0 otherwise
+#define Z_IS_ENABLED_PLACEHOLDER_1 0,
+#define Z_IS_ENABLED_TAKE(_ignored, val, ...) val
+#define Z_IS_ENABLED_EXPAND(x) Z_IS_ENABLED_TAKE(x 1, 0, 0)
+#define Z_IS_ENABLED_PASTE(x) Z_IS_ENABLED_EXPAND(Z_IS_ENABLED_PLACEHOLDER_##x)
+#define IS_ENABLED(config) Z_IS_ENABLED_PASTE(config)
+#endif
+
+#define RADAR_HOT
+#define ARG_UNUSED(x)           (void)(x)
+#define ARRAY_SIZE(array)       (sizeof(array) / sizeof((array)[0]))
+#define SIZEOF_FIELD(type, member) sizeof(((type *)0)->member)
+#define BUILD_ASSERT(expr, msg) _Static_assert(expr, msg)
+#ifndef MAX
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+// Zero-initialised like a k_spinlock, so static locks need no init call
+typedef struct {
+	atomic_flag flag;
+} radar_lock_t;
+typedef int radar_lock_key_t;
+typedef atomic_long radar_atomic_t;
+typedef long radar_atomic_val_t;
+
+static inline radar_lock_key_t radar_lock(radar_lock_t *lock)
+{
+	while (atomic_flag_test_and_set_explicit(&lock->flag, memory_order_acquire)) {
+	}
+	return 0;
+}
+
+static inline void radar_unlock(radar_lock_t *lock, radar_lock_key_t key)
+{
+	(void)key;
+	atomic_flag_clear_explicit(&lock->flag, memory_order_release);
+}
+
+static inline uint64_t radar_host_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static inline int64_t radar_uptime_ms(void)
+{
+	return (int64_t)(radar_host_ns() / 1000000u);
+}
+
+static inline void radar_sleep_ms(int32_t ms)
+{
+	struct timespec ts = {.tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000L};
+
+	nanosleep(&ts, NULL);
+}
+
+// Host "cycles" are nanoseconds of the monotonic clock
+static inline uint32_t radar_cycles(void)
+{
+	return (uint32_t)radar_host_ns();
+}
+
+static inline uint32_t radar_cycles_per_sec(void)
+{
+	return 1000000000u;
+}
+
+#define radar_atomic_get(a)    atomic_load(a)
+#define radar_atomic_set(a, v) atomic_exchange(a, v)
+#define radar_atomic_inc(a)    atomic_fetch_add(a, 1)
+#define radar_atomic_add(a, v) atomic_fetch_add(a, v)
+#define radar_atomic_fence()   atomic_thread_fence(memory_order_seq_cst)
+
+static inline bool radar_atomic_cas(radar_atomic_t *a, radar_atomic_val_t old,
+				    radar_atomic_val_t new_value)
+{
+	return atomic_compare_exchange_strong(a, &old, new_value);
+}
+
+// Background pthread started on first submit
+typedef struct {
+	void (*handler)(void);
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	pthread_t thread;
+	bool started;
+	bool pending;
+} radar_worker_t;
+
+#define RADAR_WORKER_DEFINE(_name, _handler, _stack_size, _priority)                               \
+	static radar_worker_t _name = {                                                            \
+		.handler = _handler,                                                               \
+		.mutex = PTHREAD_MUTEX_INITIALIZER,                                                \
+		.cond = PTHREAD_COND_INITIALIZER,                                                  \
+	}
+
+void radar_worker_submit(radar_worker_t *worker);
+
+#endif /* __ZEPHYR__ */
+
+#endif
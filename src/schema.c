@@ -0,0 +1,133 @@
+#include "schema.h"
+#include <string.h>
+
+static inline uint8_t *schema_put_u8(uint8_t *p, uint8_t v)
+{
+	*p++ = v;
+	return p;
+}
+
+static inline uint8_t *schema_put_le32(uint8_t *p, uint32_t v)
+{
+	for (int i = 0; i < 4; i++) {
+		*p++ = (uint8_t)(v >> (8 * i));
+	}
+	return p;
+}
+
+static inline uint8_t *schema_put_le64(uint8_t *p, uint64_t v)
+{
+	p = schema_put_le32(p, (uint32_t)v);
+	return schema_put_le32(p, (uint32_t)(v >> 32));
+}
+
+/**
+ * Writes a string field: the string, then zeros to the field size, so
+ * whatever followed the terminator in memory never reaches the wire.
+ * @param p Where to write.
+ * @param s The string.
+ * @param size The field size.
+ * @return The byte after the field.
+ */
+static inline uint8_t *schema_put_str(uint8_t *p, const char *s, size_t size)
+{
+	size_t n = strnlen(s, size);
+
+	memcpy(p, s, n);
+	memset(p + n, 0, size - n);
+	return p + size;
+}
+
+static inline uint32_t schema_get_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+	       ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t schema_get_le64(const uint8_t *p)
+{
+	return schema_get_le32(p) | ((uint64_t)schema_get_le32(p + 4) << 32);
+}
+
+/**
+ * Reads a string field, which must hold its terminator.
+ * @param p Pointer to the read position, advanced past the field.
+ * @param s Output string.
+ * @param size The field size.
+ * @return True if the field is a valid string.
+ */
+static inline bool schema_get_str(const uint8_t **p, char *s, size_t size)
+{
+	if (memchr(*p, 0, size) == NULL) {
+		return false;
+	}
+	memcpy(s, *p, size);
+	*p += size;
+	return true;
+}
+
+// Encoding of one field of each kind
+#define SCHEMA_PUT_U8(p, v)   schema_put_u8(p, (uint8_t)(v))
+#define SCHEMA_PUT_BOOL(p, v) schema_put_u8(p, (v) ? 1 : 0)
+#define SCHEMA_PUT_ENUM(p, v) schema_put_u8(p, (uint8_t)(v))
+#define SCHEMA_PUT_U32(p, v)  schema_put_le32(p, v)
+#define SCHEMA_PUT_I64(p, v)  schema_put_le64(p, (uint64_t)(v))
+#define SCHEMA_PUT_STR(p, s)  schema_put_str(p, s, sizeof(s))
+
+// Decoding: true if the field is in range, the read position advanced past it
+#define SCHEMA_GET_U8(p, f)         ((f) = *(p)++, true)
+#define SCHEMA_GET_BOOL(p, f)       (*(p) <= 1 && ((f) = *(p)++ != 0, true))
+#define SCHEMA_GET_ENUM(p, f, t, n) (*(p) < (n) && ((f) = (t)(*(p)++), true))
+#define SCHEMA_GET_U32(p, f)        ((f) = schema_get_le32(p), (p) += 4, true)
+#define SCHEMA_GET_I64(p, f)        ((f) = (int64_t)schema_get_le64(p), (p) += 8, true)
+#define SCHEMA_GET_STR(p, f, n)     schema_get_str(&(p), f, n)
+
+// Enums go on the wire as one byte
+#define SCHEMA_CHECK_U8(...)
+#define SCHEMA_CHECK_BOOL(...)
+#define SCHEMA_CHECK_ENUM(t, n) BUILD_ASSERT((n) <= 256, #t " does not fit in a byte");
+#define SCHEMA_CHECK_U32(...)
+#define SCHEMA_CHECK_I64(...)
+#define SCHEMA_CHECK_STR(...)
+#define SCHEMA_CHECK_FIELD(kind, field, ...) SCHEMA_CHECK_##kind(__VA_ARGS__)
+#define SCHEMA_ENCODE_FIELD(kind, field, ...) p = SCHEMA_PUT_##kind(p, msg->field);
+#define SCHEMA_DECODE_FIELD(kind, field, ...)                                                      \
+	if (!SCHEMA_GET_##kind(p, out.field, ##__VA_ARGS__)) {                                     \
+		return 0;                                                                          \
+	}
+
+/*
+ * Expands one schema into its encoder and decoder. The size check up
+ * front covers every field, so the field code runs without bounds checks.
+ */
+#define SCHEMA_DEFINE(name, type, fields)                                                          \
+	size_t schema_encode_##name(const type *msg, uint8_t *buf, size_t len)                     \
+	{                                                                                          \
+		uint8_t *p = buf;                                                                  \
+                                                                                                   \
+		fields(SCHEMA_CHECK_FIELD);                                                        \
+		if (len < SCHEMA_SIZE(fields)) {                                                   \
+			return 0;                                                                  \
+		}                                                                                  \
+		fields(SCHEMA_ENCODE_FIELD);                                                       \
+		return (size_t)(p - buf);                                                          \
+	}                                                                                          \
+                                                                                                   \
+	size_t schema_decode_##name(const uint8_t *buf, size_t len, type *msg)                     \
+	{                                                                                          \
+		const uint8_t *p = buf;                                                            \
+		type out = {0};                                                                    \
+                                                                                                   \
+		if (len < SCHEMA_SIZE(fields)) {                                                   \
+			return 0;                                                                  \
+		}                                                                                  \
+		fields(SCHEMA_DECODE_FIELD);                                                       \
+		*msg = out;                                                                        \
+		return (size_t)(p - buf);                                                          \
+	}
+
+SCHEMA_DEFINE(sensor_data, sensor_data_t, SCHEMA_SENSOR_DATA)
+SCHEMA_DEFINE(display_data, display_data_t, SCHEMA_DISPLAY_DATA)
+SCHEMA_DEFINE(camera_trigger, camera_trigger_t, SCHEMA_CAMERA_TRIGGER)
+SCHEMA_DEFINE(camera_result, camera_result_t, SCHEMA_CAMERA_RESULT)
+SCHEMA_DEFINE(infraction_record, infraction_record_t, SCHEMA_INFRACTION_RECORD)
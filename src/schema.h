@@ -0,0 +1,65 @@
+#ifndef SCHEMA_H
+#define SCHEMA_H
+
+#include "common.h"
+#include "infraction_log.h"
+
+/*
+ * Wire schemas of the pipeline messages. The field lists next to the
+ * message types (SCHEMA_SENSOR_DATA and friends in common.h,
+ * SCHEMA_INFRACTION_RECORD in infraction_log.h) generate both the structs
+ * and, through schema.c, an encoder and a decoder per message; this header
+ * expands them into the encoded size. The wire format is fixed size,
+ * little-endian and unpadded, fields in list order, so it does not depend
+ * on the compiler or the host:
+ *
+ *   U8, BOOL   1 byte (BOOL is 0 or 1)
+ *   ENUM       1 byte, below the number of values
+ *   U32        4 bytes
+ *   I64        8 bytes
+ *   STR        arg bytes, NUL-terminated, zero after the terminator
+ *
+ * Adding a field to a list adds it to the struct and to the encoding.
+ */
+
+#define SCHEMA_SIZE_U8(...)   1
+#define SCHEMA_SIZE_BOOL(...) 1
+#define SCHEMA_SIZE_ENUM(...) 1
+#define SCHEMA_SIZE_U32(...)  4
+#define SCHEMA_SIZE_I64(...)  8
+#define SCHEMA_SIZE_STR(n)    (n)
+#define SCHEMA_FIELD_SIZE(kind, field, ...) +SCHEMA_SIZE_##kind(__VA_ARGS__)
+
+// Encoded size of a message, a constant expression
+#define SCHEMA_SIZE(fields) (0 fields(SCHEMA_FIELD_SIZE))
+
+#define SCHEMA_SENSOR_DATA_SIZE       SCHEMA_SIZE(SCHEMA_SENSOR_DATA)
+#define SCHEMA_DISPLAY_DATA_SIZE      SCHEMA_SIZE(SCHEMA_DISPLAY_DATA)
+#define SCHEMA_CAMERA_TRIGGER_SIZE    SCHEMA_SIZE(SCHEMA_CAMERA_TRIGGER)
+#define SCHEMA_CAMERA_RESULT_SIZE     SCHEMA_SIZE(SCHEMA_CAMERA_RESULT)
+#define SCHEMA_INFRACTION_RECORD_SIZE SCHEMA_SIZE(SCHEMA_INFRACTION_RECORD)
+
+// Largest encoded message, for buffers that take any of them
+#define SCHEMA_MAX_SIZE                                                                            \
+	MAX(MAX(MAX(SCHEMA_SENSOR_DATA_SIZE, SCHEMA_DISPLAY_DATA_SIZE),                            \
+		MAX(SCHEMA_CAMERA_TRIGGER_SIZE, SCHEMA_CAMERA_RESULT_SIZE)),                       \
+	    SCHEMA_INFRACTION_RECORD_SIZE)
+
+/*
+ * schema_encode_<name>() writes the message and returns its size, or 0 if
+ * the buffer is too small. schema_decode_<name>() returns the bytes read,
+ * or 0 if the input is short or out of range (a BOOL above 1, an ENUM past
+ * its values, a STR without terminator); the message is only written on
+ * success. Neither allocates nor touches more than SCHEMA_<NAME>_SIZE bytes.
+ */
+#define SCHEMA_DECLARE(name, type)                                                                 \
+	size_t schema_encode_##name(const type *msg, uint8_t *buf, size_t len);                    \
+	size_t schema_decode_##name(const uint8_t *buf, size_t len, type *msg)
+
+SCHEMA_DECLARE(sensor_data, sensor_data_t);
+SCHEMA_DECLARE(display_data, display_data_t);
+SCHEMA_DECLARE(camera_trigger, camera_trigger_t);
+SCHEMA_DECLARE(camera_result, camera_result_t);
+SCHEMA_DECLARE(infraction_record, infraction_record_t);
+
+#endif
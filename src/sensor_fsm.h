@@ -1,22 +1,40 @@
 #ifndef SENSOR_FSM_H
 #define SENSOR_FSM_H
 
-#include <zephyr/kernel.h>
+#include "radar_os.h"
 #include "common.h"
+#include "fsm.h"
 
 typedef enum {
-	SENSOR_IDLE,
-	SENSOR_ACTIVE
+	SENSOR_IDLE,     // No vehicle
+	SENSOR_COUNTING, // Start sensor hit, counting axles, waiting for the end sensor
+	SENSOR_TIMED,    // End sensor hit, still counting axles until the timeout
+	SENSOR_STATE_COUNT
 } sensor_state_t;
 
+typedef enum {
+	SENSOR_EV_START,   // Edge on the start sensor (one per axle)
+	SENSOR_EV_END,     // Edge on the end sensor
+	SENSOR_EV_TIMEOUT, // No axle for CONFIG_RADAR_AXLE_TIMEOUT_MS
+	SENSOR_EV_COUNT
+} sensor_event_t;
+
 typedef struct {
 	sensor_state_t state;
 	int64_t start_time;
 	int64_t end_time;
+	uint32_t start_cycles;
+	uint32_t end_cycles;
 	uint32_t axle_count;
-	bool speed_measured;
 } sensor_fsm_t;
 
+// Argument of every event
+typedef struct {
+	int64_t timestamp_ms;
+	uint32_t cycles;    // radar_cycles() at the edge, for sub-millisecond timing
+	sensor_data_t *out; // Filled by the timeout that completes a measurement
+} sensor_fsm_arg_t;
+
 /**
  * Classifies the vehicle type based on the number of axles.
  * @param axle_count The number of axles.
@@ -36,77 +54,142 @@ static inline void sensor_fsm_init(sensor_fsm_t *fsm)
 	fsm->state = SENSOR_IDLE;
 	fsm->start_time = 0;
 	fsm->end_time = 0;
+	fsm->start_cycles = 0;
+	fsm->end_cycles = 0;
 	fsm->axle_count = 0;
-	fsm->speed_measured = false;
 }
 
+// Guard: an end edge only times the vehicle if it comes after the start edge
+static inline bool sensor_fsm_after_start(sensor_fsm_t *fsm, sensor_fsm_arg_t arg)
+{
+	return arg.timestamp_ms > fsm->start_time;
+}
+
+// Action: first axle, opens the measurement window
+static inline bool sensor_fsm_open(sensor_fsm_t *fsm, sensor_fsm_arg_t arg)
+{
+	fsm->start_time = arg.timestamp_ms;
+	fsm->start_cycles = arg.cycles;
+	fsm->end_time = 0;
+	fsm->axle_count = 1;
+	return false;
+}
+
+// Action: one more axle
+static inline bool sensor_fsm_count_axle(sensor_fsm_t *fsm, sensor_fsm_arg_t arg)
+{
+	fsm->axle_count++;
+	return false;
+}
+
+// Action: the vehicle reached the end sensor
+static inline bool sensor_fsm_mark_end(sensor_fsm_t *fsm, sensor_fsm_arg_t arg)
+{
+	fsm->end_time = arg.timestamp_ms;
+	fsm->end_cycles = arg.cycles;
+	return false;
+}
+
+// Action: the window closed without an end edge, nothing to report
+static inline bool sensor_fsm_discard(sensor_fsm_t *fsm, sensor_fsm_arg_t arg)
+{
+	sensor_fsm_init(fsm);
+	return false;
+}
+
+// Action: the window closed after an end edge, report the measurement
+static inline bool sensor_fsm_emit(sensor_fsm_t *fsm, sensor_fsm_arg_t arg)
+{
+	arg.out->timestamp_start = fsm->start_time;
+	arg.out->timestamp_end = fsm->end_time;
+	arg.out->duration_ms = (uint32_t)(fsm->end_time - fsm->start_time);
+	arg.out->end_cycles = fsm->end_cycles;
+	arg.out->duration_us =
+		(uint32_t)((uint64_t)(fsm->end_cycles - fsm->start_cycles) * 1000000u /
+			   radar_cycles_per_sec());
+	arg.out->axle_count = fsm->axle_count;
+	arg.out->type = classify_axles(fsm->axle_count);
+	sensor_fsm_init(fsm);
+	return true;
+}
+
+/*
+ * Light/heavy measurement: the start sensor counts axles for as long as
+ * they keep coming, the first end edge after the start times the vehicle,
+ * and the axle timeout reports it. Pairs without a row are ignored: end
+ * edges without a vehicle, repeated end edges and timeouts when idle.
+ */
+#define SENSOR_FSM_TABLE(X)                                                                        \
+	/* state           event              guard                   action                 next */ \
+	X(SENSOR_IDLE,     SENSOR_EV_START,   FSM_ALWAYS,             sensor_fsm_open,       SENSOR_COUNTING) \
+	X(SENSOR_COUNTING, SENSOR_EV_START,   FSM_ALWAYS,             sensor_fsm_count_axle, SENSOR_COUNTING) \
+	X(SENSOR_COUNTING, SENSOR_EV_END,     sensor_fsm_after_start, sensor_fsm_mark_end,   SENSOR_TIMED)    \
+	X(SENSOR_COUNTING, SENSOR_EV_TIMEOUT, FSM_ALWAYS,             sensor_fsm_discard,    SENSOR_IDLE)     \
+	X(SENSOR_TIMED,    SENSOR_EV_START,   FSM_ALWAYS,             sensor_fsm_count_axle, SENSOR_TIMED)    \
+	X(SENSOR_TIMED,    SENSOR_EV_TIMEOUT, FSM_ALWAYS,             sensor_fsm_emit,       SENSOR_IDLE)
+
+FSM_DISPATCH_DEFINE(sensor_fsm_dispatch, sensor_fsm_t, sensor_fsm_arg_t, SENSOR_EV_COUNT,
+		    SENSOR_FSM_TABLE)
+
 /**
- * Handles the start of a sensor measurement.
+ * Handles an axle on the start sensor.
  * @param fsm Pointer to the sensor FSM.
- * @param timestamp_ms The timestamp of the start of the measurement.
+ * @param timestamp_ms The timestamp of the edge.
  */
 static inline void sensor_fsm_handle_start(sensor_fsm_t *fsm, int64_t timestamp_ms)
 {
-	// If the sensor is idle, set the sensor to active and set the start time, end time, axle count, and speed measured flag
-	if (fsm->state == SENSOR_IDLE) {
-		fsm->state = SENSOR_ACTIVE;
-		fsm->start_time = timestamp_ms;
-		fsm->end_time = 0;
-		fsm->axle_count = 1;
-		fsm->speed_measured = false;
-	} else {
-		fsm->axle_count++;
-	}
+	sensor_fsm_arg_t arg = {.timestamp_ms = timestamp_ms};
+
+	(void)sensor_fsm_dispatch(fsm, SENSOR_EV_START, arg);
 }
 
 /**
- * Handles the end of a sensor measurement.
+ * Handles an edge on the end sensor.
  * @param fsm Pointer to the sensor FSM.
- * @param timestamp_ms The timestamp of the end of the measurement.
+ * @param timestamp_ms The timestamp of the edge.
  */
 static inline void sensor_fsm_handle_end(sensor_fsm_t *fsm, int64_t timestamp_ms)
 {
-	// If the sensor is active and the speed has not been measured, set the end time and the speed measured flag
-	if (fsm->state == SENSOR_ACTIVE && !fsm->speed_measured) {
-		fsm->end_time = timestamp_ms;
-		fsm->speed_measured = true;
-	}
+	sensor_fsm_arg_t arg = {.timestamp_ms = timestamp_ms};
+
+	(void)sensor_fsm_dispatch(fsm, SENSOR_EV_END, arg);
 }
 
 /**
- * Finalizes the sensor measurement.
+ * Handles the edges captured by one interrupt, all with the same timestamp.
+ * The start edge goes first; an end edge with the same timestamp as the
+ * start of the window is no measurement and is ignored.
  * @param fsm Pointer to the sensor FSM.
- * @param out_data Pointer to the sensor data.
- * @return True if the measurement was finalized, false otherwise.
+ * @param start True if the start sensor had an edge.
+ * @param end True if the end sensor had an edge.
+ * @param timestamp_ms The timestamp of the edges.
+ * @param cycles radar_cycles() at the edges.
  */
-static inline bool sensor_fsm_finalize(sensor_fsm_t *fsm, sensor_data_t *out_data)
+static inline void sensor_fsm_handle_edges(sensor_fsm_t *fsm, bool start, bool end,
+					   int64_t timestamp_ms, uint32_t cycles)
 {
+	sensor_fsm_arg_t arg = {.timestamp_ms = timestamp_ms, .cycles = cycles};
 
-	if (fsm->state != SENSOR_ACTIVE) {
-		return false;
+	if (start) {
+		(void)sensor_fsm_dispatch(fsm, SENSOR_EV_START, arg);
 	}
-
-	bool produced = false;
-	// If the speed has been measured and the end time is greater than the start time, 
-	// set the sensor data
-	if (fsm->speed_measured && fsm->end_time > fsm->start_time) {
-		out_data->timestamp_start = fsm->start_time;
-		out_data->timestamp_end = fsm->end_time;
-		out_data->duration_ms = (uint32_t)(fsm->end_time - fsm->start_time);
-		out_data->axle_count = fsm->axle_count;
-		out_data->type = classify_axles(fsm->axle_count);
-		produced = true;
+	if (end) {
+		(void)sensor_fsm_dispatch(fsm, SENSOR_EV_END, arg);
 	}
-
-	/* Reset to idle regardless, end of measurement window */
-	fsm->state = SENSOR_IDLE;
-	fsm->start_time = 0;
-	fsm->end_time = 0;
-	fsm->axle_count = 0;
-	fsm->speed_measured = false;
-	return produced;
 }
 
-#endif
+/**
+ * Closes the measurement window on the axle timeout. The FSM is idle
+ * afterwards either way.
+ * @param fsm Pointer to the sensor FSM.
+ * @param out_data Pointer to the sensor data.
+ * @return True if the window held a complete measurement, false otherwise.
+ */
+static inline bool sensor_fsm_finalize(sensor_fsm_t *fsm, sensor_data_t *out_data)
+{
+	sensor_fsm_arg_t arg = {.out = out_data};
 
+	return sensor_fsm_dispatch(fsm, SENSOR_EV_TIMEOUT, arg);
+}
 
+#endif
@@ -3,8 +3,11 @@
 #include <zephyr/logging/log.h>
 #include "common.h"
 #include "sensor_fsm.h"
+#include "telemetry.h"
+#include "flight_recorder.h"
+#include "wim_channel.h"
 
-LOG_MODULE_REGISTER(sensor_thread, LOG_LEVEL_INF);
+LOG_MODULE_REGISTER(sensor_thread, CONFIG_RADAR_LOG_LEVEL);
 
 // Get GPIOs from aliases
 static const struct gpio_dt_spec sensor_start_spec = GPIO_DT_SPEC_GET(DT_ALIAS(sensor0), gpios);
@@ -22,61 +25,75 @@ static struct k_timer axle_timer;
  */
 static void axle_timer_expiry(struct k_timer *timer_id);
 
-// GPIO Callbacks
-static struct gpio_callback start_cb_data;
-static struct gpio_callback end_cb_data;
+// One callback for both sensors, so edges seen together share a timestamp
+BUILD_ASSERT(DT_SAME_NODE(DT_GPIO_CTLR(DT_ALIAS(sensor0), gpios), DT_GPIO_CTLR(DT_ALIAS(sensor1), gpios)),
+             "Both sensors must be on the same GPIO port");
+static struct gpio_callback sensor_cb_data;
 
 /**
- * Start interrupt service routine for the sensor.
+ * Interrupt service routine for both sensors. Reads the pending pins once,
+ * takes one timestamp and one lock, and feeds the edges to the FSM start
+ * first. The cycle counter is read first, so the edge time used for the
+ * camera trigger has cycle rather than millisecond resolution.
  * @param dev Pointer to the device.
  * @param cb Pointer to the callback.
  * @param pins Pins that triggered the interrupt.
  */
-static void start_isr(const struct device *dev, struct gpio_callback *cb, uint32_t pins) {
+RADAR_HOT static void sensor_isr(const struct device *dev, struct gpio_callback *cb, uint32_t pins) {
+    uint32_t cycles = k_cycle_get_32();
     int64_t now = k_uptime_get();
-    k_spinlock_key_t key = k_spin_lock(&fsm_lock);
-    sensor_fsm_handle_start(&fsm, now);
-    k_spin_unlock(&fsm_lock, key);
-    // Start or refresh timeout timer (configurable)
-    k_timer_start(&axle_timer, K_MSEC(CONFIG_RADAR_AXLE_TIMEOUT_MS), K_NO_WAIT);
-}
+    bool start = (pins & BIT(sensor_start_spec.pin)) != 0;
+    bool end = (pins & BIT(sensor_end_spec.pin)) != 0;
 
-/**
- * End interrupt service routine for the sensor.
- * @param dev Pointer to the device.
- * @param cb Pointer to the callback.
- * @param pins Pins that triggered the interrupt.
- */
-static void end_isr(const struct device *dev, struct gpio_callback *cb, uint32_t pins) {
-    int64_t now = k_uptime_get();
+    if (start) {
+        FLIGHT_RECORD(FLIGHT_EV_EDGE_START, 0, 0);
+    }
+    if (end) {
+        FLIGHT_RECORD(FLIGHT_EV_EDGE_END, 0, 0);
+    }
+    telemetry_inc(TELEMETRY_WAKEUP);
     k_spinlock_key_t key = k_spin_lock(&fsm_lock);
-    sensor_fsm_handle_end(&fsm, now);
+    sensor_fsm_handle_edges(&fsm, start, end, now, cycles);
     k_spin_unlock(&fsm_lock, key);
+    if (start) {
+        // The strip sits at the start sensor: weigh this axle
+        wim_channel_arm();
+        // Start or refresh timeout timer (configurable)
+        k_timer_start(&axle_timer, K_MSEC(CONFIG_RADAR_AXLE_TIMEOUT_MS), K_NO_WAIT);
+    }
 }
 
 /**
  * Timer expiry callback for the axle counting timeout.
  * @param timer_id Pointer to the timer.
  */
-static void axle_timer_expiry(struct k_timer *timer_id) {
+RADAR_HOT static void axle_timer_expiry(struct k_timer *timer_id) {
     // Timeout reached, check if we can finalize a measurement
-    sensor_data_t data;
+    telemetry_inc(TELEMETRY_WAKEUP);
+    sensor_data_t data = {0};
     bool produced = false;
     k_spinlock_key_t key = k_spin_lock(&fsm_lock);
     produced = sensor_fsm_finalize(&fsm, &data);
     k_spin_unlock(&fsm_lock, key);
 
     if (produced) {
+        // The strip sits at the start sensor: every axle has crossed it by now
+        data.gross_weight_kg = wim_channel_take(&data);
+        FLIGHT_RECORD(FLIGHT_EV_FINALIZE, data.axle_count, data.duration_ms);
         LOG_INF("Vehicle Detected: Axles=%d, Time=%d ms, Type=%s", 
                 data.axle_count, data.duration_ms, 
                 data.type == VEHICLE_LIGHT ? "Light" : "Heavy");
+        telemetry_inc(TELEMETRY_MEASUREMENT);
         int ret = k_msgq_put(&sensor_msgq, &data, K_NO_WAIT);
         if (ret != 0) {
             /* Drop oldest and retry once */
+            telemetry_inc(TELEMETRY_SENSOR_DROPPED);
+            FLIGHT_RECORD(FLIGHT_EV_DROP, 0, 0);
             sensor_data_t dropped;
             (void)k_msgq_get(&sensor_msgq, &dropped, K_NO_WAIT);
             ret = k_msgq_put(&sensor_msgq, &data, K_NO_WAIT);
             if (ret != 0) {
+                telemetry_inc(TELEMETRY_SENSOR_DROPPED);
                 LOG_WRN("sensor_msgq full, dropping measurement");
             }
         }
@@ -136,17 +153,14 @@ void sensor_thread_entry(void *p1, void *p2, void *p3) {
         return;
     }
 
-    // Initialize the start callback
-    gpio_init_callback(&start_cb_data, start_isr, BIT(sensor_start_spec.pin));
-    gpio_add_callback(sensor_start_spec.port, &start_cb_data);
-
-    // Initialize the end callback
-    gpio_init_callback(&end_cb_data, end_isr, BIT(sensor_end_spec.pin));
-    gpio_add_callback(sensor_end_spec.port, &end_cb_data);
-    
+    // The timer must exist before the first edge can start it
     k_timer_init(&axle_timer, axle_timer_expiry, NULL);
 
-    // Initialize the axle timer
+    // Initialize the port callback for both sensors
+    gpio_init_callback(&sensor_cb_data, sensor_isr,
+                       BIT(sensor_start_spec.pin) | BIT(sensor_end_spec.pin));
+    gpio_add_callback(sensor_start_spec.port, &sensor_cb_data);
+
     LOG_INF("Sensor Thread Initialized");
 
     // Keep thread alive
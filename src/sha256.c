@@ -0,0 +1,172 @@
+#include "sha256.h"
+#include <string.h>
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+	0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+	0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+	0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+	0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+	0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+	0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+	0xc67178f2,
+};
+
+static inline uint32_t rotr32(uint32_t x, unsigned int n)
+{
+	return (x >> n) | (x << (32 - n));
+}
+
+/**
+ * Compresses one 64-byte block into the hash state.
+ * @param state The eight working hash words.
+ * @param block The block to compress.
+ */
+static void sha256_compress(uint32_t state[8], const uint8_t block[SHA256_BLOCK_SIZE])
+{
+	uint32_t w[64];
+
+	for (int i = 0; i < 16; i++) {
+		w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16) |
+		       ((uint32_t)block[4 * i + 2] << 8) | (uint32_t)block[4 * i + 3];
+	}
+	for (int i = 16; i < 64; i++) {
+		uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+		uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+		w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+	}
+
+	uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+	uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+	for (int i = 0; i < 64; i++) {
+		uint32_t s1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+		uint32_t ch = (e & f) ^ (~e & g);
+		uint32_t t1 = h + s1 + ch + sha256_k[i] + w[i];
+		uint32_t s0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+		uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+		uint32_t t2 = s0 + maj;
+
+		h = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
+}
+
+/**
+ * Initializes a SHA-256 context.
+ * @param ctx Pointer to the context.
+ */
+void sha256_init(sha256_ctx_t *ctx)
+{
+	static const uint32_t iv[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+		0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+	};
+
+	memcpy(ctx->state, iv, sizeof(iv));
+	ctx->length = 0;
+	ctx->block_len = 0;
+}
+
+/**
+ * Feeds data into a SHA-256 context.
+ * @param ctx Pointer to the context.
+ * @param data The data to hash.
+ * @param len The number of bytes in data.
+ */
+void sha256_update(sha256_ctx_t *ctx, const void *data, size_t len)
+{
+	const uint8_t *p = data;
+
+	ctx->length += len;
+
+	// Top up a partially filled block first
+	if (ctx->block_len > 0) {
+		size_t take = SHA256_BLOCK_SIZE - ctx->block_len;
+		if (take > len) {
+			take = len;
+		}
+		memcpy(&ctx->block[ctx->block_len], p, take);
+		ctx->block_len += take;
+		p += take;
+		len -= take;
+		if (ctx->block_len < SHA256_BLOCK_SIZE) {
+			return;
+		}
+		sha256_compress(ctx->state, ctx->block);
+		ctx->block_len = 0;
+	}
+
+	// Whole blocks straight from the input
+	while (len >= SHA256_BLOCK_SIZE) {
+		sha256_compress(ctx->state, p);
+		p += SHA256_BLOCK_SIZE;
+		len -= SHA256_BLOCK_SIZE;
+	}
+
+	if (len > 0) {
+		memcpy(ctx->block, p, len);
+		ctx->block_len = len;
+	}
+}
+
+/**
+ * Finishes the hash and writes the digest.
+ * @param ctx Pointer to the context.
+ * @param digest Output buffer of SHA256_DIGEST_SIZE bytes.
+ */
+void sha256_final(sha256_ctx_t *ctx, uint8_t digest[SHA256_DIGEST_SIZE])
+{
+	uint64_t bit_len = ctx->length * 8;
+
+	ctx->block[ctx->block_len++] = 0x80;
+	if (ctx->block_len > SHA256_BLOCK_SIZE - 8) {
+		memset(&ctx->block[ctx->block_len], 0, SHA256_BLOCK_SIZE - ctx->block_len);
+		sha256_compress(ctx->state, ctx->block);
+		ctx->block_len = 0;
+	}
+	memset(&ctx->block[ctx->block_len], 0, SHA256_BLOCK_SIZE - 8 - ctx->block_len);
+	for (int i = 0; i < 8; i++) {
+		ctx->block[SHA256_BLOCK_SIZE - 1 - i] = (uint8_t)(bit_len >> (8 * i));
+	}
+	sha256_compress(ctx->state, ctx->block);
+
+	for (int i = 0; i < 8; i++) {
+		digest[4 * i] = (uint8_t)(ctx->state[i] >> 24);
+		digest[4 * i + 1] = (uint8_t)(ctx->state[i] >> 16);
+		digest[4 * i + 2] = (uint8_t)(ctx->state[i] >> 8);
+		digest[4 * i + 3] = (uint8_t)ctx->state[i];
+	}
+}
+
+/**
+ * Hashes a buffer in one call.
+ * @param data The data to hash.
+ * @param len The number of bytes in data.
+ * @param digest Output buffer of SHA256_DIGEST_SIZE bytes.
+ */
+void sha256(const void *data, size_t len, uint8_t digest[SHA256_DIGEST_SIZE])
+{
+	sha256_ctx_t ctx;
+
+	sha256_init(&ctx);
+	sha256_update(&ctx, data, len);
+	sha256_final(&ctx, digest);
+}
@@ -0,0 +1,46 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_DIGEST_SIZE 32
+#define SHA256_BLOCK_SIZE  64
+
+typedef struct {
+	uint32_t state[8];
+	uint64_t length;
+	uint8_t block[SHA256_BLOCK_SIZE];
+	size_t block_len;
+} sha256_ctx_t;
+
+/**
+ * Initializes a SHA-256 context.
+ * @param ctx Pointer to the context.
+ */
+void sha256_init(sha256_ctx_t *ctx);
+
+/**
+ * Feeds data into a SHA-256 context.
+ * @param ctx Pointer to the context.
+ * @param data The data to hash.
+ * @param len The number of bytes in data.
+ */
+void sha256_update(sha256_ctx_t *ctx, const void *data, size_t len);
+
+/**
+ * Finishes the hash and writes the digest.
+ * @param ctx Pointer to the context.
+ * @param digest Output buffer of SHA256_DIGEST_SIZE bytes.
+ */
+void sha256_final(sha256_ctx_t *ctx, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+/**
+ * Hashes a buffer in one call.
+ * @param data The data to hash.
+ * @param len The number of bytes in data.
+ * @param digest Output buffer of SHA256_DIGEST_SIZE bytes.
+ */
+void sha256(const void *data, size_t len, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+#endif
@@ -0,0 +1,280 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include "console_ring.h"
+#include "display_fanout.h"
+#include "evidence_stage.h"
+#include "infraction_log.h"
+#include "telemetry.h"
+#include "wim_channel.h"
+
+LOG_MODULE_REGISTER(telemetry, CONFIG_RADAR_LOG_LEVEL);
+
+radar_atomic_t telemetry_counters[TELEMETRY_COUNTER_COUNT];
+histogram_t telemetry_histograms[TELEMETRY_HIST_COUNT];
+radar_atomic_t telemetry_mode_cycles[TELEMETRY_MODE_COUNT];
+radar_atomic_t telemetry_mode_vehicles[TELEMETRY_MODE_COUNT];
+
+const char *const telemetry_histogram_names[TELEMETRY_HIST_COUNT] = {
+	[TELEMETRY_HIST_QUEUE_WAIT] = "queue_wait",
+	[TELEMETRY_HIST_CAMERA_RTT] = "camera_rtt",
+#if IS_ENABLED(CONFIG_RADAR_CAMERA_TRIGGER_PULSE)
+	[TELEMETRY_HIST_TRIGGER_ERROR] = "trigger_error",
+#endif
+};
+
+const char *const telemetry_histogram_units[TELEMETRY_HIST_COUNT] = {
+	[TELEMETRY_HIST_QUEUE_WAIT] = "ms",
+	[TELEMETRY_HIST_CAMERA_RTT] = "ms",
+#if IS_ENABLED(CONFIG_RADAR_CAMERA_TRIGGER_PULSE)
+	[TELEMETRY_HIST_TRIGGER_ERROR] = "us",
+#endif
+};
+
+K_SEM_DEFINE(telemetry_changed, 0, 1);
+
+// Snapshots are ~1 KiB each, too big for the thread stacks
+static histogram_snapshot_t telemetry_snap;
+static uint8_t telemetry_dump[HISTOGRAM_DUMP_MAX];
+
+/**
+ * Wakes the telemetry thread to report changed counters. The report is
+ * rate limited to one per CONFIG_RADAR_TELEMETRY_INTERVAL_MS.
+ */
+void telemetry_notify(void)
+{
+	k_sem_give(&telemetry_changed);
+}
+
+/**
+ * Logs percentiles of every non-empty histogram and their binary dumps.
+ */
+static void telemetry_log_histograms(void)
+{
+	for (int i = 0; i < TELEMETRY_HIST_COUNT; i++) {
+		histogram_snapshot(&telemetry_histograms[i], &telemetry_snap);
+		if (telemetry_snap.total == 0) {
+			continue;
+		}
+		size_t len = histogram_encode(&telemetry_snap, telemetry_dump, sizeof(telemetry_dump));
+
+		LOG_INF("Latency %s: n=%u p50=%u p90=%u p99=%u max=%u %s",
+			telemetry_histogram_names[i], telemetry_snap.total,
+			histogram_percentile(&telemetry_snap, 5000),
+			histogram_percentile(&telemetry_snap, 9000),
+			histogram_percentile(&telemetry_snap, 9900), histogram_max(&telemetry_snap),
+			telemetry_histogram_units[i]);
+		LOG_HEXDUMP_DBG(telemetry_dump, len, telemetry_histogram_names[i]);
+	}
+}
+
+/**
+ * Logs pipeline wakeups per second and, with CONFIG_RADAR_IDLE_STATS, the
+ * share of CPU time spent idle since the previous report.
+ * @param changed True if the report was triggered by a change, false for a heartbeat.
+ */
+static void telemetry_log_power(bool changed)
+{
+	static int64_t last_ms;
+	static uint32_t last_wakeups;
+	int64_t now_ms = k_uptime_get();
+	uint32_t wakeups = telemetry_get(TELEMETRY_WAKEUP);
+	uint32_t elapsed_ms = (uint32_t)MAX(now_ms - last_ms, 1);
+	uint32_t per_s_x100 = (uint32_t)(((uint64_t)(wakeups - last_wakeups) * 100000u) / elapsed_ms);
+	uint32_t idle_x10 = 0;
+
+#if IS_ENABLED(CONFIG_RADAR_IDLE_STATS)
+	static k_thread_runtime_stats_t last_stats;
+	k_thread_runtime_stats_t stats;
+
+	if (k_thread_runtime_stats_all_get(&stats) == 0) {
+		uint64_t total = stats.execution_cycles - last_stats.execution_cycles;
+		uint64_t idle = stats.idle_cycles - last_stats.idle_cycles;
+
+		idle_x10 = total > 0 ? (uint32_t)((idle * 1000u) / total) : 0;
+		last_stats = stats;
+	}
+#endif
+	LOG_INF("Power (%s): wakeups=%u.%02u/s idle=%u.%u%%", changed ? "change" : "heartbeat",
+		per_s_x100 / 100, per_s_x100 % 100, idle_x10 / 10, idle_x10 % 10);
+	last_ms = now_ms;
+	last_wakeups = wakeups;
+}
+
+/**
+ * Logs the CPU cycles per vehicle of each processing mode since the
+ * previous report: control thread plus display sink work.
+ */
+static void telemetry_log_cost(void)
+{
+	static const char *const names[TELEMETRY_MODE_COUNT] = {"normal", "congested"};
+	static uint32_t last_cycles[TELEMETRY_MODE_COUNT];
+	static uint32_t last_vehicles[TELEMETRY_MODE_COUNT];
+
+	for (int i = 0; i < TELEMETRY_MODE_COUNT; i++) {
+		uint32_t cycles = (uint32_t)radar_atomic_get(&telemetry_mode_cycles[i]);
+		uint32_t vehicles = (uint32_t)radar_atomic_get(&telemetry_mode_vehicles[i]);
+		uint32_t n = vehicles - last_vehicles[i];
+
+		if (n > 0) {
+			uint32_t per_vehicle = (cycles - last_cycles[i]) / n;
+
+			LOG_INF("CPU/vehicle (%s): %u cycles, %u us (n=%u)", names[i], per_vehicle,
+				k_cyc_to_us_floor32(per_vehicle), n);
+		}
+		last_cycles[i] = cycles;
+		last_vehicles[i] = vehicles;
+	}
+}
+
+/**
+ * Main entry point for the telemetry thread.
+ * @param p1 Pointer to the telemetry thread data.
+ * @param p2 Pointer to the telemetry thread data.
+ * @param p3 Pointer to the telemetry thread data.
+ */
+static void telemetry_thread_entry(void *p1, void *p2, void *p3)
+{
+	while (1) {
+		// Block until something changed, or until the heartbeat is due
+		bool changed = k_sem_take(&telemetry_changed, K_MSEC(CONFIG_RADAR_TELEMETRY_HEARTBEAT_MS)) == 0;
+		telemetry_inc(TELEMETRY_WAKEUP);
+
+		// Get the telemetry counters
+		uint32_t light = telemetry_get(TELEMETRY_VEHICLE_LIGHT);
+		uint32_t heavy = telemetry_get(TELEMETRY_VEHICLE_HEAVY);
+		uint32_t normal = telemetry_get(TELEMETRY_STATUS_NORMAL);
+		uint32_t warn = telemetry_get(TELEMETRY_STATUS_WARNING);
+		uint32_t infr = telemetry_get(TELEMETRY_STATUS_INFRACTION);
+		uint32_t inf_light = 0, inf_heavy = 0, valid_reads = 0, invalid_reads = 0;
+		infraction_log_get_counters(&inf_light, &inf_heavy, &valid_reads, &invalid_reads);
+		uint32_t dup_vehicles = telemetry_get(TELEMETRY_DEDUP_VEHICLE);
+		uint32_t dup_plates = telemetry_get(TELEMETRY_DEDUP_PLATE);
+		LOG_INF("Telemetry: Vehicles [Leve=%u, Pesado=%u] | Status [Normal=%u, Alerta=%u, Infracao=%u] | Camera [Validas=%u, Invalidas=%u] | Duplicados [Medicoes=%u, Placas=%u]",
+			light, heavy, normal, warn, infr, valid_reads, invalid_reads, dup_vehicles, dup_plates);
+		uint32_t sensor_drops = telemetry_get(TELEMETRY_SENSOR_DROPPED);
+		uint32_t display_drops = telemetry_get(TELEMETRY_DISPLAY_DROPPED);
+		uint32_t log_lost = infraction_log_get_lost();
+		if (sensor_drops > 0 || display_drops > 0 || log_lost > 0) {
+			LOG_WRN("Telemetry: Descartes [Sensor=%u, Display=%u, Log=%u]", sensor_drops,
+				display_drops, log_lost);
+		}
+#if IS_ENABLED(CONFIG_RADAR_INFRACTION_CHAIN)
+		infraction_chain_stats_t chain;
+		infraction_checkpoint_t head;
+		infraction_log_get_chain_stats(&chain);
+		if (chain.hash_cycles > 0 && infraction_log_get_chain_head(&head)) {
+			uint32_t per_record = (uint32_t)(chain.hash_cycles / chain.hashed);
+			uint32_t kib_s = (uint32_t)((chain.hashed_bytes * sys_clock_hw_cycles_per_sec()) /
+						    (chain.hash_cycles * 1024));
+			LOG_INF("Chain: head seq=%u %02x%02x%02x%02x.. | hashed=%u gaps=%u | %u cycles/record, %u KiB/s",
+				head.seq, head.digest[0], head.digest[1], head.digest[2], head.digest[3],
+				chain.hashed, chain.gaps, per_record, kib_s);
+		}
+#endif
+		LOG_INF("Camera: triggers=%u results=%u | bursts=%u escaped=%u",
+			telemetry_get(TELEMETRY_CAMERA_TRIGGER), telemetry_get(TELEMETRY_CAMERA_RESULT),
+			telemetry_get(TELEMETRY_CAMERA_BURST), telemetry_get(TELEMETRY_CAMERA_ESCAPED));
+#if IS_ENABLED(CONFIG_RADAR_CAMERA_TRIGGER_PULSE)
+		LOG_INF("Trigger: pulses=%u late=%u busy=%u", telemetry_get(TELEMETRY_TRIGGER_PULSE),
+			telemetry_get(TELEMETRY_TRIGGER_LATE), telemetry_get(TELEMETRY_TRIGGER_BUSY));
+#endif
+#if IS_ENABLED(CONFIG_RADAR_WIM)
+		wim_channel_stats_t wim;
+		wim_channel_get_stats(&wim);
+		if (wim.samples > 0) {
+			LOG_INF("WIM: weighed=%u overweight=%u | %u cycles/sample, %u cycles/vehicle | blocks=%u",
+				wim.vehicles, telemetry_get(TELEMETRY_OVERWEIGHT), wim.cycles / wim.samples,
+				wim.vehicles > 0 ? wim.cycles / wim.vehicles : 0, wim.blocks);
+		}
+#endif
+#if IS_ENABLED(CONFIG_RADAR_EVIDENCE)
+		evidence_stats_t evidence;
+		evidence_get_stats(&evidence);
+		if (evidence.frames > 0) {
+			uint32_t ratio_x10 = (uint32_t)(evidence.raw_bytes * 10 / evidence.jpeg_bytes);
+
+			LOG_INF("Evidence: frames=%u retried=%u dropped=%u evicted=%u | %u.%u:1, %u us/frame | peak %u KiB",
+				evidence.frames, evidence.retried, evidence.dropped, evidence.evicted,
+				ratio_x10 / 10, ratio_x10 % 10,
+				k_cyc_to_us_floor32((uint32_t)(evidence.cycles / evidence.frames)),
+				(uint32_t)(evidence_peak_ram(&evidence) / 1024));
+		}
+#endif
+		telemetry_log_histograms();
+		telemetry_log_cost();
+		display_fanout_log_stats();
+#if IS_ENABLED(CONFIG_RADAR_CONSOLE_RING)
+		console_ring_stats_t console;
+		console_ring_get_stats(&console);
+		LOG_INF("Console: written=%u dropped=%u bytes | peak %u/%u bytes | tx_irqs=%u",
+			console.written, console.dropped, console.peak_used,
+			CONFIG_RADAR_CONSOLE_RING_SIZE, console.tx_irqs);
+#endif
+		telemetry_log_power(changed);
+
+		if (changed) {
+			// Fold further changes inside the interval into the next report
+			k_msleep(CONFIG_RADAR_TELEMETRY_INTERVAL_MS);
+			telemetry_inc(TELEMETRY_WAKEUP);
+		}
+	}
+}
+
+K_THREAD_DEFINE(telemetry_tid, CONFIG_RADAR_TELEMETRY_STACK_SIZE, telemetry_thread_entry, NULL, NULL, NULL, 8, 0, 0);
+
+#if IS_ENABLED(CONFIG_RADAR_HISTOGRAM_SHELL)
+
+static histogram_snapshot_t shell_snap;
+static uint8_t shell_dump[HISTOGRAM_DUMP_MAX];
+
+/**
+ * Shell handler printing every histogram with its binary dump.
+ * @param sh Pointer to the shell.
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ * @return 0 on success.
+ */
+static int cmd_radar_hist(const struct shell *sh, size_t argc, char **argv)
+{
+	for (int i = 0; i < TELEMETRY_HIST_COUNT; i++) {
+		histogram_snapshot(&telemetry_histograms[i], &shell_snap);
+		size_t len = histogram_encode(&shell_snap, shell_dump, sizeof(shell_dump));
+
+		shell_print(sh, "%s: n=%u p50=%u p90=%u p99=%u p99.9=%u max=%u %s", telemetry_histogram_names[i],
+			    shell_snap.total, histogram_percentile(&shell_snap, 5000),
+			    histogram_percentile(&shell_snap, 9000), histogram_percentile(&shell_snap, 9900),
+			    histogram_percentile(&shell_snap, 9990), histogram_max(&shell_snap),
+			    telemetry_histogram_units[i]);
+		shell_hexdump(sh, shell_dump, len);
+	}
+	return 0;
+}
+
+/**
+ * Shell handler clearing every histogram.
+ * @param sh Pointer to the shell.
+ * @param argc Number of arguments.
+ * @param argv Arguments.
+ * @return 0 on success.
+ */
+static int cmd_radar_hist_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	for (int i = 0; i < TELEMETRY_HIST_COUNT; i++) {
+		histogram_reset(&telemetry_histograms[i]);
+	}
+	shell_print(sh, "Histograms cleared");
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_radar_hist,
+	SHELL_CMD(reset, NULL, "Clear all histograms", cmd_radar_hist_reset),
+	SHELL_SUBCMD_SET_END);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_radar,
+	SHELL_CMD(hist, &sub_radar_hist, "Latency histograms with binary dumps", cmd_radar_hist),
+	SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(radar, &sub_radar, "Radar commands", NULL);
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "radar_os.h"
+#include "histogram.h"
+
+// Pipeline counters, updated lock-free from any thread or ISR
+typedef enum {
+	TELEMETRY_MEASUREMENT,
+	TELEMETRY_VEHICLE_LIGHT,
+	TELEMETRY_VEHICLE_HEAVY,
+	TELEMETRY_STATUS_NORMAL,
+	TELEMETRY_STATUS_WARNING,
+	TELEMETRY_STATUS_INFRACTION,
+	TELEMETRY_DEDUP_VEHICLE,
+	TELEMETRY_DEDUP_PLATE,
+	TELEMETRY_CAMERA_TRIGGER,
+	TELEMETRY_CAMERA_RESULT,
+	TELEMETRY_SENSOR_DROPPED,
+	TELEMETRY_DISPLAY_DROPPED,
+	TELEMETRY_WAKEUP, // Returns from a blocking wait in a pipeline thread or ISR entries
+	TELEMETRY_TRIGGER_PULSE, // Hardware camera trigger pulses fired
+	TELEMETRY_TRIGGER_LATE,  // Predicted focal point time already past when armed
+	TELEMETRY_TRIGGER_BUSY,  // Infractions while the previous pulse was still pending
+	TELEMETRY_OVERWEIGHT,    // Vehicles over the gross weight limit of their type
+	TELEMETRY_CAMERA_BURST,  // Camera bursts that captured more than one vehicle of a platoon
+	TELEMETRY_CAMERA_ESCAPED, // Vehicles that left the view before the camera started recording
+	TELEMETRY_COUNTER_COUNT
+} telemetry_counter_t;
+
+extern radar_atomic_t telemetry_counters[TELEMETRY_COUNTER_COUNT];
+
+// Latency distributions, in the unit of telemetry_histogram_units[]
+typedef enum {
+	TELEMETRY_HIST_QUEUE_WAIT,    // Measurement complete until the control thread takes it (ms)
+	TELEMETRY_HIST_CAMERA_RTT,    // Camera trigger until its result arrives (ms)
+#if IS_ENABLED(CONFIG_RADAR_CAMERA_TRIGGER_PULSE)
+	TELEMETRY_HIST_TRIGGER_ERROR, // Trigger pulse edge after the predicted focal point time (us)
+#endif
+	TELEMETRY_HIST_COUNT
+} telemetry_histogram_t;
+
+extern histogram_t telemetry_histograms[TELEMETRY_HIST_COUNT];
+
+// Processing modes, for the CPU cost per vehicle of each
+typedef enum {
+	TELEMETRY_MODE_NORMAL,
+	TELEMETRY_MODE_CONGESTED,
+	TELEMETRY_MODE_COUNT
+} telemetry_mode_t;
+
+extern radar_atomic_t telemetry_mode_cycles[TELEMETRY_MODE_COUNT];
+extern radar_atomic_t telemetry_mode_vehicles[TELEMETRY_MODE_COUNT];
+extern const char *const telemetry_histogram_names[TELEMETRY_HIST_COUNT];
+extern const char *const telemetry_histogram_units[TELEMETRY_HIST_COUNT];
+
+/**
+ * Increments a telemetry counter.
+ * @param counter The counter to increment.
+ */
+static inline void telemetry_inc(telemetry_counter_t counter)
+{
+	(void)radar_atomic_inc(&telemetry_counters[counter]);
+}
+
+/**
+ * Reads a telemetry counter.
+ * @param counter The counter to read.
+ * @return The current value, wrapping at 2^32.
+ */
+static inline uint32_t telemetry_get(telemetry_counter_t counter)
+{
+	return (uint32_t)radar_atomic_get(&telemetry_counters[counter]);
+}
+
+/**
+ * Charges CPU cycles to a processing mode. Sums wrap at 2^32; readers use
+ * differences between reports.
+ * @param mode The mode the work was done in.
+ * @param cycles The cycles spent.
+ * @param vehicles The number of vehicles the work covered.
+ */
+static inline void telemetry_add_cycles(telemetry_mode_t mode, uint32_t cycles, uint32_t vehicles)
+{
+	(void)radar_atomic_add(&telemetry_mode_cycles[mode], cycles);
+	(void)radar_atomic_add(&telemetry_mode_vehicles[mode], vehicles);
+}
+
+void telemetry_notify(void);
+
+/**
+ * Records a sample into a telemetry histogram. Safe from ISR context.
+ * @param hist The histogram to record into.
+ * @param value The sample.
+ */
+static inline void telemetry_record(telemetry_histogram_t hist, uint32_t value)
+{
+	histogram_record(&telemetry_histograms[hist], value);
+}
+
+#endif
@@ -1,8 +1,9 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/random/random.h>
 
-LOG_MODULE_REGISTER(traffic_sim, LOG_LEVEL_INF);
+LOG_MODULE_REGISTER(traffic_sim, CONFIG_RADAR_LOG_LEVEL);
 
 // Get GPIOs (same as sensor thread, but we will try to configure them to trigger logic or just logs)
 // NOTE: On real hardware, we can't drive an INPUT pin high internally without loopback.
@@ -18,6 +19,47 @@ LOG_MODULE_REGISTER(traffic_sim, LOG_LEVEL_INF);
 // This verifies Main Logic, Classification, Display, and Camera.
 
 #include "common.h"
+#include "telemetry.h"
+#include "flight_recorder.h"
+#include "wim_channel.h"
+#if IS_ENABLED(CONFIG_RADAR_TRAFFIC_SIM_DATASET)
+#include "cmdline.h"
+#include "posix_board_if.h"
+#include "soc.h"
+#include "dataset.h"
+#include "dataset_native.h"
+#endif
+
+/**
+ * Drives a simulated vehicle over the weigh-in-motion strip and waits until
+ * it reached the end sensor and its last axle has been sampled, as the axle
+ * timeout would for real edges. Call it before the vehicle arrives.
+ * @param s_data Pointer to the measurement; gets the weight the strip reports.
+ * @param gross_weight_kg The actual weight of the vehicle.
+ */
+static void traffic_sim_weigh(sensor_data_t *s_data, uint32_t gross_weight_kg) {
+#if IS_ENABLED(CONFIG_RADAR_WIM)
+    int64_t weighed_ms = wim_channel_simulate(s_data, gross_weight_kg);
+
+    k_sleep(K_TIMEOUT_ABS_MS(MAX(weighed_ms, s_data->timestamp_end)));
+    s_data->gross_weight_kg = wim_channel_take(s_data);
+#endif
+}
+
+/**
+ * Injects one simulated measurement as if the sensor thread produced it.
+ * @param s_data Pointer to the measurement.
+ */
+static void traffic_sim_inject(const sensor_data_t *s_data) {
+    telemetry_inc(TELEMETRY_MEASUREMENT);
+    FLIGHT_RECORD(FLIGHT_EV_FINALIZE, s_data->axle_count, s_data->duration_ms);
+    if (k_msgq_put(&sensor_msgq, s_data, K_NO_WAIT) != 0) {
+        telemetry_inc(TELEMETRY_SENSOR_DROPPED);
+        FLIGHT_RECORD(FLIGHT_EV_DROP, 0, 0);
+    }
+}
+
+#if IS_ENABLED(CONFIG_RADAR_TRAFFIC_SIM_DEMO)
 
 void traffic_sim_thread_entry(void *p1, void *p2, void *p3) {
     LOG_INF("Traffic Simulator Started (Auto-generating vehicles every 5s)");
@@ -25,7 +67,7 @@ void traffic_sim_thread_entry(void *p1, void *p2, void *p3) {
     k_sleep(K_SECONDS(2)); // Wait for system to settle
 
     while (1) {
-        sensor_data_t s_data;
+        sensor_data_t s_data = {0};
 
         // 1. Simulate a Light Vehicle (Normal Speed)
         // Distance 5m, Speed 50km/h
@@ -37,7 +79,8 @@ void traffic_sim_thread_entry(void *p1, void *p2, void *p3) {
         s_data.type = VEHICLE_LIGHT;
         
         LOG_INF("SIMULATION: Generating Light Vehicle (50 km/h)");
-        k_msgq_put(&sensor_msgq, &s_data, K_NO_WAIT);
+        traffic_sim_weigh(&s_data, 1500);
+        traffic_sim_inject(&s_data);
         
         k_sleep(K_SECONDS(5));
 
@@ -51,7 +94,8 @@ void traffic_sim_thread_entry(void *p1, void *p2, void *p3) {
         s_data.type = VEHICLE_HEAVY;
 
         LOG_INF("SIMULATION: Generating Heavy Vehicle (50 km/h - Infraction!)");
-        k_msgq_put(&sensor_msgq, &s_data, K_NO_WAIT);
+        traffic_sim_weigh(&s_data, 24000);
+        traffic_sim_inject(&s_data);
 
         k_sleep(K_SECONDS(5));
         
@@ -64,11 +108,214 @@ void traffic_sim_thread_entry(void *p1, void *p2, void *p3) {
         s_data.type = VEHICLE_LIGHT;
 
         LOG_INF("SIMULATION: Generating Light Vehicle (80 km/h - Infraction!)");
-        k_msgq_put(&sensor_msgq, &s_data, K_NO_WAIT);
+        traffic_sim_weigh(&s_data, 1200);
+        traffic_sim_inject(&s_data);
         
         k_sleep(K_SECONDS(5));
+
+#if IS_ENABLED(CONFIG_RADAR_WIM)
+        // 4. Simulate an Overloaded Heavy Vehicle within the speed limit
+        // 30 km/h. Time = 600ms, 52 t on 5 axles
+        s_data.timestamp_start = k_uptime_get();
+        s_data.duration_ms = 600;
+        s_data.timestamp_end = s_data.timestamp_start + 600;
+        s_data.axle_count = 5;
+        s_data.type = VEHICLE_HEAVY;
+
+        LOG_INF("SIMULATION: Generating Heavy Vehicle (30 km/h, 52 t - Overweight!)");
+        traffic_sim_weigh(&s_data, 52000);
+        traffic_sim_inject(&s_data);
+
+        k_sleep(K_SECONDS(5));
+#endif
+    }
+}
+
+#elif IS_ENABLED(CONFIG_RADAR_TRAFFIC_SIM_MULTILANE)
+
+#define TRAFFIC_MEAN_HEADWAY_MS (3600000 / CONFIG_RADAR_TRAFFIC_VEHICLES_PER_HOUR)
+
+// Vehicles on one lane keep at least half a second apart
+#define TRAFFIC_MIN_HEADWAY_MS MIN(500, TRAFFIC_MEAN_HEADWAY_MS)
+
+/**
+ * Picks the gap to the next vehicle on a lane.
+ * Uniform between the minimum headway and twice the mean minus that, so the mean rate holds.
+ * @return The headway in milliseconds.
+ */
+static uint32_t traffic_sim_headway(void) {
+    uint32_t spread = 2 * (TRAFFIC_MEAN_HEADWAY_MS - TRAFFIC_MIN_HEADWAY_MS);
+    return TRAFFIC_MIN_HEADWAY_MS + (spread > 0 ? sys_rand32_get() % (spread + 1) : 0);
+}
+
+/**
+ * Fills a measurement for a random vehicle on a lane.
+ * @param s_data Pointer to the measurement to fill.
+ * @param lane The lane the vehicle passes on.
+ * @param arrival_ms The time the vehicle reaches the first sensor.
+ */
+static void traffic_sim_vehicle(sensor_data_t *s_data, uint8_t lane, int64_t arrival_ms) {
+    bool heavy = (sys_rand32_get() % 100) < CONFIG_RADAR_TRAFFIC_HEAVY_PERCENT;
+    // Light 40..99 km/h, heavy 25..64 km/h: both sides of each limit
+    uint32_t speed_kmh = heavy ? 25 + sys_rand32_get() % 40 : 40 + sys_rand32_get() % 60;
+
+#if CONFIG_RADAR_TRAFFIC_STOP_AND_GO_PERIOD_S > 0
+    // Every other phase is stop-and-go: 5..19 km/h
+    if ((arrival_ms / (CONFIG_RADAR_TRAFFIC_STOP_AND_GO_PERIOD_S * 1000)) % 2 == 1) {
+        speed_kmh = 5 + sys_rand32_get() % 15;
+    }
+#endif
+
+    s_data->timestamp_start = arrival_ms;
+    s_data->duration_ms = (CONFIG_RADAR_SENSOR_DISTANCE_MM * 36) / (speed_kmh * 10);
+    s_data->timestamp_end = arrival_ms + s_data->duration_ms;
+    s_data->axle_count = heavy ? 3 + sys_rand32_get() % 4 : 2;
+    s_data->type = heavy ? VEHICLE_HEAVY : VEHICLE_LIGHT;
+    s_data->lane = lane;
+}
+
+/**
+ * Picks the actual weight of a random vehicle: 0.9 to 2.9 t for light ones,
+ * 4 to 10 t per axle for heavy ones, so long trucks are sometimes overloaded.
+ * @param s_data The vehicle.
+ * @return The gross weight in kilograms.
+ */
+static uint32_t traffic_sim_weight(const sensor_data_t *s_data) {
+    if (s_data->type == VEHICLE_HEAVY) {
+        return s_data->axle_count * (4000 + sys_rand32_get() % 6000);
+    }
+    return 900 + sys_rand32_get() % 2000;
+}
+
+void traffic_sim_thread_entry(void *p1, void *p2, void *p3) {
+    int64_t next_ms[CONFIG_RADAR_TRAFFIC_LANES];
+
+    LOG_INF("Traffic Simulator Started (%d lanes, %d vehicles/h each)",
+            CONFIG_RADAR_TRAFFIC_LANES, CONFIG_RADAR_TRAFFIC_VEHICLES_PER_HOUR);
+
+    k_sleep(K_SECONDS(2)); // Wait for system to settle
+
+    int64_t now = k_uptime_get();
+    for (int lane = 0; lane < CONFIG_RADAR_TRAFFIC_LANES; lane++) {
+        next_ms[lane] = now + traffic_sim_headway();
+    }
+
+    while (1) {
+        // Serve the lane whose next vehicle arrives first
+        uint8_t lane = 0;
+        for (uint8_t i = 1; i < CONFIG_RADAR_TRAFFIC_LANES; i++) {
+            if (next_ms[i] < next_ms[lane]) {
+                lane = i;
+            }
+        }
+
+        // The measurement is complete once the vehicle reaches the second sensor
+        sensor_data_t s_data = {0};
+        traffic_sim_vehicle(&s_data, lane, next_ms[lane]);
+        // The strip is on lane 0; long slow trucks hold the other lanes back a little
+        if (lane == 0) {
+            traffic_sim_weigh(&s_data, traffic_sim_weight(&s_data));
+        }
+        k_sleep(K_TIMEOUT_ABS_MS(s_data.timestamp_end));
+        telemetry_inc(TELEMETRY_WAKEUP);
+        traffic_sim_inject(&s_data);
+
+        next_ms[lane] += traffic_sim_headway();
+    }
+}
+
+#elif IS_ENABLED(CONFIG_RADAR_TRAFFIC_SIM_DATASET)
+
+static const char *dataset_path = CONFIG_RADAR_TRAFFIC_DATASET_PATH;
+
+/**
+ * Registers the --dataset command line option of the native_sim executable.
+ */
+static void traffic_sim_dataset_options(void) {
+    static struct args_struct_t options[] = {
+        {
+            .option = "dataset",
+            .name = "path",
+            .type = 's',
+            .dest = (void *)&dataset_path,
+            .descript = "Traffic dataset (CSV or binary) to replay through the pipeline",
+        },
+        ARG_TABLE_ENDMARKER,
+    };
+
+    native_add_command_line_opts(options);
+}
+
+NATIVE_TASK(traffic_sim_dataset_options, PRE_BOOT_1, 1);
+
+/**
+ * Prints the status counts and the replay rate.
+ * @param ds The dataset, read to the end.
+ * @param vehicles The vehicles replayed.
+ * @param elapsed_ns Host time the replay took.
+ */
+static void traffic_sim_dataset_summary(const dataset_t *ds, uint32_t vehicles, uint64_t elapsed_ns) {
+    uint64_t per_min = elapsed_ns > 0 ? ((uint64_t)vehicles * 60000000000ull) / elapsed_ns : 0;
+
+    printk("DATASET vehicles=%u errors=%u light=%u heavy=%u duplicates=%u\n", vehicles, ds->errors,
+           telemetry_get(TELEMETRY_VEHICLE_LIGHT), telemetry_get(TELEMETRY_VEHICLE_HEAVY),
+           telemetry_get(TELEMETRY_DEDUP_VEHICLE));
+    printk("DATASET normal=%u warning=%u infraction=%u overweight=%u\n",
+           telemetry_get(TELEMETRY_STATUS_NORMAL), telemetry_get(TELEMETRY_STATUS_WARNING),
+           telemetry_get(TELEMETRY_STATUS_INFRACTION), telemetry_get(TELEMETRY_OVERWEIGHT));
+    printk("DATASET %u ms host time, %u vehicles/min\n", (uint32_t)(elapsed_ns / 1000000u),
+           (uint32_t)per_min);
+}
+
+void traffic_sim_thread_entry(void *p1, void *p2, void *p3) {
+    size_t size = 0;
+    const void *data = dataset_native_map(dataset_path, &size);
+
+    if (data == NULL) {
+        LOG_ERR("Cannot map dataset '%s' (pass --dataset=<path>)", dataset_path);
+        posix_exit(1);
+        return;
     }
+
+    dataset_t ds;
+    dataset_open(&ds, data, size);
+    LOG_INF("Traffic Simulator Started (dataset %s, %s, %zu bytes)", dataset_path,
+            ds.format == DATASET_BINARY ? "binary" : "CSV", size);
+
+    k_sleep(K_SECONDS(2)); // Wait for system to settle
+
+    sensor_data_t s_data = {0};
+    uint32_t vehicles = 0;
+    int64_t offset_ms = 0;
+    bool more = true;
+    uint64_t t0 = dataset_native_wall_ns();
+
+    while (more) {
+        // Fill the whole queue before main() wakes up, so it drains it in one go:
+        // two context switches per queue instead of two per vehicle
+        k_sched_lock();
+        while (k_msgq_num_free_get(&sensor_msgq) > 0 && (more = dataset_next(&ds, &s_data))) {
+            // Dataset time continues from the start of the replay
+            if (vehicles == 0) {
+                offset_ms = k_uptime_get() - s_data.timestamp_start;
+            }
+            s_data.timestamp_start += offset_ms;
+            s_data.timestamp_end += offset_ms;
+            telemetry_inc(TELEMETRY_MEASUREMENT);
+            (void)k_msgq_put(&sensor_msgq, &s_data, K_NO_WAIT);
+            vehicles++;
+        }
+        k_sched_unlock();
+        // main() runs above this thread: once we are back, the queue is empty
+        while (k_msgq_num_used_get(&sensor_msgq) > 0) {
+            k_yield();
+        }
+    }
+    traffic_sim_dataset_summary(&ds, vehicles, dataset_native_wall_ns() - t0);
+    posix_exit(0);
 }
 
-K_THREAD_DEFINE(traffic_sim_tid, 1024, traffic_sim_thread_entry, NULL, NULL, NULL, 8, 0, 0);
+#endif
+
+K_THREAD_DEFINE(traffic_sim_tid, CONFIG_RADAR_TRAFFIC_SIM_STACK_SIZE, traffic_sim_thread_entry, NULL, NULL, NULL, 8, 0, 0);
 
@@ -1,5 +1,5 @@
-#include <zephyr/kernel.h>
 #include <string.h>
+#include "radar_os.h"
 #include "common.h"
 
 /**
@@ -49,6 +49,23 @@ bool validate_plate(const char *plate) {
 	return true;
 }
 
+/**
+ * Packs a valid Mercosul plate into 32 bits: 5 bits per letter, 4 per digit.
+ * @param plate The plate number, already checked with validate_plate().
+ * @return The packed plate.
+ */
+uint32_t plate_pack(const char *plate) {
+	uint32_t packed = 0;
+	for (int i = 0; i < 7; i++) {
+		if (i == 3 || i == 5 || i == 6) {
+			packed = (packed << 4) | (uint32_t)(plate[i] - '0');
+		} else {
+			packed = (packed << 5) | (uint32_t)(util_to_upper_char(plate[i]) - 'A');
+		}
+	}
+	return packed;
+}
+
 
 /**
  * Calculates the speed in km/h based on the distance and duration.
@@ -56,9 +73,26 @@ bool validate_plate(const char *plate) {
  * @param duration_ms The duration in milliseconds.
  * @return The speed in km/h.
  */
-uint32_t calculate_speed(uint32_t distance_mm, uint32_t duration_ms) {
+RADAR_HOT uint32_t calculate_speed(uint32_t distance_mm, uint32_t duration_ms) {
     if (duration_ms == 0) return 0;
     // Speed (km/h) = (dist_mm / time_ms) * 3.6
     // = (dist * 36) / (time * 10)
     return (uint32_t)(((uint64_t)distance_mm * 36) / (duration_ms * 10));
 }
+
+/**
+ * Predicts when a vehicle reaches a point past the end sensor, assuming it
+ * keeps the speed it had between the two sensors.
+ * @param end_us Time the vehicle crossed the end sensor, in microseconds.
+ * @param duration_us Time it took from the start to the end sensor, in microseconds.
+ * @param sensor_distance_mm The distance between the two sensors.
+ * @param target_distance_mm The distance from the end sensor to the point.
+ * @return The arrival time in microseconds, on the same clock as end_us.
+ */
+int64_t predict_arrival_us(int64_t end_us, uint32_t duration_us, uint32_t sensor_distance_mm,
+                           uint32_t target_distance_mm) {
+    if (sensor_distance_mm == 0) return end_us;
+    // travel = target / (sensor / duration)
+    uint64_t travel_us = ((uint64_t)target_distance_mm * duration_us) / sensor_distance_mm;
+    return end_us + (int64_t)travel_us;
+}
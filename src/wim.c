@@ -0,0 +1,200 @@
+#include "wim.h"
+#include <string.h>
+
+// Full scale of the 12-bit ADC the strip is read with
+#define WIM_ADC_MAX 4095
+
+/**
+ * Initializes the detector. The baseline is taken from the first sample.
+ * @param wim Pointer to the detector.
+ * @param threshold Height above the baseline that opens an axle pulse (counts).
+ */
+void wim_init(wim_t *wim, uint16_t threshold)
+{
+	memset(wim, 0, sizeof(*wim));
+	wim->on_q8 = (int32_t)threshold << 8;
+	wim->off_q8 = (int32_t)threshold << 7;
+}
+
+/**
+ * Closes the current pulse and adds it to the vehicle.
+ * @param wim Pointer to the detector.
+ */
+static void wim_close_axle(wim_t *wim)
+{
+	if (wim->axle_count < WIM_MAX_AXLES) {
+		wim->axles[wim->axle_count] = wim->current;
+	}
+	wim->axle_count++;
+	wim->integral_sum += wim->current.integral;
+	wim->in_axle = false;
+}
+
+/**
+ * Feeds a block of samples, as a DMA transfer would deliver them.
+ * @param wim Pointer to the detector.
+ * @param samples The raw ADC samples.
+ * @param count The number of samples.
+ * @return The number of axle pulses that ended within the block.
+ */
+RADAR_HOT uint32_t wim_feed(wim_t *wim, const uint16_t *samples, size_t count)
+{
+	uint32_t closed = 0;
+
+	if (count > 0 && !wim->primed) {
+		wim->baseline_q8 = (int32_t)samples[0] << 8;
+		wim->primed = true;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		int32_t x = ((int32_t)samples[i] << 8) - wim->baseline_q8;
+
+		if (!wim->in_axle) {
+			if (x <= wim->on_q8) {
+				// Follow temperature drift only while nothing is on the strip,
+				// not the slow rising edge of a pulse
+				if (x < wim->off_q8) {
+					wim->baseline_q8 += x >> WIM_BASELINE_SHIFT;
+				}
+				wim->last_q8 = x;
+				continue;
+			}
+			// The sample before the threshold is part of the rising edge
+			wim->in_axle = true;
+			wim->current = (wim_axle_t){.integral = (uint32_t)MAX(wim->last_q8, 0) >> 8};
+		}
+		if (x < wim->off_q8) {
+			// And so is the first one below it, of the falling edge
+			wim->current.integral += (uint32_t)MAX(x, 0) >> 8;
+			wim_close_axle(wim);
+			closed++;
+			continue;
+		}
+
+		uint32_t height = ((uint32_t)x + 128) >> 8;
+
+		wim->current.integral += height;
+		wim->current.peak = MAX(wim->current.peak, (uint16_t)height);
+		// A vehicle standing on the strip cannot be weighed in motion; cut the pulse
+		if (++wim->current.samples == UINT16_MAX) {
+			wim_close_axle(wim);
+			closed++;
+		}
+	}
+	return closed;
+}
+
+/**
+ * Converts the pulses of the current vehicle to its gross weight. The pulse
+ * integral is load * contact time, and contact time is the tyre footprint
+ * over the speed measured by the sensor pair.
+ * @param wim Pointer to the detector.
+ * @param distance_mm Distance between the speed sensors.
+ * @param duration_ms Time the vehicle took between them.
+ * @return The gross weight in kilograms, 0 if no axle was seen.
+ */
+uint32_t wim_gross_weight_kg(const wim_t *wim, uint32_t distance_mm, uint32_t duration_ms)
+{
+	// kg = integral * speed_mm_s * 1000 / (sample_hz * contact_mm * counts_per_tonne)
+	uint64_t den = (uint64_t)MAX(duration_ms, 1) * CONFIG_RADAR_WIM_SAMPLE_HZ *
+		       CONFIG_RADAR_WIM_CONTACT_MM * CONFIG_RADAR_WIM_COUNTS_PER_TONNE;
+	uint64_t num = wim->integral_sum * distance_mm * 1000000u;
+
+	return (uint32_t)MIN((num + den / 2) / den, (uint64_t)UINT32_MAX);
+}
+
+/**
+ * Forgets the axles of the current vehicle. The baseline is kept, and a
+ * pulse still in progress carries over to the next vehicle.
+ * @param wim Pointer to the detector.
+ */
+void wim_vehicle_reset(wim_t *wim)
+{
+	wim->axle_count = 0;
+	wim->integral_sum = 0;
+}
+
+/**
+ * Initializes the simulated strip.
+ * @param sim Pointer to the simulator.
+ * @param baseline The idle ADC level (counts).
+ * @param noise The peak to peak noise (counts).
+ * @param seed Seed of the noise generator.
+ */
+void wim_sim_init(wim_sim_t *sim, uint16_t baseline, uint16_t noise, uint32_t seed)
+{
+	memset(sim, 0, sizeof(*sim));
+	sim->baseline = baseline;
+	sim->noise = noise;
+	sim->rng = seed;
+}
+
+/**
+ * Queues the pulse of one axle crossing the strip.
+ * @param sim Pointer to the simulator.
+ * @param start Sample index at which the tyre reaches the strip; earlier indexes start now.
+ * @param load_kg The axle load.
+ * @param speed_mm_s The vehicle speed.
+ * @return True if the pulse was queued, false if the queue is full.
+ */
+bool wim_sim_add_axle(wim_sim_t *sim, uint32_t start, uint32_t load_kg, uint32_t speed_mm_s)
+{
+	if (sim->pulse_count == WIM_MAX_AXLES) {
+		return false;
+	}
+
+	wim_sim_pulse_t *p = &sim->pulses[sim->pulse_count++];
+
+	p->start = MAX(start, sim->now);
+	speed_mm_s = MAX(speed_mm_s, 1);
+	p->length = MAX((uint32_t)(((uint64_t)CONFIG_RADAR_WIM_CONTACT_MM * CONFIG_RADAR_WIM_SAMPLE_HZ +
+				    speed_mm_s / 2) / speed_mm_s), 1);
+	p->mean = (load_kg * CONFIG_RADAR_WIM_COUNTS_PER_TONNE) / 1000;
+	return true;
+}
+
+/**
+ * Produces the next samples of the strip and drops the pulses that ended.
+ * @param sim Pointer to the simulator.
+ * @param samples Output buffer.
+ * @param count The number of samples to produce.
+ */
+void wim_sim_read(wim_sim_t *sim, uint16_t *samples, size_t count)
+{
+	for (size_t i = 0; i < count; i++, sim->now++) {
+		sim->rng = sim->rng * 1664525u + 1013904223u;
+		int32_t v = sim->baseline + (int32_t)((sim->rng >> 16) % (sim->noise + 1u)) - sim->noise / 2;
+
+		for (uint32_t k = 0; k < sim->pulse_count; k++) {
+			const wim_sim_pulse_t *p = &sim->pulses[k];
+			uint32_t n = sim->now - p->start;
+
+			// Parabola 4u(1 - u) scaled so its mean is p->mean
+			if (sim->now >= p->start && n < p->length) {
+				uint64_t den = (uint64_t)p->length * p->length;
+
+				v += (int32_t)((6ull * p->mean * n * (p->length - n) + den / 2) / den);
+			}
+		}
+		samples[i] = (uint16_t)MIN(MAX(v, 0), WIM_ADC_MAX);
+	}
+
+	uint32_t kept = 0;
+
+	for (uint32_t k = 0; k < sim->pulse_count; k++) {
+		if (sim->pulses[k].start + sim->pulses[k].length > sim->now) {
+			sim->pulses[kept++] = sim->pulses[k];
+		}
+	}
+	sim->pulse_count = kept;
+}
+
+/**
+ * Tells whether queued pulses are still to come out of the simulator.
+ * @param sim Pointer to the simulator.
+ * @return True if a pulse is pending or in progress.
+ */
+bool wim_sim_busy(const wim_sim_t *sim)
+{
+	return sim->pulse_count > 0;
+}
@@ -0,0 +1,77 @@
+#ifndef WIM_H
+#define WIM_H
+
+#include "radar_os.h"
+
+#ifndef CONFIG_RADAR_WIM_SAMPLE_HZ
+#define CONFIG_RADAR_WIM_SAMPLE_HZ 2000
+#endif
+#ifndef CONFIG_RADAR_WIM_THRESHOLD
+#define CONFIG_RADAR_WIM_THRESHOLD 20
+#endif
+#ifndef CONFIG_RADAR_WIM_COUNTS_PER_TONNE
+#define CONFIG_RADAR_WIM_COUNTS_PER_TONNE 100
+#endif
+#ifndef CONFIG_RADAR_WIM_CONTACT_MM
+#define CONFIG_RADAR_WIM_CONTACT_MM 250
+#endif
+
+// Axles whose pulses are kept one by one; further axles still add to the gross weight
+#define WIM_MAX_AXLES 8
+// Baseline tracker: moves 1/2^N of the way to each idle sample
+#define WIM_BASELINE_SHIFT 6
+
+typedef struct {
+	uint32_t integral; // Sum of the pulse above the baseline (counts * samples)
+	uint16_t peak;     // Highest sample above the baseline (counts)
+	uint16_t samples;  // Pulse length
+} wim_axle_t;
+
+/*
+ * Streaming axle-load detector for a piezo strip. Every sample is compared
+ * against a slowly tracked baseline (Q8 fixed point); a pulse opens above
+ * the threshold and closes below half of it, and its integral and peak are
+ * kept per axle. The integral of a pulse is proportional to load / speed,
+ * so loads are only converted to kilograms once the speed is known.
+ */
+typedef struct {
+	int32_t baseline_q8;
+	int32_t on_q8;
+	int32_t off_q8;
+	int32_t last_q8; // Last idle sample above the baseline
+	bool primed;  // The baseline has seen a sample
+	bool in_axle;
+	wim_axle_t current;
+	wim_axle_t axles[WIM_MAX_AXLES];
+	uint32_t axle_count;   // Axles of the current vehicle, may exceed WIM_MAX_AXLES
+	uint64_t integral_sum; // Integral over every axle of the current vehicle
+} wim_t;
+
+// One simulated axle pulse: a parabola of the given mean height
+typedef struct {
+	uint32_t start;  // Index of its first sample
+	uint32_t length; // Samples
+	uint32_t mean;   // Counts
+} wim_sim_pulse_t;
+
+// Simulated ADC for the strip: baseline, uniform noise and the queued axle pulses
+typedef struct {
+	wim_sim_pulse_t pulses[WIM_MAX_AXLES];
+	uint32_t pulse_count;
+	uint32_t now; // Index of the next sample
+	uint16_t baseline;
+	uint16_t noise; // Peak to peak, counts
+	uint32_t rng;
+} wim_sim_t;
+
+void wim_init(wim_t *wim, uint16_t threshold);
+uint32_t wim_feed(wim_t *wim, const uint16_t *samples, size_t count);
+uint32_t wim_gross_weight_kg(const wim_t *wim, uint32_t distance_mm, uint32_t duration_ms);
+void wim_vehicle_reset(wim_t *wim);
+
+void wim_sim_init(wim_sim_t *sim, uint16_t baseline, uint16_t noise, uint32_t seed);
+bool wim_sim_add_axle(wim_sim_t *sim, uint32_t start, uint32_t load_kg, uint32_t speed_mm_s);
+void wim_sim_read(wim_sim_t *sim, uint16_t *samples, size_t count);
+bool wim_sim_busy(const wim_sim_t *sim);
+
+#endif
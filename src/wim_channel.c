@@ -0,0 +1,166 @@
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include "wim.h"
+#include "wim_channel.h"
+#include "telemetry.h"
+
+LOG_MODULE_REGISTER(wim_channel, CONFIG_RADAR_LOG_LEVEL);
+
+#define WIM_BLOCK_SAMPLES ((CONFIG_RADAR_WIM_SAMPLE_HZ * CONFIG_RADAR_WIM_BLOCK_MS) / 1000)
+
+BUILD_ASSERT(WIM_BLOCK_SAMPLES > 0, "WIM block shorter than one sample");
+
+// Axle spacing of the simulated vehicles
+#define WIM_SIM_SPACING_LIGHT_MM 2600
+#define WIM_SIM_SPACING_HEAVY_MM 3500
+
+static struct k_spinlock wim_lock;
+static wim_t wim;
+static wim_sim_t wim_sim;
+static bool wim_sampling;
+// Sampling continues at least until then after a start edge
+static int64_t wim_hold_until;
+static uint16_t wim_block[WIM_BLOCK_SAMPLES];
+static wim_channel_stats_t wim_stats;
+
+/**
+ * Sampling timer expiry: takes one block of samples and runs the detector
+ * over it. Stops itself once the strip is idle again and no axle is due.
+ * @param timer Pointer to the timer.
+ */
+RADAR_HOT static void wim_sample_expiry(struct k_timer *timer)
+{
+	telemetry_inc(TELEMETRY_WAKEUP);
+	k_spinlock_key_t key = k_spin_lock(&wim_lock);
+
+	// Stands in for the ADC sequence of the last block
+	wim_sim_read(&wim_sim, wim_block, WIM_BLOCK_SAMPLES);
+
+	uint32_t t0 = k_cycle_get_32();
+
+	(void)wim_feed(&wim, wim_block, WIM_BLOCK_SAMPLES);
+	wim_stats.cycles += k_cycle_get_32() - t0;
+	wim_stats.samples += WIM_BLOCK_SAMPLES;
+	wim_stats.blocks++;
+	if (!wim_sim_busy(&wim_sim) && !wim.in_axle && k_uptime_get() >= wim_hold_until) {
+		wim_sampling = false;
+		k_timer_stop(timer);
+	}
+	k_spin_unlock(&wim_lock, key);
+}
+
+K_TIMER_DEFINE(wim_sample_timer, wim_sample_expiry, NULL);
+
+/**
+ * Starts the sampling timer if it is not running. Called with wim_lock held.
+ */
+static void wim_channel_start_locked(void)
+{
+	if (!wim_sampling) {
+		wim_sampling = true;
+		k_timer_start(&wim_sample_timer, K_MSEC(CONFIG_RADAR_WIM_BLOCK_MS),
+			      K_MSEC(CONFIG_RADAR_WIM_BLOCK_MS));
+	}
+}
+
+/**
+ * Start sensor edge: the axle is on the strip now, so sampling starts and
+ * keeps going for an axle timeout, the window in which the sensor FSM
+ * still counts axles of the same vehicle. Safe to call from an ISR.
+ */
+RADAR_HOT void wim_channel_arm(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&wim_lock);
+
+	wim_hold_until = k_uptime_get() + CONFIG_RADAR_AXLE_TIMEOUT_MS;
+	wim_channel_start_locked();
+	k_spin_unlock(&wim_lock, key);
+}
+
+/**
+ * Queues the axle pulses of a simulated vehicle on the strip, the load
+ * shared evenly between its axles, and starts sampling if it was idle.
+ * The strip sits at the start sensor, so the first axle reaches it at
+ * timestamp_start.
+ * @param s_data The measurement of the vehicle.
+ * @param gross_weight_kg The weight the strip should see.
+ * @return The uptime by which its last axle has been sampled.
+ */
+int64_t wim_channel_simulate(const sensor_data_t *s_data, uint32_t gross_weight_kg)
+{
+	uint32_t axles = MIN(MAX(s_data->axle_count, 1), WIM_MAX_AXLES);
+	uint32_t speed_mm_s = (CONFIG_RADAR_SENSOR_DISTANCE_MM * 1000u) / MAX(s_data->duration_ms, 1);
+	uint32_t spacing_mm = s_data->type == VEHICLE_HEAVY ? WIM_SIM_SPACING_HEAVY_MM :
+							      WIM_SIM_SPACING_LIGHT_MM;
+	uint32_t last_sample = 0;
+	k_spinlock_key_t key = k_spin_lock(&wim_lock);
+	int64_t now = k_uptime_get();
+	uint32_t base = wim_sim.now;
+
+	for (uint32_t i = 0; i < axles; i++) {
+		int64_t arrival_ms = s_data->timestamp_start +
+				     ((int64_t)i * spacing_mm * 1000) / speed_mm_s;
+		int64_t ahead_ms = MAX(arrival_ms - now, 0);
+		uint32_t start = base + (uint32_t)((ahead_ms * CONFIG_RADAR_WIM_SAMPLE_HZ) / 1000);
+
+		if (!wim_sim_add_axle(&wim_sim, start, gross_weight_kg / axles, speed_mm_s)) {
+			break;
+		}
+		const wim_sim_pulse_t *p = &wim_sim.pulses[wim_sim.pulse_count - 1];
+		last_sample = MAX(last_sample, p->start + p->length);
+	}
+	wim_channel_start_locked();
+	k_spin_unlock(&wim_lock, key);
+
+	// One block for the falling edge to be read, one for timer jitter
+	return now + ((int64_t)(last_sample - base) * 1000) / CONFIG_RADAR_WIM_SAMPLE_HZ +
+	       2 * CONFIG_RADAR_WIM_BLOCK_MS;
+}
+
+/**
+ * Weighs the vehicle whose axles crossed the strip since the last call,
+ * using the speed of its measurement, and starts over for the next one.
+ * @param s_data The measurement of the vehicle.
+ * @return The gross weight in kilograms, 0 if no axle was seen.
+ */
+uint32_t wim_channel_take(const sensor_data_t *s_data)
+{
+	k_spinlock_key_t key = k_spin_lock(&wim_lock);
+	uint32_t kg = 0;
+
+	if (wim.axle_count > 0) {
+		kg = wim_gross_weight_kg(&wim, CONFIG_RADAR_SENSOR_DISTANCE_MM, s_data->duration_ms);
+		wim_stats.vehicles++;
+	}
+	wim_vehicle_reset(&wim);
+	k_spin_unlock(&wim_lock, key);
+	return kg;
+}
+
+/**
+ * Reads the channel statistics.
+ * @param stats Pointer to the statistics to fill.
+ */
+void wim_channel_get_stats(wim_channel_stats_t *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&wim_lock);
+
+	*stats = wim_stats;
+	k_spin_unlock(&wim_lock, key);
+}
+
+/**
+ * Sets up the detector and the simulated strip.
+ * @return 0.
+ */
+static int wim_channel_init(void)
+{
+	wim_init(&wim, CONFIG_RADAR_WIM_THRESHOLD);
+	// Offset of the charge amplifier output, a few counts of noise
+	wim_sim_init(&wim_sim, 512, 8, 0x9e3779b9u);
+	LOG_INF("WIM: %u Hz, %u samples per block", CONFIG_RADAR_WIM_SAMPLE_HZ, WIM_BLOCK_SAMPLES);
+	return 0;
+}
+
+SYS_INIT(wim_channel_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
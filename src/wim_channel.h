@@ -0,0 +1,50 @@
+#ifndef WIM_CHANNEL_H
+#define WIM_CHANNEL_H
+
+#include "common.h"
+
+/*
+ * Weigh-in-motion channel: a piezo strip next to the start sensor of lane 0,
+ * sampled at CONFIG_RADAR_WIM_SAMPLE_HZ and processed in blocks, as a
+ * timer-triggered ADC sequence with DMA would deliver them. The strip is
+ * simulated: the traffic simulator queues the axle pulses of the vehicles
+ * it generates. Sampling starts on each start sensor edge, or when the
+ * simulator queues a vehicle, and only runs while a vehicle is on the
+ * strip, so an empty road costs no wakeups.
+ */
+
+typedef struct {
+	uint32_t samples;  // Samples processed
+	uint32_t cycles;   // Cycles spent in the detector, wrapping at 2^32
+	uint32_t vehicles; // Vehicles weighed
+	uint32_t blocks;   // Sampling timer expiries
+} wim_channel_stats_t;
+
+#if IS_ENABLED(CONFIG_RADAR_WIM)
+
+void wim_channel_arm(void);
+int64_t wim_channel_simulate(const sensor_data_t *s_data, uint32_t gross_weight_kg);
+uint32_t wim_channel_take(const sensor_data_t *s_data);
+void wim_channel_get_stats(wim_channel_stats_t *stats);
+
+#else
+
+static inline void wim_channel_arm(void)
+{
+}
+
+static inline int64_t wim_channel_simulate(const sensor_data_t *s_data, uint32_t gross_weight_kg)
+{
+	ARG_UNUSED(gross_weight_kg);
+	return s_data->timestamp_end;
+}
+
+static inline uint32_t wim_channel_take(const sensor_data_t *s_data)
+{
+	ARG_UNUSED(s_data);
+	return 0;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "radar_os.h"
+
+#if !defined(__ZEPHYR__)
+#include <stdio.h>
+#define printk printf
+#endif
+
+/**
+ * Prints one benchmark result line.
+ * @param name The name of the measured operation.
+ * @param cycles The total cycles spent (nanoseconds on the host build).
+ * @param ops The number of operations performed.
+ */
+static inline void bench_report(const char *name, uint64_t cycles, uint32_t ops)
+{
+	uint64_t per_op = cycles / ops;
+	uint32_t ns_per_op = (uint32_t)((per_op * 1000000000u) / radar_cycles_per_sec());
+
+	printk("BENCH %-32s %10u cycles/op %10u ns/op (%u ops)\n", name, (uint32_t)per_op, ns_per_op,
+	       ops);
+}
+
+void bench_camera_run(void);
+void bench_chain_run(void);
+void bench_console_run(void);
+void bench_core_run(void);
+void bench_dataset_run(void);
+void bench_evidence_run(void);
+void bench_flight_run(void);
+bool bench_footprint_run(void);
+void bench_fsm_run(void);
+void bench_histogram_run(void);
+void bench_isr_run(void);
+void bench_log_mpsc_run(void);
+void bench_lpr_run(void);
+void bench_schema_run(void);
+void bench_wim_run(void);
+
+#endif
@@ -0,0 +1,108 @@
+#include "bench.h"
+#include "camera_batch.h"
+
+/*
+ * Camera throughput for platoons: N speeders on one lane, 250 ms apart,
+ * played through the capture model in virtual time. One-by-one capture
+ * keeps each vehicle waiting for the previous capture to finish, and the
+ * ones that leave the view meanwhile are logged without a plate. Burst
+ * capture keeps the recording open for followers within the platoon gap,
+ * each adding only a plate extraction. Reports the plates captured, the
+ * plates per minute until the last result and the number of bursts. Once a
+ * burst outlasts its processing, the rate is bound by the arrivals (240
+ * plates/min at this spacing) and falls towards it as the platoon grows.
+ */
+
+#define CAMERA_BENCH_SPACING_MS 250
+#define CAMERA_BENCH_PLATOON_MAX 10
+
+typedef struct {
+	uint32_t captured;
+	uint32_t bursts;
+	int64_t done_ms; // Last result published
+} bench_camera_result_t;
+
+/**
+ * Builds the triggers of a platoon.
+ * @param triggers Array to fill.
+ * @param count The number of vehicles.
+ */
+static void bench_camera_platoon(camera_trigger_t *triggers, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		triggers[i] = (camera_trigger_t){
+			.id = i,
+			.lane = 0,
+			.timestamp_ms = (int64_t)i * CAMERA_BENCH_SPACING_MS,
+		};
+	}
+}
+
+/**
+ * One capture per trigger, in arrival order.
+ * @param triggers The platoon.
+ * @param count The number of vehicles.
+ * @return Captured plates and completion time.
+ */
+static bench_camera_result_t bench_camera_sequential(const camera_trigger_t *triggers,
+						     uint32_t count)
+{
+	bench_camera_result_t r = {0};
+	int64_t free_ms = 0;
+
+	for (uint32_t i = 0; i < count; i++) {
+		int64_t start = MAX(triggers[i].timestamp_ms, free_ms);
+
+		if (start - triggers[i].timestamp_ms <= CONFIG_RADAR_CAMERA_VIEW_MS) {
+			r.captured++;
+		}
+		free_ms = start + CONFIG_RADAR_CAMERA_CAPTURE_MS;
+	}
+	r.done_ms = free_ms;
+	return r;
+}
+
+/**
+ * Bursts as the camera thread forms them: a follower joins if it triggers
+ * within the gap of the last member and the burst has room.
+ * @param triggers The platoon.
+ * @param count The number of vehicles.
+ * @return Captured plates and completion time.
+ */
+static bench_camera_result_t bench_camera_burst(const camera_trigger_t *triggers, uint32_t count)
+{
+	bench_camera_result_t r = {0};
+	camera_batch_t batch;
+	int64_t free_ms = 0;
+	uint32_t i = 0;
+
+	while (i < count) {
+		camera_batch_start(&batch, &triggers[i], MAX(triggers[i].timestamp_ms, free_ms));
+		for (i++; i < count && camera_batch_join(&batch, &triggers[i]); i++) {
+		}
+		r.bursts++;
+		free_ms = camera_batch_done_ms(&batch);
+		for (uint32_t m = 0; m < batch.count; m++) {
+			r.captured += camera_batch_in_view(&batch, m);
+		}
+	}
+	r.done_ms = free_ms;
+	return r;
+}
+
+void bench_camera_run(void)
+{
+	camera_trigger_t triggers[CAMERA_BENCH_PLATOON_MAX];
+
+	for (uint32_t n = 1; n <= CAMERA_BENCH_PLATOON_MAX; n++) {
+		bench_camera_platoon(triggers, n);
+		bench_camera_result_t seq = bench_camera_sequential(triggers, n);
+		bench_camera_result_t burst = bench_camera_burst(triggers, n);
+
+		printk("BENCH camera_platoon_%-2u one-by-one %2u/%2u plates %4u plates/min | "
+		       "burst %2u/%2u plates %4u plates/min in %u burst(s)\n",
+		       n, seq.captured, n, (uint32_t)(seq.captured * 60000 / seq.done_ms),
+		       burst.captured, n, (uint32_t)(burst.captured * 60000 / burst.done_ms),
+		       burst.bursts);
+	}
+}
@@ -0,0 +1,117 @@
+#include <string.h>
+#include "bench.h"
+#include "infraction_log.h"
+#include "sha256.h"
+
+#define SHA_BUF_SIZE   1024
+#define SHA_ROUNDS     64
+#define CHAIN_RECORDS  256
+#define CHAIN_PACED    64
+
+static uint8_t sha_buf[SHA_BUF_SIZE];
+
+/**
+ * Measures raw SHA-256 throughput over a 1 KiB buffer.
+ */
+static void bench_sha256_throughput(void)
+{
+	uint8_t digest[SHA256_DIGEST_SIZE];
+
+	for (size_t i = 0; i < sizeof(sha_buf); i++) {
+		sha_buf[i] = (uint8_t)i;
+	}
+
+	uint32_t t0 = radar_cycles();
+	for (int i = 0; i < SHA_ROUNDS; i++) {
+		sha256(sha_buf, sizeof(sha_buf), digest);
+	}
+	uint32_t cycles = radar_cycles() - t0;
+
+	bench_report("sha256_1k", cycles, SHA_ROUNDS);
+	if (cycles > 0) {
+		uint64_t bytes = (uint64_t)SHA_BUF_SIZE * SHA_ROUNDS;
+		printk("BENCH %-32s %10u KiB/s\n", "sha256_throughput",
+		       (uint32_t)((bytes * radar_cycles_per_sec()) / ((uint64_t)cycles * 1024)));
+	}
+}
+
+/**
+ * Measures the background cost of linking one record into the chain.
+ */
+static void bench_chain_link(void)
+{
+	uint8_t digest[SHA256_DIGEST_SIZE] = {0};
+	infraction_record_t rec = {
+		.timestamp_ms = 123456,
+		.type = VEHICLE_HEAVY,
+		.speed_kmh = 72,
+		.limit_kmh = 40,
+		.valid_read = true,
+	};
+	strcpy(rec.plate, "ABC1D23");
+
+	uint32_t t0 = radar_cycles();
+	for (uint32_t i = 0; i < CHAIN_RECORDS; i++) {
+		rec.seq = i;
+		infraction_chain_link(digest, &rec, digest);
+	}
+	bench_report("chain_link_per_record", radar_cycles() - t0, CHAIN_RECORDS);
+}
+
+/**
+ * Measures the foreground cost of infraction_log_add with the chain enabled.
+ * The chain work queue runs below this thread, so hashing is excluded.
+ */
+static void bench_log_add(void)
+{
+	infraction_record_t rec = {
+		.timestamp_ms = 1000,
+		.type = VEHICLE_LIGHT,
+		.speed_kmh = 80,
+		.limit_kmh = 60,
+		.valid_read = true,
+	};
+	strcpy(rec.plate, "XYZ9W88");
+
+	uint64_t total = 0;
+	uint32_t worst = 0;
+	for (int i = 0; i < CHAIN_RECORDS; i++) {
+		uint32_t t0 = radar_cycles();
+		infraction_log_add(&rec);
+		uint32_t dt = radar_cycles() - t0;
+		total += dt;
+		worst = MAX(worst, dt);
+	}
+	bench_report("infraction_log_add", total, CHAIN_RECORDS);
+	bench_report("infraction_log_add_worst", worst, 1);
+
+	// Let the worker drain and report what it spent per record. On one core
+	// the worker only runs once this thread sleeps, so everything the burst
+	// pushed out of the ring before then is linked as a gap
+	radar_sleep_ms(100);
+	infraction_chain_stats_t stats;
+	infraction_log_get_chain_stats(&stats);
+	if (stats.hashed > 0) {
+		bench_report("chain_worker_per_record", stats.hash_cycles, stats.hashed);
+	}
+	printk("BENCH %-32s hashed=%u gaps=%u (burst of %u, ring of %u)\n", "chain_worker",
+	       stats.hashed, stats.gaps, CHAIN_RECORDS, CONFIG_RADAR_INFRACTION_LOG_SIZE);
+
+	// At traffic rates the worker keeps up and links no gaps
+	infraction_chain_stats_t before = stats;
+	for (int i = 0; i < CHAIN_PACED; i++) {
+		infraction_log_add(&rec);
+		radar_sleep_ms(1);
+	}
+	radar_sleep_ms(100);
+	infraction_log_get_chain_stats(&stats);
+	printk("BENCH %-32s hashed=%u gaps=%u (1 record/ms)\n", "chain_worker_paced",
+	       stats.hashed - before.hashed, stats.gaps - before.gaps);
+}
+
+void bench_chain_run(void)
+{
+	bench_sha256_throughput();
+	bench_chain_link();
+	bench_log_add();
+}
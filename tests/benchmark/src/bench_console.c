@@ -0,0 +1,80 @@
+#include "bench.h"
+#if defined(__ZEPHYR__)
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include "console_ring.h"
+#endif
+
+#if defined(CONFIG_RADAR_CONSOLE_RING)
+
+// About the size of one display status block
+#define CONSOLE_BLOCK_LEN 240
+// Blocks per run, at most half the ring so nothing is dropped
+#define CONSOLE_OPS MAX(1, MIN(8, CONFIG_RADAR_CONSOLE_RING_SIZE / (2 * CONSOLE_BLOCK_LEN)))
+
+static char console_block[CONSOLE_BLOCK_LEN];
+static char console_copy[CONSOLE_BLOCK_LEN];
+
+/**
+ * Fills the block with printable lines so the output stays readable.
+ */
+static void bench_console_fill(void)
+{
+	for (int i = 0; i < CONSOLE_BLOCK_LEN; i++) {
+		console_block[i] = (i % 60 == 59) ? '\n' : '.';
+	}
+}
+
+/**
+ * Measures what a display update costs its thread: one block into the
+ * interrupt-driven ring, against a plain memcpy and a polled write of the
+ * same block.
+ */
+static void bench_console_block(void)
+{
+	const struct device *uart = DEVICE_DT_GET(DT_CHOSEN(zephyr_console));
+	console_ring_stats_t before, after;
+
+	bench_console_fill();
+
+	uint32_t t0 = radar_cycles();
+	for (int i = 0; i < CONSOLE_OPS; i++) {
+		memcpy(console_copy, console_block, sizeof(console_block));
+		__asm__ volatile("" : : "r"(console_copy) : "memory");
+	}
+	bench_report("console_block_memcpy", radar_cycles() - t0, CONSOLE_OPS);
+
+	console_ring_get_stats(&before);
+	t0 = radar_cycles();
+	for (int i = 0; i < CONSOLE_OPS; i++) {
+		console_write(console_block, sizeof(console_block));
+	}
+	uint32_t ring_cycles = radar_cycles() - t0;
+	// Let the TX interrupt drain the ring before polling the UART
+	do {
+		k_msleep(10);
+		console_ring_get_stats(&after);
+	} while (after.used > 0);
+	bench_report("console_block_ring", ring_cycles, CONSOLE_OPS);
+
+	t0 = radar_cycles();
+	for (int i = 0; i < CONSOLE_BLOCK_LEN; i++) {
+		uart_poll_out(uart, console_block[i]);
+	}
+	bench_report("console_block_polled", radar_cycles() - t0, 1);
+
+	if (after.dropped != before.dropped) {
+		printk("console ring dropped %u bytes during the benchmark\n",
+		       after.dropped - before.dropped);
+	}
+}
+
+#endif
+
+void bench_console_run(void)
+{
+#if defined(CONFIG_RADAR_CONSOLE_RING)
+	bench_console_block();
+#endif
+}
@@ -0,0 +1,136 @@
+#include "bench.h"
+#include "common.h"
+#include "congestion.h"
+#include "dedup.h"
+#include "infraction_log.h"
+#include "sensor_fsm.h"
+
+#define CORE_OPS 4096
+
+// Keeps results alive so the measured calls are not optimized away
+static volatile uint32_t bench_sink;
+
+/**
+ * Measures one light vehicle through the FSM: two axles, end, finalize.
+ */
+static void bench_fsm_vehicle(void)
+{
+	sensor_fsm_t fsm;
+	sensor_data_t out;
+
+	sensor_fsm_init(&fsm);
+	uint32_t t0 = radar_cycles();
+	for (int64_t i = 0; i < CORE_OPS; i++) {
+		int64_t base = i * 3000;
+		sensor_fsm_handle_start(&fsm, base);
+		sensor_fsm_handle_start(&fsm, base + 100);
+		sensor_fsm_handle_end(&fsm, base + 360);
+		bench_sink += sensor_fsm_finalize(&fsm, &out) ? out.duration_ms : 0;
+	}
+	bench_report("fsm_vehicle", radar_cycles() - t0, CORE_OPS);
+}
+
+/**
+ * Measures plate validation and speed calculation.
+ */
+static void bench_validation(void)
+{
+	static const char *const plates[] = {"ABC1D23", "XYZ9W88", "ABC1234", "abc1d23"};
+
+	uint32_t t0 = radar_cycles();
+	for (uint32_t i = 0; i < CORE_OPS; i++) {
+		bench_sink += validate_plate(plates[i & 3]);
+	}
+	bench_report("validate_plate", radar_cycles() - t0, CORE_OPS);
+
+	t0 = radar_cycles();
+	for (uint32_t i = 0; i < CORE_OPS; i++) {
+		bench_sink += calculate_speed(5000, 200 + (i & 255));
+	}
+	bench_report("calculate_speed", radar_cycles() - t0, CORE_OPS);
+}
+
+/**
+ * Measures the whole per-vehicle core path: FSM, classification, speed
+ * and the duplicate check. This is the "cycles per vehicle" figure.
+ */
+static void bench_vehicle_pipeline(void)
+{
+	static dedup_set_t set;
+	sensor_fsm_t fsm;
+	sensor_data_t out;
+
+	sensor_fsm_init(&fsm);
+	dedup_set_init(&set, 500);
+	uint32_t t0 = radar_cycles();
+	for (int64_t i = 0; i < CORE_OPS; i++) {
+		int64_t base = i * 3000;
+		sensor_fsm_handle_start(&fsm, base);
+		sensor_fsm_handle_start(&fsm, base + 100);
+		sensor_fsm_handle_end(&fsm, base + 360);
+		if (!sensor_fsm_finalize(&fsm, &out)) {
+			continue;
+		}
+		uint32_t speed = calculate_speed(CONFIG_RADAR_SENSOR_DISTANCE_MM, out.duration_ms);
+		bench_sink += dedup_vehicle_check(&set, 0, base, speed, 5) ? 0 : speed;
+	}
+	bench_report("cycles_per_vehicle", radar_cycles() - t0, CORE_OPS);
+}
+
+/**
+ * Measures the duplicate check with a steady stream of distinct vehicles.
+ */
+static void bench_dedup(void)
+{
+	static dedup_set_t set;
+
+	dedup_set_init(&set, 500);
+	uint32_t t0 = radar_cycles();
+	for (uint32_t i = 0; i < CORE_OPS; i++) {
+		bench_sink += dedup_vehicle_check(&set, i & 3, (int64_t)i * 250, 60 + (i & 15), 5);
+	}
+	bench_report("dedup_vehicle_check", radar_cycles() - t0, CORE_OPS);
+}
+
+/**
+ * Measures the congestion detector update done for every vehicle.
+ */
+static void bench_congestion(void)
+{
+	static congestion_t det;
+
+	congestion_init(&det, 60000);
+	uint32_t t0 = radar_cycles();
+	for (uint32_t i = 0; i < CORE_OPS; i++) {
+		bench_sink += congestion_update(&det, (int64_t)i * 250, 5 + (i & 63), 400);
+	}
+	bench_report("congestion_update", radar_cycles() - t0, CORE_OPS);
+}
+
+/**
+ * Measures copying the newest records out of the log.
+ */
+static void bench_log_recent(void)
+{
+	infraction_record_t rec = {.type = VEHICLE_LIGHT, .speed_kmh = 80, .limit_kmh = 60};
+	infraction_record_t out[8];
+
+	for (int i = 0; i < CONFIG_RADAR_INFRACTION_LOG_SIZE; i++) {
+		infraction_log_add(&rec);
+	}
+	uint32_t t0 = radar_cycles();
+	for (uint32_t i = 0; i < CORE_OPS / 8; i++) {
+		bench_sink += (uint32_t)infraction_log_get_recent(ARRAY_SIZE(out), out);
+	}
+	bench_report("infraction_log_get_recent_8", radar_cycles() - t0, CORE_OPS / 8);
+}
+
+void bench_core_run(void)
+{
+	bench_fsm_vehicle();
+	bench_validation();
+	bench_dedup();
+	bench_vehicle_pipeline();
+	bench_congestion();
+	bench_log_recent();
+}
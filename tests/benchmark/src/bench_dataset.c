@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "dataset.h"
+
+/*
+ * Dataset parsing for the native_sim replay: the same vehicles as CSV
+ * and as binary records, parsed from memory. The replay's own rate is
+ * bounded by the control loop; this is the parser's share of it.
+ */
+
+#define DATASET_BENCH_VEHICLES 2048
+#define DATASET_BENCH_ROW_MAX  48
+
+static char dataset_csv[DATASET_BENCH_VEHICLES * DATASET_BENCH_ROW_MAX];
+static uint8_t dataset_bin[DATASET_MAGIC_SIZE + DATASET_BENCH_VEHICLES * DATASET_RECORD_SIZE];
+static volatile uint32_t dataset_sink;
+
+/**
+ * Writes the vehicles in both formats.
+ * @return The size of the CSV text.
+ */
+static size_t bench_dataset_build(void)
+{
+	uint32_t rng = 0x2545f491u;
+	uint32_t ts = 0;
+	size_t len = (size_t)snprintf(dataset_csv, sizeof(dataset_csv),
+				      "timestamp_ms,lane,duration_ms,axles,type,gross_weight_kg\n");
+
+	memcpy(dataset_bin, DATASET_MAGIC, DATASET_MAGIC_SIZE);
+	for (uint32_t i = 0; i < DATASET_BENCH_VEHICLES; i++) {
+		rng = rng * 1664525u + 1013904223u;
+		bool heavy = (rng >> 24) % 100 < 15;
+		uint32_t duration = 180 + (rng >> 8) % 540;
+		uint32_t axles = heavy ? 3 + (rng >> 4) % 4 : 2;
+		uint32_t weight = heavy ? axles * 7000 : 1500;
+		uint8_t lane = (uint8_t)(i % 4);
+		uint8_t *r = &dataset_bin[DATASET_MAGIC_SIZE + i * DATASET_RECORD_SIZE];
+
+		ts += 1 + (rng >> 16) % 900;
+		len += (size_t)snprintf(&dataset_csv[len], sizeof(dataset_csv) - len, "%u,%u,%u,%u,%c,%u\n",
+					ts, lane, duration, axles, heavy ? 'H' : 'L', weight);
+		memset(r, 0, DATASET_RECORD_SIZE);
+		for (int b = 0; b < 4; b++) {
+			r[b] = (uint8_t)(ts >> (8 * b));
+			r[12 + b] = (uint8_t)(weight >> (8 * b));
+		}
+		r[4] = (uint8_t)duration;
+		r[5] = (uint8_t)(duration >> 8);
+		r[6] = lane;
+		r[7] = (uint8_t)axles;
+		r[8] = heavy ? 1 : 0;
+	}
+	return len;
+}
+
+/**
+ * Parses a dataset to the end.
+ * @param name The benchmark name.
+ * @param data The dataset.
+ * @param size Its size.
+ */
+static void bench_dataset_parse(const char *name, const void *data, size_t size)
+{
+	dataset_t ds;
+	sensor_data_t s_data;
+	uint32_t vehicles = 0;
+
+	uint32_t t0 = radar_cycles();
+	dataset_open(&ds, data, size);
+	while (dataset_next(&ds, &s_data)) {
+		vehicles++;
+		dataset_sink += s_data.duration_ms;
+	}
+	uint32_t cycles = radar_cycles() - t0;
+
+	bench_report(name, cycles, vehicles);
+	if (vehicles != DATASET_BENCH_VEHICLES || ds.errors != 0) {
+		printk("%s: %u vehicles, %u errors\n", name, vehicles, ds.errors);
+	}
+}
+
+void bench_dataset_run(void)
+{
+	size_t csv_len = bench_dataset_build();
+
+	bench_dataset_parse("dataset_parse_csv", dataset_csv, csv_len);
+	bench_dataset_parse("dataset_parse_binary", dataset_bin, sizeof(dataset_bin));
+}
@@ -0,0 +1,111 @@
+#include "bench.h"
+#include "evidence.h"
+#include "lpr.h"
+
+/*
+ * Evidence frame compression on the synthetic camera frames of the plate
+ * recognizer: the integer DCT alone, then whole frames at a few quality
+ * levels, each with its compression ratio and time per frame. The peak
+ * memory line adds up what the evidence stage holds while compressing one
+ * frame at CONFIG_RADAR_EVIDENCE_QUALITY: the raw frame, the largest
+ * output and the encoder tables (the worker stack is
+ * CONFIG_RADAR_EVIDENCE_STACK_SIZE on top).
+ */
+
+#define EVIDENCE_BENCH_FRAMES 8
+
+static const struct {
+	uint8_t quality;
+	const char *name;
+	const char *ratio_name;
+} evidence_bench_levels[] = {
+	{25, "evidence_encode_q25", "evidence_ratio_q25"},
+	{50, "evidence_encode_q50", "evidence_ratio_q50"},
+	{75, "evidence_encode_q75", "evidence_ratio_q75"},
+	{90, "evidence_encode_q90", "evidence_ratio_q90"},
+};
+
+static const char *const evidence_bench_plates[] = {"RIO2A18", "ABC1D23", "QOD0B07", "WMW8M88"};
+
+static lpr_frame_t evidence_bench_frame;
+static evidence_encoder_t evidence_bench_encoder;
+// Raw frame size: no quality level comes close
+static uint8_t evidence_bench_jpeg[sizeof(lpr_frame_t)];
+
+/**
+ * Times the DCT over every block of one frame.
+ */
+static void bench_evidence_fdct(void)
+{
+	uint32_t blocks = 0;
+	uint64_t cycles = 0;
+	int16_t block[64];
+
+	lpr_sim_render(&evidence_bench_frame, evidence_bench_plates[0], 1, NULL);
+	for (uint32_t by = 0; by + EVIDENCE_BLOCK <= LPR_HEIGHT; by += EVIDENCE_BLOCK) {
+		for (uint32_t bx = 0; bx + EVIDENCE_BLOCK <= LPR_WIDTH; bx += EVIDENCE_BLOCK) {
+			for (uint32_t i = 0; i < 64; i++) {
+				block[i] = (int16_t)(evidence_bench_frame.pixels[by + i / 8][bx + i % 8] - 128);
+			}
+			uint32_t t0 = radar_cycles();
+			evidence_fdct(block);
+			cycles += radar_cycles() - t0;
+			blocks++;
+		}
+	}
+	bench_report("evidence_fdct", cycles, blocks);
+}
+
+void bench_evidence_run(void)
+{
+	size_t peak_jpeg = 0;
+
+	bench_evidence_fdct();
+
+	for (uint32_t l = 0; l < ARRAY_SIZE(evidence_bench_levels); l++) {
+		uint8_t quality = evidence_bench_levels[l].quality;
+		uint64_t cycles = 0;
+		uint64_t bytes = 0;
+		size_t largest = 0;
+		bool fits = true;
+
+		evidence_init(&evidence_bench_encoder, quality);
+		for (uint32_t i = 0; i < EVIDENCE_BENCH_FRAMES; i++) {
+			const char *plate = evidence_bench_plates[i % ARRAY_SIZE(evidence_bench_plates)];
+
+			lpr_sim_render(&evidence_bench_frame, plate, i + 1, NULL);
+
+			uint32_t t0 = radar_cycles();
+			size_t len = evidence_encode(&evidence_bench_encoder,
+						     &evidence_bench_frame.pixels[0][0], LPR_WIDTH,
+						     LPR_HEIGHT, LPR_WIDTH, evidence_bench_jpeg,
+						     sizeof(evidence_bench_jpeg));
+			cycles += radar_cycles() - t0;
+
+			fits = fits && len > 0;
+			bytes += len;
+			largest = MAX(largest, len);
+		}
+		if (!fits) {
+			printk("BENCH %-32s output over the raw frame size\n", evidence_bench_levels[l].name);
+			continue;
+		}
+		if (quality == CONFIG_RADAR_EVIDENCE_QUALITY) {
+			peak_jpeg = largest;
+		}
+
+		uint32_t ratio_x10 = (uint32_t)(sizeof(lpr_frame_t) * EVIDENCE_BENCH_FRAMES * 10 / bytes);
+		uint32_t us = (uint32_t)(cycles * 1000000u / radar_cycles_per_sec() / EVIDENCE_BENCH_FRAMES);
+
+		bench_report(evidence_bench_levels[l].name, cycles, EVIDENCE_BENCH_FRAMES);
+		printk("BENCH %-32s %6u.%u:1, %u bytes/frame, %u.%03u ms/frame (%ux%u)\n",
+		       evidence_bench_levels[l].ratio_name, ratio_x10 / 10, ratio_x10 % 10,
+		       (uint32_t)(bytes / EVIDENCE_BENCH_FRAMES), us / 1000, us % 1000, LPR_WIDTH,
+		       LPR_HEIGHT);
+	}
+
+	printk("BENCH %-32s %6u bytes (frame %u + jpeg %u + encoder %u), q%u\n", "evidence_peak_ram",
+	       (uint32_t)(sizeof(lpr_frame_t) + peak_jpeg + sizeof(evidence_encoder_t)),
+	       (uint32_t)sizeof(lpr_frame_t), (uint32_t)peak_jpeg,
+	       (uint32_t)sizeof(evidence_encoder_t), CONFIG_RADAR_EVIDENCE_QUALITY);
+}
@@ -0,0 +1,24 @@
+#include "bench.h"
+#include "flight_recorder.h"
+
+#define FLIGHT_OPS 4096
+
+/**
+ * Measures the per-event cost every pipeline stage pays for the recorder:
+ * one atomic increment, the uptime read and one packed 64-bit store.
+ */
+static void bench_flight_record(void)
+{
+	flight_recorder_init();
+
+	uint32_t t0 = radar_cycles();
+	for (int i = 0; i < FLIGHT_OPS; i++) {
+		flight_recorder_record(FLIGHT_EV_SPEED, 2, (uint16_t)i);
+	}
+	bench_report("flight_recorder_record", radar_cycles() - t0, FLIGHT_OPS);
+}
+
+void bench_flight_run(void)
+{
+	bench_flight_record();
+}
@@ -0,0 +1,69 @@
+#include "bench.h"
+#include "congestion.h"
+#include "dedup.h"
+#include "flight_recorder.h"
+#include "histogram.h"
+#include "infraction_log.h"
+#include "telemetry.h"
+#include "wim.h"
+
+#ifndef CONFIG_RADAR_CORE_RAM_BUDGET
+#define CONFIG_RADAR_CORE_RAM_BUDGET 8192
+#endif
+
+/**
+ * Prints one line of the core RAM model.
+ * @param name The state being accounted.
+ * @param bytes Its static size.
+ * @return The size, for summing.
+ */
+static size_t footprint_line(const char *name, size_t bytes)
+{
+	printk("BENCH %-32s %10u bytes\n", name, (uint32_t)bytes);
+	return bytes;
+}
+
+/**
+ * Sums the static RAM the current configuration gives the portable core
+ * and checks it against CONFIG_RADAR_CORE_RAM_BUDGET. Sizes come from the
+ * same types and Kconfig values the modules use, so growing a ring or
+ * a record shows up here.
+ * @return True if the configuration fits the budget.
+ */
+bool bench_footprint_run(void)
+{
+	size_t total = 0;
+
+	// Each slot carries its commit generation and one bit of lost mark
+	total += footprint_line("ram_infraction_log",
+				(sizeof(infraction_record_t) + sizeof(radar_atomic_t)) *
+					CONFIG_RADAR_INFRACTION_LOG_SIZE +
+				sizeof(radar_atomic_t) * ((CONFIG_RADAR_INFRACTION_LOG_SIZE +
+							   8 * sizeof(radar_atomic_val_t) - 1) /
+							  (8 * sizeof(radar_atomic_val_t))));
+#if IS_ENABLED(CONFIG_RADAR_INFRACTION_CHAIN)
+	total += footprint_line("ram_chain_checkpoints",
+				sizeof(infraction_checkpoint_t) * CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINTS);
+#endif
+#if IS_ENABLED(CONFIG_RADAR_FLIGHT_RECORDER)
+	total += footprint_line("ram_flight_recorder", sizeof(flight_ring_t));
+#endif
+#if IS_ENABLED(CONFIG_RADAR_DEDUP)
+	total += footprint_line("ram_dedup_sets", 2 * sizeof(dedup_set_t));
+#endif
+#if IS_ENABLED(CONFIG_RADAR_CONGESTION)
+	total += footprint_line("ram_congestion", sizeof(congestion_t));
+#endif
+#if IS_ENABLED(CONFIG_RADAR_WIM)
+	total += footprint_line("ram_wim", sizeof(wim_t) + sizeof(wim_sim_t));
+#endif
+	// Live histograms plus the telemetry thread's snapshot and dump buffers
+	total += footprint_line("ram_telemetry_histograms",
+				TELEMETRY_HIST_COUNT * sizeof(histogram_t) + sizeof(histogram_snapshot_t) +
+					HISTOGRAM_DUMP_MAX);
+
+	bool fits = total <= CONFIG_RADAR_CORE_RAM_BUDGET;
+	printk("BENCH %-32s %10u bytes (budget %u) %s\n", "ram_core_total", (uint32_t)total,
+	       CONFIG_RADAR_CORE_RAM_BUDGET, fits ? "OK" : "OVER BUDGET");
+	return fits;
+}
@@ -0,0 +1,163 @@
+#include "bench.h"
+#include "common.h"
+#include "sensor_fsm.h"
+
+/*
+ * Table-driven sensor FSM against the hand-coded one it replaced. Both run
+ * the same event stream, generated at runtime so neither can be folded away.
+ */
+
+#define FSM_EVENTS 4096
+
+typedef struct {
+	uint8_t event;
+	int64_t timestamp_ms;
+} bench_fsm_event_t;
+
+static bench_fsm_event_t fsm_stream[FSM_EVENTS];
+static volatile uint32_t fsm_sink;
+
+// The hand-coded FSM as it was before the table, for reference only
+typedef struct {
+	bool active;
+	int64_t start_time;
+	int64_t end_time;
+	uint32_t axle_count;
+	bool speed_measured;
+} legacy_fsm_t;
+
+static inline void legacy_fsm_handle_start(legacy_fsm_t *fsm, int64_t timestamp_ms)
+{
+	if (!fsm->active) {
+		fsm->active = true;
+		fsm->start_time = timestamp_ms;
+		fsm->end_time = 0;
+		fsm->axle_count = 1;
+		fsm->speed_measured = false;
+	} else {
+		fsm->axle_count++;
+	}
+}
+
+static inline void legacy_fsm_handle_end(legacy_fsm_t *fsm, int64_t timestamp_ms)
+{
+	if (fsm->active && !fsm->speed_measured) {
+		fsm->end_time = timestamp_ms;
+		fsm->speed_measured = true;
+	}
+}
+
+static inline bool legacy_fsm_finalize(legacy_fsm_t *fsm, sensor_data_t *out_data)
+{
+	if (!fsm->active) {
+		return false;
+	}
+
+	bool produced = false;
+	if (fsm->speed_measured && fsm->end_time > fsm->start_time) {
+		out_data->timestamp_start = fsm->start_time;
+		out_data->timestamp_end = fsm->end_time;
+		out_data->duration_ms = (uint32_t)(fsm->end_time - fsm->start_time);
+		out_data->axle_count = fsm->axle_count;
+		out_data->type = classify_axles(fsm->axle_count);
+		produced = true;
+	}
+	fsm->active = false;
+	fsm->start_time = 0;
+	fsm->end_time = 0;
+	fsm->axle_count = 0;
+	fsm->speed_measured = false;
+	return produced;
+}
+
+/**
+ * Fills the stream with vehicles of 1 to 4 axles, some with a stray
+ * second end edge, each closed by a timeout.
+ */
+static void bench_fsm_stream(void)
+{
+	uint32_t rng = 0x2545f491u;
+	int64_t now = 0;
+	int n = 0;
+
+	while (n < FSM_EVENTS - 8) {
+		rng = rng * 1664525u + 1013904223u;
+		uint32_t axles = 1 + (rng >> 30);
+
+		for (uint32_t a = 0; a < axles; a++) {
+			fsm_stream[n++] = (bench_fsm_event_t){SENSOR_EV_START, now};
+			now += 80 + ((rng >> 8) & 63);
+		}
+		fsm_stream[n++] = (bench_fsm_event_t){SENSOR_EV_END, now};
+		if (rng & 0x100) {
+			fsm_stream[n++] = (bench_fsm_event_t){SENSOR_EV_END, now + 5};
+		}
+		now += 2000;
+		fsm_stream[n++] = (bench_fsm_event_t){SENSOR_EV_TIMEOUT, now};
+	}
+	while (n < FSM_EVENTS) {
+		fsm_stream[n++] = (bench_fsm_event_t){SENSOR_EV_TIMEOUT, now};
+	}
+}
+
+/**
+ * Measures cycles per event of the hand-coded FSM.
+ */
+static void bench_fsm_legacy(void)
+{
+	legacy_fsm_t fsm = {0};
+	sensor_data_t out;
+	uint32_t sum = 0;
+
+	uint32_t t0 = radar_cycles();
+	for (int i = 0; i < FSM_EVENTS; i++) {
+		const bench_fsm_event_t *ev = &fsm_stream[i];
+
+		switch (ev->event) {
+		case SENSOR_EV_START:
+			legacy_fsm_handle_start(&fsm, ev->timestamp_ms);
+			break;
+		case SENSOR_EV_END:
+			legacy_fsm_handle_end(&fsm, ev->timestamp_ms);
+			break;
+		default:
+			sum += legacy_fsm_finalize(&fsm, &out) ? out.duration_ms : 0;
+			break;
+		}
+	}
+	bench_report("fsm_event_legacy", radar_cycles() - t0, FSM_EVENTS);
+	fsm_sink = sum;
+}
+
+/**
+ * Measures cycles per event of the table-driven FSM.
+ */
+static void bench_fsm_table(void)
+{
+	sensor_fsm_t fsm;
+	sensor_data_t out;
+	uint32_t sum = 0;
+
+	sensor_fsm_init(&fsm);
+	uint32_t t0 = radar_cycles();
+	for (int i = 0; i < FSM_EVENTS; i++) {
+		sensor_fsm_arg_t arg = {.timestamp_ms = fsm_stream[i].timestamp_ms, .out = &out};
+
+		if (sensor_fsm_dispatch(&fsm, fsm_stream[i].event, arg)) {
+			sum += out.duration_ms;
+		}
+	}
+	bench_report("fsm_event_table", radar_cycles() - t0, FSM_EVENTS);
+
+	if (sum != fsm_sink) {
+		printk("fsm_event_table: measurements differ from the hand-coded FSM\n");
+	}
+	fsm_sink = sum;
+}
+
+void bench_fsm_run(void)
+{
+	bench_fsm_stream();
+	bench_fsm_legacy();
+	bench_fsm_table();
+}
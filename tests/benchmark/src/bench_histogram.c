@@ -0,0 +1,68 @@
+#include "bench.h"
+#include "histogram.h"
+
+#define HIST_OPS    4096
+#define HIST_ROUNDS 16
+
+static histogram_t hist;
+static histogram_snapshot_t snap;
+static uint8_t dump[HISTOGRAM_DUMP_MAX];
+static volatile uint32_t bench_sink;
+
+/**
+ * Measures histogram_record() over values spread across many buckets.
+ * This is the cost every instrumented ISR or thread pays per sample.
+ */
+static void bench_histogram_record(void)
+{
+	uint32_t value = 1;
+
+	histogram_reset(&hist);
+	uint32_t t0 = radar_cycles();
+	for (int i = 0; i < HIST_OPS; i++) {
+		histogram_record(&hist, value);
+		value = value * 1103515245u + 12345u;
+	}
+	bench_report("histogram_record", radar_cycles() - t0, HIST_OPS);
+}
+
+/**
+ * Measures the reader side: snapshot, three percentiles and the binary dump.
+ */
+static void bench_histogram_read(void)
+{
+	uint32_t t0 = radar_cycles();
+	for (int i = 0; i < HIST_ROUNDS; i++) {
+		histogram_snapshot(&hist, &snap);
+	}
+	bench_report("histogram_snapshot", radar_cycles() - t0, HIST_ROUNDS);
+
+	t0 = radar_cycles();
+	for (int i = 0; i < HIST_ROUNDS; i++) {
+		bench_sink += histogram_percentile(&snap, 5000) + histogram_percentile(&snap, 9900) +
+			      histogram_max(&snap);
+	}
+	bench_report("histogram_percentiles_x3", radar_cycles() - t0, HIST_ROUNDS);
+
+	size_t len = 0;
+
+	t0 = radar_cycles();
+	for (int i = 0; i < HIST_ROUNDS; i++) {
+		len = histogram_encode(&snap, dump, sizeof(dump));
+	}
+	bench_report("histogram_encode", radar_cycles() - t0, HIST_ROUNDS);
+
+	uint32_t used = 0;
+
+	for (uint32_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+		used += snap.counts[i] != 0;
+	}
+	printk("BENCH %-32s %10u bytes (%u of %u buckets used)\n", "histogram_dump_size", (uint32_t)len,
+	       used, (uint32_t)HISTOGRAM_BUCKETS);
+}
+
+void bench_histogram_run(void)
+{
+	bench_histogram_record();
+	bench_histogram_read();
+}
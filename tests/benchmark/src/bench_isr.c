@@ -0,0 +1,132 @@
+#include "bench.h"
+#include "common.h"
+#include "flight_recorder.h"
+#include "sensor_fsm.h"
+#if defined(__ZEPHYR__)
+#include <zephyr/irq_offload.h>
+#endif
+
+#define ISR_OPS 1024
+
+static sensor_fsm_t isr_fsm;
+static radar_lock_t isr_lock;
+static volatile uint32_t isr_entry_cycles;
+
+/**
+ * Same work as the sensor port ISR: one timestamp, a flight record per
+ * edge and one locked FSM update for all pending edges. Tagged RADAR_HOT
+ * like it so the perf profile measures the RAM placement too.
+ * @param start True if the start sensor had an edge.
+ * @param end True if the end sensor had an edge.
+ */
+RADAR_HOT static void bench_edge_body(bool start, bool end)
+{
+	uint32_t cycles = radar_cycles();
+	int64_t now = radar_uptime_ms();
+
+	if (start) {
+		FLIGHT_RECORD(FLIGHT_EV_EDGE_START, 0, 0);
+	}
+	if (end) {
+		FLIGHT_RECORD(FLIGHT_EV_EDGE_END, 0, 0);
+	}
+	radar_lock_key_t key = radar_lock(&isr_lock);
+	sensor_fsm_handle_edges(&isr_fsm, start, end, now, cycles);
+	radar_unlock(&isr_lock, key);
+}
+
+/**
+ * Measures the body of one sensor edge interrupt, without entry and exit,
+ * and the cost of two edges captured together against two interrupts.
+ */
+static void bench_isr_body(void)
+{
+	sensor_fsm_init(&isr_fsm);
+	uint32_t t0 = radar_cycles();
+	for (int i = 0; i < ISR_OPS; i++) {
+		bench_edge_body((i & 1) == 0, (i & 1) != 0);
+	}
+	bench_report("isr_edge_body", radar_cycles() - t0, ISR_OPS);
+
+	sensor_fsm_init(&isr_fsm);
+	t0 = radar_cycles();
+	for (int i = 0; i < ISR_OPS; i++) {
+		bench_edge_body(true, false);
+		bench_edge_body(false, true);
+	}
+	bench_report("isr_edge_pair_separate", radar_cycles() - t0, ISR_OPS);
+
+	sensor_fsm_init(&isr_fsm);
+	t0 = radar_cycles();
+	for (int i = 0; i < ISR_OPS; i++) {
+		bench_edge_body(true, true);
+	}
+	bench_report("isr_edge_pair_combined", radar_cycles() - t0, ISR_OPS);
+}
+
+#if defined(__ZEPHYR__)
+/**
+ * Offloaded handler: stamps its entry time, then runs the edge body.
+ * @param param Unused.
+ */
+static void bench_offload_handler(const void *param)
+{
+	ARG_UNUSED(param);
+	isr_entry_cycles = radar_cycles();
+	bench_edge_body(true, false);
+}
+
+/**
+ * Measures the latency from raising a software interrupt to the first
+ * instruction of its handler, plus the complete round trip.
+ */
+static void bench_isr_latency(void)
+{
+	uint64_t entry = 0;
+	uint64_t total = 0;
+	uint32_t worst = 0;
+
+	sensor_fsm_init(&isr_fsm);
+	for (int i = 0; i < ISR_OPS; i++) {
+		uint32_t t0 = radar_cycles();
+		irq_offload(bench_offload_handler, NULL);
+		uint32_t t1 = radar_cycles();
+		uint32_t dt = isr_entry_cycles - t0;
+
+		entry += dt;
+		worst = MAX(worst, dt);
+		total += t1 - t0;
+	}
+	bench_report("isr_entry_latency", entry, ISR_OPS);
+	bench_report("isr_entry_latency_worst", worst, 1);
+	bench_report("isr_round_trip", total, ISR_OPS);
+}
+
+K_MSGQ_DEFINE(bench_msgq, sizeof(sensor_data_t), 4, 4);
+
+/**
+ * Measures one measurement through a message queue, as between the
+ * axle timer and the control thread.
+ */
+static void bench_msgq_round_trip(void)
+{
+	sensor_data_t in = {.duration_ms = 300, .axle_count = 2, .type = VEHICLE_LIGHT};
+	sensor_data_t out;
+
+	uint32_t t0 = radar_cycles();
+	for (int i = 0; i < ISR_OPS; i++) {
+		(void)k_msgq_put(&bench_msgq, &in, K_NO_WAIT);
+		(void)k_msgq_get(&bench_msgq, &out, K_NO_WAIT);
+	}
+	bench_report("msgq_put_get", radar_cycles() - t0, ISR_OPS);
+}
+#endif
+
+void bench_isr_run(void)
+{
+	bench_isr_body();
+#if defined(__ZEPHYR__)
+	bench_isr_latency();
+	bench_msgq_round_trip();
+#endif
+}
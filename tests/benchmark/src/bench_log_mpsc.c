@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "infraction_log.h"
+
+/*
+ * Append throughput of the infraction log with 1 to 8 producers adding at
+ * once. Each producer is a thread of its own; on an SMP target they run
+ * on separate cores and only meet on the sequence counter. The time is
+ * wall time from the start signal until the last producer is done, so
+ * ns/op is the inverse of the aggregate throughput.
+ */
+
+#define MPSC_MAX_PRODUCERS 8
+#define MPSC_RECORDS       2048
+#define MPSC_STACK_SIZE    1024
+
+static radar_atomic_t mpsc_go;
+static infraction_record_t mpsc_recent[CONFIG_RADAR_INFRACTION_LOG_SIZE];
+
+/**
+ * Producer body: waits for the start signal, then appends its records.
+ * @param id The producer number, stored in each record.
+ */
+static void mpsc_produce(uint32_t id)
+{
+	infraction_record_t rec = {
+		.type = VEHICLE_HEAVY,
+		.speed_kmh = 90,
+		.limit_kmh = 60,
+		.valid_read = true,
+	};
+	strcpy(rec.plate, "MPS0C00");
+	rec.plate[3] = (char)('0' + id);
+
+	while (radar_atomic_get(&mpsc_go) == 0) {
+	}
+	for (uint32_t i = 0; i < MPSC_RECORDS; i++) {
+		rec.timestamp_ms = i;
+		infraction_log_add(&rec);
+	}
+}
+
+#if defined(__ZEPHYR__)
+K_THREAD_STACK_ARRAY_DEFINE(mpsc_stacks, MPSC_MAX_PRODUCERS, MPSC_STACK_SIZE);
+static struct k_thread mpsc_threads[MPSC_MAX_PRODUCERS];
+
+static void mpsc_entry(void *p1, void *p2, void *p3)
+{
+	mpsc_produce((uint32_t)(uintptr_t)p1);
+}
+
+/**
+ * Runs the producers to completion.
+ * @param producers The number of producers.
+ * @return Cycles from the start signal until the last one finished.
+ */
+static uint32_t mpsc_run(uint32_t producers)
+{
+	// Below main, so they only spin on the signal once main blocks or on other cores
+	for (uint32_t p = 0; p < producers; p++) {
+		k_thread_create(&mpsc_threads[p], mpsc_stacks[p], K_THREAD_STACK_SIZEOF(mpsc_stacks[p]),
+				mpsc_entry, (void *)(uintptr_t)p, NULL, NULL, K_PRIO_PREEMPT(1), 0,
+				K_NO_WAIT);
+	}
+	uint32_t t0 = radar_cycles();
+	radar_atomic_set(&mpsc_go, 1);
+	for (uint32_t p = 0; p < producers; p++) {
+		k_thread_join(&mpsc_threads[p], K_FOREVER);
+	}
+	return radar_cycles() - t0;
+}
+#else
+static pthread_t mpsc_threads[MPSC_MAX_PRODUCERS];
+
+static void *mpsc_entry(void *arg)
+{
+	mpsc_produce((uint32_t)(uintptr_t)arg);
+	return NULL;
+}
+
+/**
+ * Runs the producers to completion.
+ * @param producers The number of producers.
+ * @return Nanoseconds from the start signal until the last one finished.
+ */
+static uint32_t mpsc_run(uint32_t producers)
+{
+	for (uint32_t p = 0; p < producers; p++) {
+		pthread_create(&mpsc_threads[p], NULL, mpsc_entry, (void *)(uintptr_t)p);
+	}
+	uint32_t t0 = radar_cycles();
+	radar_atomic_set(&mpsc_go, 1);
+	for (uint32_t p = 0; p < producers; p++) {
+		pthread_join(mpsc_threads[p], NULL);
+	}
+	return radar_cycles() - t0;
+}
+#endif
+
+/**
+ * Checks that the ring holds consecutive committed records after a run.
+ * @return True if it does.
+ */
+static bool mpsc_ring_consistent(void)
+{
+	size_t n = infraction_log_get_recent(ARRAY_SIZE(mpsc_recent), mpsc_recent);
+
+	for (size_t i = 1; i < n; i++) {
+		if (mpsc_recent[i].seq + 1 != mpsc_recent[i - 1].seq) {
+			return false;
+		}
+	}
+	return n == ARRAY_SIZE(mpsc_recent);
+}
+
+void bench_log_mpsc_run(void)
+{
+	char name[32];
+
+	for (uint32_t producers = 1; producers <= MPSC_MAX_PRODUCERS; producers *= 2) {
+		uint32_t before;
+		uint32_t after;
+
+		radar_atomic_set(&mpsc_go, 0);
+		infraction_log_get_counters(NULL, NULL, &before, NULL);
+		uint32_t cycles = mpsc_run(producers);
+		infraction_log_get_counters(NULL, NULL, &after, NULL);
+
+		snprintf(name, sizeof(name), "infraction_log_add_mpsc_%up", producers);
+		bench_report(name, cycles, producers * MPSC_RECORDS);
+		if (after - before != producers * MPSC_RECORDS || !mpsc_ring_consistent()) {
+			printk("%s: %u appends counted of %u, ring %s\n", name, after - before,
+			       producers * MPSC_RECORDS, mpsc_ring_consistent() ? "ok" : "torn");
+		}
+		printk("BENCH %s_lost %u\n", name, infraction_log_get_lost());
+	}
+}
@@ -0,0 +1,126 @@
+#include <string.h>
+#include "bench.h"
+#include "lpr.h"
+
+/*
+ * Plate recognition on synthetic camera frames: vertical edge map and its
+ * integral image, the plate window search, then template-matching OCR of
+ * the crop. Each frame is rendered before its timing starts, so only the
+ * kernels are measured. The ms/frame lines tell whether on-device LPR fits
+ * the camera's capture budget (CONFIG_RADAR_CAMERA_CAPTURE_MS). Accuracy
+ * is counted on clean plates and on plates with a smudged character,
+ * which should be rejected rather than misread.
+ */
+
+#define LPR_BENCH_FRAMES  32
+#define LPR_BENCH_SMUDGED 16
+
+typedef struct {
+	uint32_t read;     // Whole plate right
+	uint32_t chars;    // Characters right, rejected reads included
+	uint32_t rejected; // Not located, or below the confidence threshold
+	uint32_t misread;  // Accepted with a wrong character
+} bench_lpr_accuracy_t;
+
+static lpr_frame_t lpr_bench_frame;
+static lpr_integral_t lpr_bench_integral;
+
+/**
+ * Makes a random Mercosul plate.
+ * @param rng Pointer to the generator state.
+ * @param plate Output, LPR_PLATE_CHARS + 1 bytes.
+ */
+static void bench_lpr_plate(uint32_t *rng, char *plate)
+{
+	for (uint32_t i = 0; i < LPR_PLATE_CHARS; i++) {
+		*rng = *rng * 1664525u + 1013904223u;
+		bool digit = i == 3 || i == 5 || i == 6;
+		plate[i] = digit ? (char)('0' + (*rng >> 8) % 10) : (char)('A' + (*rng >> 8) % 26);
+	}
+	plate[LPR_PLATE_CHARS] = '\0';
+}
+
+/**
+ * Scores one read against the plate drawn.
+ * @param acc Pointer to the counts.
+ * @param plate The plate drawn.
+ * @param read The read.
+ * @param accepted Whether the read was accepted.
+ */
+static void bench_lpr_score(bench_lpr_accuracy_t *acc, const char *plate, const lpr_read_t *read,
+			    bool accepted)
+{
+	bool right = strcmp(read->plate, plate) == 0;
+
+	for (uint32_t i = 0; i < LPR_PLATE_CHARS; i++) {
+		acc->chars += read->plate[i] == plate[i];
+	}
+	acc->read += accepted && right;
+	acc->rejected += !accepted;
+	acc->misread += accepted && !right;
+}
+
+/**
+ * Prints a time per frame in milliseconds.
+ * @param name The stage.
+ * @param cycles Total cycles over the frames.
+ * @param frames The number of frames.
+ */
+static void bench_lpr_ms(const char *name, uint64_t cycles, uint32_t frames)
+{
+	uint32_t us = (uint32_t)(cycles * 1000000u / radar_cycles_per_sec() / frames);
+
+	printk("BENCH %-32s %6u.%03u ms/frame (%ux%u)\n", name, us / 1000, us % 1000, LPR_WIDTH,
+	       LPR_HEIGHT);
+}
+
+void bench_lpr_run(void)
+{
+	bench_lpr_accuracy_t clean = {0};
+	bench_lpr_accuracy_t smudged = {0};
+	uint64_t integral_cycles = 0;
+	uint64_t search_cycles = 0;
+	uint64_t read_cycles = 0;
+	uint32_t rng = 0x1f123bb5u;
+	char plate[LPR_PLATE_CHARS + 1];
+
+	for (uint32_t i = 0; i < LPR_BENCH_FRAMES + LPR_BENCH_SMUDGED; i++) {
+		bool smudge = i >= LPR_BENCH_FRAMES;
+		lpr_rect_t where;
+		lpr_rect_t crop;
+		lpr_read_t read = {0};
+
+		bench_lpr_plate(&rng, plate);
+		lpr_sim_render(&lpr_bench_frame, plate, i + 1, &where);
+		if (smudge) {
+			lpr_sim_smudge(&lpr_bench_frame, &where, i + 1);
+		}
+
+		uint32_t t0 = radar_cycles();
+		lpr_integral(&lpr_bench_frame, &lpr_bench_integral);
+		uint32_t t1 = radar_cycles();
+		bool located = lpr_search(&lpr_bench_integral, &crop);
+		uint32_t t2 = radar_cycles();
+		bool accepted = located && lpr_read(&lpr_bench_frame, &crop, &read);
+		uint32_t t3 = radar_cycles();
+
+		if (!smudge) {
+			integral_cycles += t1 - t0;
+			search_cycles += t2 - t1;
+			read_cycles += t3 - t2;
+		}
+		bench_lpr_score(smudge ? &smudged : &clean, plate, &read, accepted);
+	}
+
+	bench_report("lpr_edge_integral", integral_cycles, LPR_BENCH_FRAMES);
+	bench_report("lpr_window_search", search_cycles, LPR_BENCH_FRAMES);
+	bench_report("lpr_read", read_cycles, LPR_BENCH_FRAMES);
+	bench_lpr_ms("lpr_locate", integral_cycles + search_cycles, LPR_BENCH_FRAMES);
+	bench_lpr_ms("lpr_locate_read", integral_cycles + search_cycles + read_cycles,
+		     LPR_BENCH_FRAMES);
+	printk("BENCH %-32s %u/%u plates %u/%u chars, %u rejected %u misread\n", "lpr_accuracy_clean",
+	       clean.read, LPR_BENCH_FRAMES, clean.chars, LPR_BENCH_FRAMES * LPR_PLATE_CHARS,
+	       clean.rejected, clean.misread);
+	printk("BENCH %-32s %u/%u plates, %u rejected %u misread\n", "lpr_accuracy_smudged",
+	       smudged.read, LPR_BENCH_SMUDGED, smudged.rejected, smudged.misread);
+}
@@ -0,0 +1,90 @@
+#include <string.h>
+#include "bench.h"
+#include "schema.h"
+
+/*
+ * Schema encoders and decoders, per record, for every pipeline message.
+ * The decoders include their range checks. A plain struct copy of an
+ * infraction record gives the floor a host-endian, padded dump would cost.
+ */
+
+#define SCHEMA_BENCH_RECORDS 2048
+
+static uint8_t schema_bench_buf[SCHEMA_MAX_SIZE];
+static uint32_t schema_bench_sink;
+
+/*
+ * Times encoding and decoding of one message type. The sink keeps the
+ * compiler from dropping calls whose results are never used.
+ */
+#define BENCH_SCHEMA(name, type, msg)                                                              \
+	do {                                                                                       \
+		type decoded;                                                                      \
+		uint32_t t0 = radar_cycles();                                                      \
+                                                                                                   \
+		for (uint32_t i = 0; i < SCHEMA_BENCH_RECORDS; i++) {                              \
+			schema_bench_sink += schema_encode_##name(&(msg), schema_bench_buf,        \
+								  sizeof(schema_bench_buf));       \
+		}                                                                                  \
+		bench_report("schema_encode_" #name, radar_cycles() - t0, SCHEMA_BENCH_RECORDS);  \
+		t0 = radar_cycles();                                                               \
+		for (uint32_t i = 0; i < SCHEMA_BENCH_RECORDS; i++) {                              \
+			schema_bench_sink += schema_decode_##name(schema_bench_buf,                \
+								  sizeof(schema_bench_buf),        \
+								  &decoded);                       \
+		}                                                                                  \
+		bench_report("schema_decode_" #name, radar_cycles() - t0, SCHEMA_BENCH_RECORDS);  \
+	} while (0)
+
+void bench_schema_run(void)
+{
+	sensor_data_t sensor = {
+		.timestamp_start = 1000,
+		.timestamp_end = 1180,
+		.duration_ms = 180,
+		.axle_count = 2,
+		.type = VEHICLE_LIGHT,
+		.gross_weight_kg = 1400,
+	};
+	display_data_t display = {
+		.speed_kmh = 97,
+		.limit_kmh = 80,
+		.type = VEHICLE_LIGHT,
+		.status = STATUS_INFRACTION,
+		.plate = "RIO2A18",
+		.warning_kmh = 72,
+	};
+	camera_trigger_t trigger = {
+		.speed_kmh = 97,
+		.type = VEHICLE_LIGHT,
+		.id = 42,
+		.timestamp_ms = 1180,
+	};
+	camera_result_t result = {.plate = "RIO2A18", .valid_read = true, .id = 42};
+	infraction_record_t record = {
+		.timestamp_ms = 1180,
+		.type = VEHICLE_LIGHT,
+		.speed_kmh = 97,
+		.limit_kmh = 80,
+		.valid_read = true,
+		.plate = "RIO2A18",
+		.seq = 7,
+	};
+
+	BENCH_SCHEMA(sensor_data, sensor_data_t, sensor);
+	BENCH_SCHEMA(display_data, display_data_t, display);
+	BENCH_SCHEMA(camera_trigger, camera_trigger_t, trigger);
+	BENCH_SCHEMA(camera_result, camera_result_t, result);
+	BENCH_SCHEMA(infraction_record, infraction_record_t, record);
+
+	infraction_record_t copies[2];
+	uint32_t t0 = radar_cycles();
+
+	for (uint32_t i = 0; i < SCHEMA_BENCH_RECORDS; i++) {
+		memcpy(&copies[i & 1], &record, sizeof(record));
+		schema_bench_sink += copies[i & 1].seq;
+	}
+	bench_report("schema_memcpy_infraction_record", radar_cycles() - t0, SCHEMA_BENCH_RECORDS);
+	printk("BENCH %-32s %u bytes encoded vs %u in memory\n", "schema_infraction_record_size",
+	       (uint32_t)SCHEMA_INFRACTION_RECORD_SIZE, (uint32_t)sizeof(infraction_record_t));
+}
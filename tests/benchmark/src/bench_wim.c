@@ -0,0 +1,108 @@
+#include "bench.h"
+#include "wim.h"
+
+/*
+ * Weigh-in-motion detector over a recorded strip signal: vehicles of two to
+ * four axles at 60 to 120 km/h, with idle strip between them. The signal is
+ * generated once, so only the detector is timed.
+ */
+
+#define WIM_BENCH_SAMPLES 16384
+#define WIM_BENCH_VEHICLES 16
+#define WIM_BENCH_BLOCK 20
+#define WIM_BENCH_DISTANCE_MM 5000
+
+typedef struct {
+	uint32_t end;         // Sample index after which the vehicle has left the strip
+	uint32_t duration_ms; // Between the speed sensors
+	uint32_t gross_weight_kg;
+} bench_wim_vehicle_t;
+
+static uint16_t wim_stream[WIM_BENCH_SAMPLES];
+static bench_wim_vehicle_t wim_vehicles[WIM_BENCH_VEHICLES];
+static uint32_t wim_vehicle_count;
+static wim_sim_t wim_bench_sim;
+static wim_t wim_bench;
+static volatile uint32_t wim_sink;
+
+/**
+ * Records the strip signal of a stream of random vehicles.
+ */
+static void bench_wim_stream(void)
+{
+	uint32_t rng = 0x6b43a9b5u;
+	uint32_t n = 0;
+
+	wim_sim_init(&wim_bench_sim, 512, 8, rng);
+	wim_vehicle_count = 0;
+	while (wim_vehicle_count < WIM_BENCH_VEHICLES) {
+		rng = rng * 1664525u + 1013904223u;
+		uint32_t speed_kmh = 60 + (rng >> 8) % 61;
+		uint32_t axles = 2 + (rng >> 20) % 3;
+		uint32_t axle_kg = 600 + (rng >> 4) % 9000;
+		uint32_t speed_mm_s = speed_kmh * 1000000u / 3600u;
+		uint32_t spacing = (3000u * CONFIG_RADAR_WIM_SAMPLE_HZ) / speed_mm_s;
+		uint32_t end = n + 100 + axles * spacing;
+
+		if (end + WIM_BENCH_BLOCK > WIM_BENCH_SAMPLES) {
+			break;
+		}
+		for (uint32_t a = 0; a < axles; a++) {
+			(void)wim_sim_add_axle(&wim_bench_sim, n + 50 + a * spacing, axle_kg, speed_mm_s);
+		}
+		wim_sim_read(&wim_bench_sim, &wim_stream[n], end - n);
+		wim_vehicles[wim_vehicle_count++] = (bench_wim_vehicle_t){
+			.end = end,
+			.duration_ms = (WIM_BENCH_DISTANCE_MM * 36) / (speed_kmh * 10),
+			.gross_weight_kg = axles * axle_kg,
+		};
+		n = end;
+	}
+}
+
+/**
+ * Measures cycles per sample and per vehicle: blocks of samples through
+ * the detector, and the weight of each vehicle once it has left the strip.
+ */
+static void bench_wim_detect(void)
+{
+	uint32_t samples = wim_vehicles[wim_vehicle_count - 1].end;
+	uint32_t weights[WIM_BENCH_VEHICLES];
+	uint32_t v = 0;
+	uint32_t sum = 0;
+
+	wim_init(&wim_bench, CONFIG_RADAR_WIM_THRESHOLD);
+	uint32_t t0 = radar_cycles();
+	for (uint32_t n = 0; n < samples; n += WIM_BENCH_BLOCK) {
+		uint32_t count = MIN(WIM_BENCH_BLOCK, samples - n);
+
+		sum += wim_feed(&wim_bench, &wim_stream[n], count);
+		if (n + count >= wim_vehicles[v].end) {
+			weights[v] = wim_gross_weight_kg(&wim_bench, WIM_BENCH_DISTANCE_MM,
+							 wim_vehicles[v].duration_ms);
+			wim_vehicle_reset(&wim_bench);
+			v++;
+		}
+	}
+	uint32_t cycles = radar_cycles() - t0;
+
+	bench_report("wim_sample", cycles, samples);
+	bench_report("wim_vehicle", cycles, wim_vehicle_count);
+	wim_sink = sum;
+
+	for (uint32_t i = 0; i < wim_vehicle_count; i++) {
+		uint32_t truth = wim_vehicles[i].gross_weight_kg;
+		uint32_t error = weights[i] > truth ? weights[i] - truth : truth - weights[i];
+
+		if (error * 20 > truth) {
+			printk("wim_vehicle: vehicle %u weighed %u kg, actual %u kg\n", i, weights[i],
+			       truth);
+		}
+	}
+}
+
+void bench_wim_run(void)
+{
+	bench_wim_stream();
+	bench_wim_detect();
+}
@@ -0,0 +1,29 @@
+#include "bench.h"
+
+int main(void)
+{
+	printk("Radar benchmarks on %s, %u cycles/s\n", CONFIG_BOARD, radar_cycles_per_sec());
+
+	bench_core_run();
+	bench_fsm_run();
+	bench_isr_run();
+	bench_wim_run();
+	bench_camera_run();
+	bench_lpr_run();
+	bench_evidence_run();
+	bench_dataset_run();
+	bench_console_run();
+	bench_schema_run();
+	bench_chain_run();
+	bench_log_mpsc_run();
+	bench_histogram_run();
+	bench_flight_run();
+
+	if (!bench_footprint_run()) {
+		printk("BENCHMARK FAILED: core RAM over budget\n");
+		return 0;
+	}
+
+	printk("BENCHMARK COMPLETE\n");
+	return 0;
+}
@@ -0,0 +1,413 @@
+#include <stdlib.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/kernel.h>
+#include "common.h"
+#include "telemetry.h"
+
+/*
+ * Headroom harness: loads the pipeline with CPU hogs, interrupt locks and
+ * queue stalls, then ramps the traffic up until measurements are lost or
+ * classified wrongly. Traffic comes from two sources, both in interrupt
+ * context like real sensors:
+ *  - measurements injected into sensor_msgq at the ramped rate, and
+ *  - one vehicle per period driven through the emulated sensor GPIOs,
+ *    so edge timing and axle counting are under the same load.
+ * Every generated vehicle is tallied with its expected class and status,
+ * and each step is checked against the telemetry counters.
+ */
+
+#define HEADROOM_AXLE_GAP_MS 110
+#define HEADROOM_MAX_EDGES   5
+#define HEADROOM_LANES       4
+
+BUILD_ASSERT(3 * HEADROOM_AXLE_GAP_MS + CONFIG_RADAR_AXLE_TIMEOUT_MS + 100 <
+                     CONFIG_HEADROOM_EDGE_PERIOD_MS,
+             "Edge period shorter than a 4-axle vehicle plus the axle timeout");
+BUILD_ASSERT(!IS_ENABLED(CONFIG_RADAR_DEDUP), "Duplicate suppression hides lost vehicles");
+
+// The mix every source cycles through, clear of the warning thresholds
+typedef struct {
+	uint32_t speed_kmh;
+	uint32_t axles;
+} headroom_vehicle_t;
+
+static const headroom_vehicle_t headroom_mix[] = {
+	{50, 2}, // Light, normal
+	{80, 2}, // Light, infraction
+	{30, 3}, // Heavy, normal
+	{50, 4}, // Heavy, infraction
+};
+
+// Counters the pipeline should report, tallied as vehicles are generated
+typedef struct {
+	radar_atomic_t measurements;
+	radar_atomic_t light;
+	radar_atomic_t status[3];
+} headroom_expected_t;
+
+static headroom_expected_t expected;
+
+static const struct gpio_dt_spec sensor_start = GPIO_DT_SPEC_GET(DT_ALIAS(sensor0), gpios);
+static const struct gpio_dt_spec sensor_end = GPIO_DT_SPEC_GET(DT_ALIAS(sensor1), gpios);
+
+/**
+ * Tallies one generated vehicle and computes the duration the sensors see.
+ * @param v The vehicle.
+ * @return The time between the two sensors in milliseconds.
+ */
+static uint32_t headroom_expect(const headroom_vehicle_t *v)
+{
+	uint32_t duration_ms = (CONFIG_RADAR_SENSOR_DISTANCE_MM * 36) / (v->speed_kmh * 10);
+	uint32_t speed_kmh = calculate_speed(CONFIG_RADAR_SENSOR_DISTANCE_MM, duration_ms);
+	bool light = v->axles <= 2;
+	uint32_t limit = light ? CONFIG_RADAR_SPEED_LIMIT_LIGHT_KMH : CONFIG_RADAR_SPEED_LIMIT_HEAVY_KMH;
+	display_status_t status = STATUS_NORMAL;
+
+	if (speed_kmh > limit) {
+		status = STATUS_INFRACTION;
+	} else if (speed_kmh >= (limit * CONFIG_RADAR_WARNING_THRESHOLD_PERCENT) / 100) {
+		status = STATUS_WARNING;
+	}
+
+	atomic_inc(&expected.measurements);
+	if (light) {
+		atomic_inc(&expected.light);
+	}
+	atomic_inc(&expected.status[status]);
+	return duration_ms;
+}
+
+/* Injected traffic ------------------------------------------------------ */
+
+static uint32_t inject_seq;
+
+/**
+ * Injects one measurement per expiry, as the sensor thread would.
+ * @param timer Pointer to the injection timer.
+ */
+static void headroom_inject(struct k_timer *timer)
+{
+	const headroom_vehicle_t *v = &headroom_mix[inject_seq % ARRAY_SIZE(headroom_mix)];
+	int64_t now = k_uptime_get();
+	sensor_data_t s_data = {0};
+
+	// Lane 0 belongs to the GPIO sensors
+	s_data.lane = 1 + inject_seq % (HEADROOM_LANES - 1);
+	s_data.duration_ms = headroom_expect(v);
+	s_data.timestamp_start = now - s_data.duration_ms;
+	s_data.timestamp_end = now;
+	s_data.axle_count = v->axles;
+	s_data.type = v->axles <= 2 ? VEHICLE_LIGHT : VEHICLE_HEAVY;
+	inject_seq++;
+
+	telemetry_inc(TELEMETRY_MEASUREMENT);
+	if (k_msgq_put(&sensor_msgq, &s_data, K_NO_WAIT) != 0) {
+		telemetry_inc(TELEMETRY_SENSOR_DROPPED);
+	}
+}
+
+K_TIMER_DEFINE(inject_timer, headroom_inject, NULL);
+
+/* GPIO-driven traffic --------------------------------------------------- */
+
+typedef struct {
+	int64_t at_ms;
+	const struct gpio_dt_spec *pin;
+} headroom_edge_t;
+
+static headroom_edge_t edges[HEADROOM_MAX_EDGES];
+static int edge_count;
+static int edge_next;
+static uint32_t edge_seq;
+static int64_t edge_slot_ms;
+static atomic_t edge_enabled;
+static atomic_t edge_busy;
+
+/**
+ * Schedules the rising edges of the next vehicle on the sensor pair.
+ * The end sensor edge sits between the axle edges in time order.
+ */
+static void headroom_edges_plan(void)
+{
+	const headroom_vehicle_t *v = &headroom_mix[edge_seq++ % ARRAY_SIZE(headroom_mix)];
+	int64_t end_ms = edge_slot_ms + headroom_expect(v);
+	bool end_placed = false;
+
+	edge_count = 0;
+	for (uint32_t axle = 0; axle < v->axles; axle++) {
+		int64_t at_ms = edge_slot_ms + axle * HEADROOM_AXLE_GAP_MS;
+
+		if (!end_placed && end_ms <= at_ms) {
+			edges[edge_count++] = (headroom_edge_t){end_ms, &sensor_end};
+			end_placed = true;
+		}
+		edges[edge_count++] = (headroom_edge_t){at_ms, &sensor_start};
+	}
+	if (!end_placed) {
+		edges[edge_count++] = (headroom_edge_t){end_ms, &sensor_end};
+	}
+	edge_next = 0;
+}
+
+/**
+ * Fires the due edge and arms the timer for the following one. The sensor
+ * callbacks run right here, in interrupt context.
+ * @param timer Pointer to the edge timer.
+ */
+static void headroom_edge(struct k_timer *timer)
+{
+	const struct gpio_dt_spec *pin = edges[edge_next++].pin;
+
+	(void)gpio_emul_input_set(pin->port, pin->pin, 1);
+	(void)gpio_emul_input_set(pin->port, pin->pin, 0);
+
+	if (edge_next == edge_count) {
+		edge_slot_ms += CONFIG_HEADROOM_EDGE_PERIOD_MS;
+		if (!atomic_get(&edge_enabled)) {
+			atomic_clear(&edge_busy);
+			return;
+		}
+		headroom_edges_plan();
+	}
+	k_timer_start(timer, K_TIMEOUT_ABS_MS(edges[edge_next].at_ms), K_NO_WAIT);
+}
+
+K_TIMER_DEFINE(edge_timer, headroom_edge, NULL);
+
+/**
+ * Starts one vehicle per edge period on the sensor pair.
+ */
+static void headroom_edges_start(void)
+{
+	atomic_set(&edge_enabled, 1);
+	atomic_set(&edge_busy, 1);
+	edge_slot_ms = k_uptime_get() + 10;
+	headroom_edges_plan();
+	k_timer_start(&edge_timer, K_TIMEOUT_ABS_MS(edges[0].at_ms), K_NO_WAIT);
+}
+
+/**
+ * Lets the vehicle on the sensors finish and the pipeline drain.
+ */
+static void headroom_drain(void)
+{
+	atomic_clear(&edge_enabled);
+	while (atomic_get(&edge_busy)) {
+		k_msleep(10);
+	}
+	k_msleep(CONFIG_RADAR_AXLE_TIMEOUT_MS + 100);
+	while (k_msgq_num_used_get(&sensor_msgq) > 0) {
+		k_msleep(10);
+	}
+	// The control thread may still be halfway through the last one
+	k_msleep(CONFIG_HEADROOM_STALL_MS + 10);
+}
+
+/* Perturbations --------------------------------------------------------- */
+
+K_THREAD_STACK_ARRAY_DEFINE(hog_stacks, MAX(CONFIG_HEADROOM_HOG_THREADS, 1), 512);
+static struct k_thread hog_threads[MAX(CONFIG_HEADROOM_HOG_THREADS, 1)];
+
+/**
+ * CPU hog: busy for its duty share of every period, asleep otherwise.
+ * @param p1 Unused.
+ * @param p2 Unused.
+ * @param p3 Unused.
+ */
+static void headroom_hog(void *p1, void *p2, void *p3)
+{
+	const uint32_t busy_us = CONFIG_HEADROOM_HOG_PERIOD_MS * 10 * CONFIG_HEADROOM_HOG_DUTY_PERCENT;
+	int64_t next_ms = k_uptime_get();
+
+	while (1) {
+		k_busy_wait(busy_us);
+		next_ms += CONFIG_HEADROOM_HOG_PERIOD_MS;
+		k_sleep(K_TIMEOUT_ABS_MS(next_ms));
+	}
+}
+
+/**
+ * Keeps interrupts locked for a while, delaying every ISR behind it.
+ * @param timer Pointer to the interrupt lock timer.
+ */
+static void headroom_irq_block(struct k_timer *timer)
+{
+	unsigned int key = irq_lock();
+
+	k_busy_wait(CONFIG_HEADROOM_IRQ_BLOCK_US);
+	irq_unlock(key);
+}
+
+K_TIMER_DEFINE(irq_block_timer, headroom_irq_block, NULL);
+
+/**
+ * Queue stall: periodically holds the CPU above every pipeline thread, so
+ * sensor_msgq only fills.
+ * @param p1 Unused.
+ * @param p2 Unused.
+ * @param p3 Unused.
+ */
+static void headroom_stall(void *p1, void *p2, void *p3)
+{
+	if (CONFIG_HEADROOM_STALL_MS == 0) {
+		return;
+	}
+	while (1) {
+		k_msleep(CONFIG_HEADROOM_STALL_PERIOD_MS);
+		k_busy_wait(CONFIG_HEADROOM_STALL_MS * 1000);
+	}
+}
+
+K_THREAD_DEFINE(headroom_stall_tid, 512, headroom_stall, NULL, NULL, NULL, -2, 0, 0);
+
+/**
+ * Starts the hog threads and the interrupt lock injection.
+ */
+static void headroom_perturb(void)
+{
+	for (int i = 0; i < CONFIG_HEADROOM_HOG_THREADS; i++) {
+		k_thread_create(&hog_threads[i], hog_stacks[i], K_THREAD_STACK_SIZEOF(hog_stacks[i]),
+				headroom_hog, NULL, NULL, NULL, CONFIG_HEADROOM_HOG_PRIORITY + i, 0,
+				K_NO_WAIT);
+	}
+	if (CONFIG_HEADROOM_IRQ_BLOCK_US > 0) {
+		k_timer_start(&irq_block_timer, K_MSEC(CONFIG_HEADROOM_IRQ_PERIOD_MS),
+			      K_MSEC(CONFIG_HEADROOM_IRQ_PERIOD_MS));
+	}
+}
+
+/* Ramp ------------------------------------------------------------------ */
+
+typedef struct {
+	uint32_t counters[TELEMETRY_COUNTER_COUNT];
+	uint32_t measurements;
+	uint32_t light;
+	uint32_t status[3];
+} headroom_sample_t;
+
+/**
+ * Takes a snapshot of the pipeline counters and of the expected ones.
+ * @param sample Pointer to the sample to fill.
+ */
+static void headroom_take_sample(headroom_sample_t *sample)
+{
+	for (int i = 0; i < TELEMETRY_COUNTER_COUNT; i++) {
+		sample->counters[i] = telemetry_get(i);
+	}
+	sample->measurements = atomic_get(&expected.measurements);
+	sample->light = atomic_get(&expected.light);
+	for (int i = 0; i < 3; i++) {
+		sample->status[i] = atomic_get(&expected.status[i]);
+	}
+}
+
+/**
+ * Runs the traffic of one step at the given injection rate.
+ * @param rate Injected vehicles per second.
+ * @return True if every vehicle came out measured and classified right.
+ */
+static bool headroom_step(uint32_t rate)
+{
+	headroom_sample_t before, after;
+	histogram_snapshot_t wait;
+
+	headroom_take_sample(&before);
+	histogram_reset(&telemetry_histograms[TELEMETRY_HIST_QUEUE_WAIT]);
+#if IS_ENABLED(CONFIG_RADAR_CAMERA_TRIGGER_PULSE)
+	histogram_reset(&telemetry_histograms[TELEMETRY_HIST_TRIGGER_ERROR]);
+#endif
+
+	headroom_edges_start();
+	k_timer_start(&inject_timer, K_USEC(1000000 / rate), K_USEC(1000000 / rate));
+	k_sleep(K_SECONDS(CONFIG_HEADROOM_STEP_S));
+	k_timer_stop(&inject_timer);
+	headroom_drain();
+
+	headroom_take_sample(&after);
+	histogram_snapshot(&telemetry_histograms[TELEMETRY_HIST_QUEUE_WAIT], &wait);
+
+#define DELTA(field) (after.field - before.field)
+	uint32_t generated = DELTA(measurements);
+	uint32_t measured = DELTA(counters[TELEMETRY_MEASUREMENT]);
+	uint32_t dropped = DELTA(counters[TELEMETRY_SENSOR_DROPPED]);
+	uint32_t lost = generated > measured ? generated - measured : 0;
+	uint32_t class_errors = 0;
+	uint32_t status_errors = 0;
+
+	// Only meaningful when every vehicle came out exactly once
+	if (dropped == 0 && lost == 0) {
+		class_errors = abs((int32_t)(DELTA(light) - DELTA(counters[TELEMETRY_VEHICLE_LIGHT])));
+		for (int i = 0; i < 3; i++) {
+			status_errors += abs((int32_t)(DELTA(status[i]) -
+						       DELTA(counters[TELEMETRY_STATUS_NORMAL + i])));
+		}
+		status_errors /= 2;
+	}
+
+	printk("Headroom %4u veh/s: generated=%u lost=%u dropped=%u class_errors=%u "
+	       "status_errors=%u display_dropped=%u queue_wait p50=%u p99=%u max=%u ms\n",
+	       rate, generated, lost, dropped, class_errors, status_errors,
+	       DELTA(counters[TELEMETRY_DISPLAY_DROPPED]), histogram_percentile(&wait, 5000),
+	       histogram_percentile(&wait, 9900), histogram_max(&wait));
+#if IS_ENABLED(CONFIG_RADAR_CAMERA_TRIGGER_PULSE)
+	histogram_snapshot_t trigger;
+
+	// Counter-timed pulses should not move with the load
+	histogram_snapshot(&telemetry_histograms[TELEMETRY_HIST_TRIGGER_ERROR], &trigger);
+	printk("Headroom %4u veh/s: trigger pulses=%u late=%u busy=%u error p50=%u p99=%u max=%u us\n",
+	       rate, DELTA(counters[TELEMETRY_TRIGGER_PULSE]), DELTA(counters[TELEMETRY_TRIGGER_LATE]),
+	       DELTA(counters[TELEMETRY_TRIGGER_BUSY]), histogram_percentile(&trigger, 5000),
+	       histogram_percentile(&trigger, 9900), histogram_max(&trigger));
+#endif
+#undef DELTA
+
+	return lost == 0 && dropped == 0 && class_errors == 0 && status_errors == 0;
+}
+
+/**
+ * Main entry point for the headroom harness thread.
+ * @param p1 Unused.
+ * @param p2 Unused.
+ * @param p3 Unused.
+ */
+static void headroom_entry(void *p1, void *p2, void *p3)
+{
+	// Sustainable rates in vehicles per 1000 s, edge lane included
+	const uint32_t edge_milli = 1000000 / CONFIG_HEADROOM_EDGE_PERIOD_MS;
+	const uint32_t peak_milli = (CONFIG_HEADROOM_PEAK_VEHICLES_PER_HOUR * 10) / 36;
+	uint32_t best = 0;
+	bool bounded = false;
+
+	printk("Headroom: %d hogs from prio %d at %d%%, irq lock %d us/%d ms, stall %d ms/%d ms\n",
+	       CONFIG_HEADROOM_HOG_THREADS, CONFIG_HEADROOM_HOG_PRIORITY,
+	       CONFIG_HEADROOM_HOG_DUTY_PERCENT, CONFIG_HEADROOM_IRQ_BLOCK_US,
+	       CONFIG_HEADROOM_IRQ_PERIOD_MS, CONFIG_HEADROOM_STALL_MS,
+	       CONFIG_HEADROOM_STALL_PERIOD_MS);
+
+	headroom_perturb();
+
+	for (uint32_t rate = CONFIG_HEADROOM_RATE_START; rate <= CONFIG_HEADROOM_RATE_MAX;
+	     rate = MAX(rate + 1, rate + (rate * CONFIG_HEADROOM_RATE_STEP_PERCENT) / 100)) {
+		if (!headroom_step(rate)) {
+			bounded = true;
+			break;
+		}
+		best = rate;
+	}
+
+	uint32_t best_milli = best * 1000 + edge_milli;
+	uint32_t margin = (uint32_t)(((uint64_t)best_milli * 100) / peak_milli);
+
+	printk("Headroom: max sustainable %s%u.%03u veh/s, peak %u.%03u veh/s, margin %u%%\n",
+	       bounded ? "" : ">= ", best_milli / 1000, best_milli % 1000, peak_milli / 1000,
+	       peak_milli % 1000, margin);
+
+	if (best == 0 || margin < CONFIG_HEADROOM_MIN_MARGIN_PERCENT) {
+		printk("HEADROOM FAIL: margin below %d%%\n", CONFIG_HEADROOM_MIN_MARGIN_PERCENT);
+		return;
+	}
+	printk("HEADROOM PASS\n");
+}
+
+K_THREAD_DEFINE(headroom_tid, 2048, headroom_entry, NULL, NULL, NULL, -3, 0, 1000);
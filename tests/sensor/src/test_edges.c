@@ -0,0 +1,138 @@
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include "common.h"
+#include "telemetry.h"
+#include "threads.h"
+
+/*
+ * Edge ordering through the real sensor ISR: edges are raised on the
+ * emulated GPIO port, alone or several pins in one write, and the
+ * measurements that come out of sensor_msgq are checked.
+ */
+
+K_MSGQ_DEFINE(sensor_msgq, sizeof(sensor_data_t), 4, 4);
+radar_atomic_t telemetry_counters[TELEMETRY_COUNTER_COUNT];
+
+K_THREAD_DEFINE(sensor_tid, CONFIG_RADAR_SENSOR_STACK_SIZE, sensor_thread_entry, NULL, NULL, NULL,
+		7, 0, 0);
+
+static const struct gpio_dt_spec sensor_start = GPIO_DT_SPEC_GET(DT_ALIAS(sensor0), gpios);
+static const struct gpio_dt_spec sensor_end = GPIO_DT_SPEC_GET(DT_ALIAS(sensor1), gpios);
+
+/**
+ * Raises and releases the selected sensors in a single port write each.
+ * @param start True to pulse the start sensor.
+ * @param end True to pulse the end sensor.
+ */
+static void pulse(bool start, bool end)
+{
+	gpio_port_pins_t mask = (start ? BIT(sensor_start.pin) : 0) | (end ? BIT(sensor_end.pin) : 0);
+
+	zassert_ok(gpio_emul_input_set_masked(sensor_start.port, mask, mask));
+	zassert_ok(gpio_emul_input_set_masked(sensor_start.port, mask, 0));
+}
+
+/**
+ * Waits for the measurement the axle timeout finalizes.
+ * @param out Pointer to the measurement to fill.
+ * @return True if a measurement came out, false otherwise.
+ */
+static bool wait_measurement(sensor_data_t *out)
+{
+	return k_msgq_get(&sensor_msgq, out, K_MSEC(CONFIG_RADAR_AXLE_TIMEOUT_MS + 100)) == 0;
+}
+
+ZTEST(radar_sensor_edges, test_light_vehicle)
+{
+	sensor_data_t out;
+
+	pulse(true, false);
+	k_msleep(110);
+	pulse(true, false);
+	k_msleep(90);
+	pulse(false, true);
+
+	zassert_true(wait_measurement(&out), "No measurement");
+	zassert_equal(out.duration_ms, 200, "Duration mismatch");
+	zassert_equal(out.axle_count, 2, "Axle count mismatch");
+	zassert_equal(out.type, VEHICLE_LIGHT, "Type should be LIGHT");
+}
+
+ZTEST(radar_sensor_edges, test_axle_and_end_in_one_interrupt)
+{
+	sensor_data_t out;
+
+	pulse(true, false);
+	k_msleep(200);
+	pulse(true, true);
+	k_msleep(100);
+	pulse(true, false);
+
+	zassert_true(wait_measurement(&out), "No measurement");
+	zassert_equal(out.duration_ms, 200, "End edge should keep the shared timestamp");
+	zassert_equal(out.axle_count, 3, "Axle from the shared interrupt should count");
+	zassert_equal(out.type, VEHICLE_HEAVY, "Type should be HEAVY");
+}
+
+ZTEST(radar_sensor_edges, test_start_and_end_together_when_idle)
+{
+	sensor_data_t out;
+
+	/* Start is handled first; the end edge at the same time is ignored */
+	pulse(true, true);
+	k_msleep(300);
+	pulse(false, true);
+	zassert_true(wait_measurement(&out), "Later end edge should time the vehicle");
+	zassert_equal(out.duration_ms, 300, "Duration mismatch");
+}
+
+ZTEST(radar_sensor_edges, test_end_before_start_ignored)
+{
+	sensor_data_t out;
+
+	pulse(false, true);
+	k_msleep(50);
+	pulse(true, false);
+	k_msleep(250);
+	pulse(false, true);
+
+	zassert_true(wait_measurement(&out), "No measurement");
+	zassert_equal(out.duration_ms, 250, "Stray end edge should be ignored");
+	zassert_equal(out.axle_count, 1, "Axle count mismatch");
+}
+
+ZTEST(radar_sensor_edges, test_one_dispatch_per_interrupt)
+{
+	sensor_data_t out;
+	uint32_t before = telemetry_get(TELEMETRY_WAKEUP);
+
+	pulse(true, true);
+	zassert_equal(telemetry_get(TELEMETRY_WAKEUP) - before, 1,
+		      "Both pins should be handled by one callback");
+	(void)wait_measurement(&out);
+}
+
+/**
+ * Gives the sensor thread time to configure the port.
+ * @return NULL.
+ */
+static void *edges_setup(void)
+{
+	k_msleep(10);
+	return NULL;
+}
+
+/**
+ * Lets any open measurement window time out and empties the queue.
+ * @param fixture Unused.
+ */
+static void edges_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+	k_msleep(CONFIG_RADAR_AXLE_TIMEOUT_MS + 100);
+	k_msgq_purge(&sensor_msgq);
+}
+
+ZTEST_SUITE(radar_sensor_edges, NULL, edges_setup, edges_before, NULL, NULL);
@@ -0,0 +1,188 @@
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/sys_heap.h>
+#include "common.h"
+#include "display_fanout.h"
+#include "infraction_log.h"
+#include "telemetry.h"
+
+/*
+ * Soak monitor: runs above every pipeline thread, wakes once per sample
+ * interval of simulated time and checks that the counters still add up.
+ * Any drift is reported once and ends the run with a fatal error.
+ */
+
+// Measurement the control thread has taken off the queue but not yet counted
+#define SOAK_INFLIGHT_SLACK 1
+// Triggers the camera may still owe: its trigger queue plus the burst in progress
+#define SOAK_CAMERA_LAG_MAX (3 * CONFIG_RADAR_CAMERA_PLATOON_MAX)
+// Mean number of vehicles generated between two samples
+#define SOAK_EXPECTED_PER_SAMPLE                                                                   \
+	((CONFIG_SOAK_SAMPLE_INTERVAL_S * CONFIG_RADAR_TRAFFIC_LANES *                             \
+	  CONFIG_RADAR_TRAFFIC_VEHICLES_PER_HOUR) / 3600)
+
+typedef struct {
+	int64_t uptime_ms;
+	uint32_t counters[TELEMETRY_COUNTER_COUNT];
+	uint32_t sensor_queued;
+	uint32_t display_pending;
+	uint32_t log_valid;
+	infraction_chain_stats_t chain;
+	size_t heap_allocated;
+} soak_sample_t;
+
+extern struct k_heap _system_heap;
+
+static uint32_t peak_sensor_queued;
+static uint32_t peak_display_pending;
+
+/**
+ * Starts every telemetry counter just below 2^32 so the run crosses the wrap.
+ * @return 0 on success.
+ */
+static int soak_preload_counters(void)
+{
+	for (int i = 0; i < TELEMETRY_COUNTER_COUNT; i++) {
+		atomic_set(&telemetry_counters[i], (atomic_val_t)CONFIG_SOAK_COUNTER_PRELOAD);
+	}
+	return 0;
+}
+
+SYS_INIT(soak_preload_counters, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+/**
+ * Reads a counter relative to the preload value. Modulo 2^32, so wrap-safe.
+ * @param sample Pointer to the sample.
+ * @param counter The counter to read.
+ * @return The number of increments since boot.
+ */
+static uint32_t soak_count(const soak_sample_t *sample, telemetry_counter_t counter)
+{
+	return sample->counters[counter] - (uint32_t)CONFIG_SOAK_COUNTER_PRELOAD;
+}
+
+/**
+ * Takes a snapshot of the pipeline state.
+ * @param sample Pointer to the sample to fill.
+ */
+static void soak_take_sample(soak_sample_t *sample)
+{
+	sample->uptime_ms = k_uptime_get();
+	for (int i = 0; i < TELEMETRY_COUNTER_COUNT; i++) {
+		sample->counters[i] = telemetry_get(i);
+	}
+	sample->sensor_queued = k_msgq_num_used_get(&sensor_msgq);
+	sample->display_pending = display_fanout_pending();
+	infraction_log_get_counters(NULL, NULL, &sample->log_valid, NULL);
+	infraction_log_get_chain_stats(&sample->chain);
+
+	struct sys_memory_stats heap;
+
+	sys_heap_runtime_stats_get(&_system_heap.heap, &heap);
+	sample->heap_allocated = heap.allocated_bytes;
+
+	peak_sensor_queued = MAX(peak_sensor_queued, sample->sensor_queued);
+	peak_display_pending = MAX(peak_display_pending, sample->display_pending);
+}
+
+/**
+ * Checks the invariants of one sample against the previous one.
+ * @param prev Pointer to the previous sample.
+ * @param cur Pointer to the current sample.
+ * @return NULL if everything holds, otherwise a description of the drift.
+ */
+static const char *soak_check(const soak_sample_t *prev, const soak_sample_t *cur)
+{
+	uint32_t measured = soak_count(cur, TELEMETRY_MEASUREMENT);
+	uint32_t classified = soak_count(cur, TELEMETRY_VEHICLE_LIGHT) +
+			      soak_count(cur, TELEMETRY_VEHICLE_HEAVY);
+	uint32_t statuses = soak_count(cur, TELEMETRY_STATUS_NORMAL) +
+			    soak_count(cur, TELEMETRY_STATUS_WARNING) +
+			    soak_count(cur, TELEMETRY_STATUS_INFRACTION);
+	uint32_t triggers = soak_count(cur, TELEMETRY_CAMERA_TRIGGER);
+	uint32_t results = soak_count(cur, TELEMETRY_CAMERA_RESULT);
+
+	if (cur->uptime_ms <= prev->uptime_ms) {
+		return "uptime went backwards";
+	}
+	if (SOAK_EXPECTED_PER_SAMPLE >= 10 && measured == soak_count(prev, TELEMETRY_MEASUREMENT)) {
+		return "traffic stopped";
+	}
+	if (classified != statuses) {
+		return "classified vehicles != status updates";
+	}
+
+	// Every measurement is processed, suppressed, dropped or still queued
+	uint32_t accounted = statuses + soak_count(cur, TELEMETRY_DEDUP_VEHICLE) +
+			     soak_count(cur, TELEMETRY_SENSOR_DROPPED) + cur->sensor_queued;
+	if (measured - accounted > SOAK_INFLIGHT_SLACK) {
+		return "measurements lost between sensor_msgq and the control thread";
+	}
+	if (soak_count(cur, TELEMETRY_SENSOR_DROPPED) != 0) {
+		return "sensor_msgq overflowed";
+	}
+	if (soak_count(cur, TELEMETRY_DEDUP_VEHICLE) != 0) {
+		return "distinct vehicles suppressed as duplicates";
+	}
+	if (triggers > soak_count(cur, TELEMETRY_STATUS_INFRACTION) || results > triggers) {
+		return "camera counters out of order";
+	}
+	if (triggers - results > SOAK_CAMERA_LAG_MAX) {
+		return "camera falling behind";
+	}
+	if (cur->log_valid < prev->log_valid) {
+		return "infraction log counter went backwards";
+	}
+#if IS_ENABLED(CONFIG_RADAR_INFRACTION_CHAIN)
+	if (cur->chain.gaps != 0) {
+		return "hash chain fell a full ring behind";
+	}
+#endif
+	if (cur->heap_allocated > prev->heap_allocated) {
+		return "heap usage grew";
+	}
+	return NULL;
+}
+
+/**
+ * Main entry point for the soak monitor thread.
+ * @param p1 Pointer to the soak monitor thread data.
+ * @param p2 Pointer to the soak monitor thread data.
+ * @param p3 Pointer to the soak monitor thread data.
+ */
+static void soak_monitor_entry(void *p1, void *p2, void *p3)
+{
+	const int samples = (CONFIG_SOAK_DURATION_HOURS * 3600) / CONFIG_SOAK_SAMPLE_INTERVAL_S;
+	soak_sample_t prev, cur;
+
+	printk("Soak: %d h simulated, %d lanes x %d vehicles/h, sample every %d s\n",
+	       CONFIG_SOAK_DURATION_HOURS, CONFIG_RADAR_TRAFFIC_LANES,
+	       CONFIG_RADAR_TRAFFIC_VEHICLES_PER_HOUR, CONFIG_SOAK_SAMPLE_INTERVAL_S);
+
+	soak_take_sample(&prev);
+	for (int i = 1; i <= samples; i++) {
+		k_sleep(K_TIMEOUT_ABS_MS((int64_t)i * CONFIG_SOAK_SAMPLE_INTERVAL_S * 1000));
+		soak_take_sample(&cur);
+
+		printk("Soak %3d/%d t=%lld s: measured=%u infractions=%u logged=%u "
+		       "queues=%u/%u heap=%zu counter=0x%08x\n",
+		       i, samples, cur.uptime_ms / 1000, soak_count(&cur, TELEMETRY_MEASUREMENT),
+		       soak_count(&cur, TELEMETRY_STATUS_INFRACTION), cur.log_valid,
+		       cur.sensor_queued, cur.display_pending, cur.heap_allocated,
+		       cur.counters[TELEMETRY_MEASUREMENT]);
+
+		const char *drift = soak_check(&prev, &cur);
+		if (drift != NULL) {
+			printk("SOAK FAIL: %s at t=%lld s\n", drift, cur.uptime_ms / 1000);
+			k_panic();
+		}
+		prev = cur;
+	}
+
+	printk("Soak: peak sensor queue depth %u of %d, peak pending display sinks %u of %u\n",
+	       peak_sensor_queued, CONFIG_RADAR_QUEUE_DEPTH, peak_display_pending,
+	       (uint32_t)display_sink_count);
+	printk("SOAK PASS\n");
+}
+
+K_THREAD_DEFINE(soak_monitor_tid, 2048, soak_monitor_entry, NULL, NULL, NULL, 0, 0, 0);
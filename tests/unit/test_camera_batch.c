@@ -0,0 +1,96 @@
+#include <zephyr/ztest.h>
+#include "camera_batch.h"
+
+/**
+ * Builds a trigger.
+ * @param id The trigger id.
+ * @param lane The lane.
+ * @param timestamp_ms When the vehicle entered the view.
+ * @return The trigger.
+ */
+static camera_trigger_t trigger(uint32_t id, uint8_t lane, int64_t timestamp_ms)
+{
+	return (camera_trigger_t){.id = id, .lane = lane, .timestamp_ms = timestamp_ms};
+}
+
+ZTEST(radar_camera_batch, test_platoon_shares_burst)
+{
+	camera_batch_t batch;
+	camera_trigger_t t = trigger(0, 0, 1000);
+
+	camera_batch_start(&batch, &t, 1000);
+	for (uint32_t i = 1; i < 4; i++) {
+		t = trigger(i, 0, 1000 + i * 300);
+		zassert_true(camera_batch_join(&batch, &t), "Close follower joins the burst");
+	}
+	zassert_equal(batch.count, 4, "Whole platoon in one burst");
+	zassert_equal(camera_batch_done_ms(&batch),
+		      MAX(1000 + CONFIG_RADAR_CAMERA_CAPTURE_MS + 2 * CONFIG_RADAR_CAMERA_EXTRACT_MS,
+			  1900) + CONFIG_RADAR_CAMERA_EXTRACT_MS,
+		      "One capture, three extractions, none before its trigger");
+
+	/* The gap is measured from the last member, not the first */
+	t = trigger(4, 0, 1900 + CONFIG_RADAR_CAMERA_PLATOON_GAP_MS + 1);
+	zassert_false(camera_batch_join(&batch, &t), "Vehicle after the gap starts a new burst");
+	t = trigger(4, 1, 2000);
+	zassert_false(camera_batch_join(&batch, &t), "Other lane starts a new burst");
+}
+
+ZTEST(radar_camera_batch, test_lone_vehicle_done_after_capture)
+{
+	camera_batch_t batch;
+	camera_trigger_t t = trigger(0, 0, 1000);
+
+	camera_batch_start(&batch, &t, 1000);
+	zassert_equal(camera_batch_done_ms(&batch), 1000 + CONFIG_RADAR_CAMERA_CAPTURE_MS,
+		      "No platoon gap wait for a single vehicle");
+	t = trigger(1, 0, 1200);
+	zassert_true(camera_batch_join(&batch, &t), "Follower joins the burst");
+	zassert_equal(camera_batch_done_ms(&batch),
+		      1000 + CONFIG_RADAR_CAMERA_CAPTURE_MS + CONFIG_RADAR_CAMERA_EXTRACT_MS,
+		      "Follower adds one extraction");
+}
+
+ZTEST(radar_camera_batch, test_join_after_camera_done)
+{
+	camera_batch_t batch;
+	camera_trigger_t t = trigger(0, 0, 1000);
+
+	camera_batch_start(&batch, &t, 1000);
+	/* The camera is done with the first plate, the recording is still open */
+	t = trigger(1, 0, 1000 + CONFIG_RADAR_CAMERA_CAPTURE_MS + 50);
+	zassert_true(t.timestamp_ms < camera_batch_gap_end_ms(&batch), "Within the platoon gap");
+	zassert_true(camera_batch_join(&batch, &t), "Follower joins the open recording");
+	zassert_equal(camera_batch_done_ms(&batch), t.timestamp_ms + CONFIG_RADAR_CAMERA_EXTRACT_MS,
+		      "Extraction starts at the follower's trigger");
+	zassert_true(camera_batch_in_view(&batch, 1), "Follower is in the recording");
+}
+
+ZTEST(radar_camera_batch, test_burst_size_bounded)
+{
+	camera_batch_t batch;
+	camera_trigger_t t = trigger(0, 0, 0);
+
+	camera_batch_start(&batch, &t, 0);
+	for (uint32_t i = 1; i < CONFIG_RADAR_CAMERA_PLATOON_MAX; i++) {
+		t = trigger(i, 0, i * 100);
+		zassert_true(camera_batch_join(&batch, &t), "Room left in the burst");
+	}
+	t = trigger(CONFIG_RADAR_CAMERA_PLATOON_MAX, 0, CONFIG_RADAR_CAMERA_PLATOON_MAX * 100);
+	zassert_false(camera_batch_join(&batch, &t), "Full burst takes no more vehicles");
+}
+
+ZTEST(radar_camera_batch, test_late_start_misses_vehicle)
+{
+	camera_batch_t batch;
+	camera_trigger_t t = trigger(0, 0, 0);
+
+	/* Camera still busy with the previous burst when the vehicle arrived */
+	camera_batch_start(&batch, &t, CONFIG_RADAR_CAMERA_VIEW_MS + 1);
+	t = trigger(1, 0, CONFIG_RADAR_CAMERA_PLATOON_GAP_MS - 100);
+	zassert_true(camera_batch_join(&batch, &t), "Follower joins the burst");
+	zassert_false(camera_batch_in_view(&batch, 0), "First vehicle left the view");
+	zassert_true(camera_batch_in_view(&batch, 1), "Follower still in view");
+}
+
+ZTEST_SUITE(radar_camera_batch, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,237 @@
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include "infraction_log.h"
+#include "sha256.h"
+
+static void hex_to_bytes(const char *hex, uint8_t *out, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		char byte[3] = {hex[2 * i], hex[2 * i + 1], '\0'};
+		out[i] = (uint8_t)strtoul(byte, NULL, 16);
+	}
+}
+
+ZTEST(radar_chain, test_sha256_vectors)
+{
+	uint8_t digest[SHA256_DIGEST_SIZE];
+	uint8_t expected[SHA256_DIGEST_SIZE];
+
+	sha256("abc", 3, digest);
+	hex_to_bytes("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", expected,
+		     sizeof(expected));
+	zassert_mem_equal(digest, expected, sizeof(expected), "SHA-256(abc) mismatch");
+
+	/* Two-block message, fed in uneven pieces */
+	const char *msg = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+	sha256_ctx_t ctx;
+	sha256_init(&ctx);
+	sha256_update(&ctx, msg, 5);
+	sha256_update(&ctx, msg + 5, strlen(msg) - 5);
+	sha256_final(&ctx, digest);
+	hex_to_bytes("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1", expected,
+		     sizeof(expected));
+	zassert_mem_equal(digest, expected, sizeof(expected), "SHA-256 two-block mismatch");
+}
+
+ZTEST(radar_chain, test_chain_detects_tampering)
+{
+	uint8_t genesis[SHA256_DIGEST_SIZE] = {0};
+	uint8_t a[SHA256_DIGEST_SIZE];
+	uint8_t b[SHA256_DIGEST_SIZE];
+	infraction_record_t rec = {
+		.timestamp_ms = 5000,
+		.type = VEHICLE_HEAVY,
+		.speed_kmh = 50,
+		.limit_kmh = 40,
+		.valid_read = true,
+		.seq = 0,
+	};
+	strcpy(rec.plate, "ABC1D23");
+
+	infraction_chain_link(genesis, &rec, a);
+	infraction_chain_link(genesis, &rec, b);
+	zassert_mem_equal(a, b, sizeof(a), "Linking must be deterministic");
+
+	/* Garbage after the plate terminator must not change the digest */
+	rec.plate[8] = 'Z';
+	infraction_chain_link(genesis, &rec, b);
+	zassert_mem_equal(a, b, sizeof(a), "Padding bytes leaked into the digest");
+
+	rec.speed_kmh = 39;
+	infraction_chain_link(genesis, &rec, b);
+	zassert_true(memcmp(a, b, sizeof(a)) != 0, "Edited record must change the digest");
+}
+
+ZTEST(radar_chain, test_log_assigns_sequence_numbers)
+{
+	infraction_record_t rec = {.type = VEHICLE_LIGHT, .valid_read = false};
+	infraction_record_t out[2];
+
+	rec.plate[0] = '\0';
+	infraction_log_add(&rec);
+	infraction_log_add(&rec);
+
+	zassert_equal(infraction_log_get_recent(2, out), 2, "Expected two records");
+	zassert_equal(out[0].seq, out[1].seq + 1, "Newest record should carry the next seq");
+}
+
+/**
+ * Waits for the chain worker to hash everything in the log, including
+ * what earlier tests left behind.
+ * @param head Set to the chain head, all zero before the first record.
+ * @return The sequence number of the next record the chain will take.
+ */
+static uint32_t chain_settle(infraction_checkpoint_t *head)
+{
+	infraction_record_t newest;
+
+	for (int i = 0; i < 1000; i++) {
+		if (infraction_log_get_recent(1, &newest) == 0) {
+			memset(head, 0, sizeof(*head));
+			return 0;
+		}
+		if (infraction_log_get_chain_head(head) && head->seq == newest.seq) {
+			return head->seq + 1;
+		}
+		k_sleep(K_MSEC(1));
+	}
+	zassert_unreachable("Chain worker did not catch up");
+	return 0;
+}
+
+static bool collect_cb(const infraction_record_t *records, size_t count, void *user_data)
+{
+	infraction_record_t **out = user_data;
+
+	memcpy(*out, records, count * sizeof(*records));
+	*out += count;
+	return true;
+}
+
+/* Gap marker as the worker folds it in: tag, first lost seq, count, little-endian */
+static void link_gap(const uint8_t prev[SHA256_DIGEST_SIZE], uint32_t first, uint32_t missing,
+		     uint8_t next[SHA256_DIGEST_SIZE])
+{
+	uint8_t buf[1 + 4 + 4] = {'G'};
+	sha256_ctx_t ctx;
+
+	for (int i = 0; i < 4; i++) {
+		buf[1 + i] = (uint8_t)(first >> (8 * i));
+		buf[5 + i] = (uint8_t)(missing >> (8 * i));
+	}
+	sha256_init(&ctx);
+	sha256_update(&ctx, prev, SHA256_DIGEST_SIZE);
+	sha256_update(&ctx, buf, sizeof(buf));
+	sha256_final(&ctx, next);
+}
+
+#define CHAIN_TEST_RECORDS (2 * CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINT_INTERVAL)
+
+BUILD_ASSERT(CHAIN_TEST_RECORDS <= CONFIG_RADAR_INFRACTION_LOG_SIZE,
+	     "Test records must fit the log");
+BUILD_ASSERT(CHAIN_TEST_RECORDS > CONFIG_RADAR_INFRACTION_CHAIN_BATCH,
+	     "Test records must span several worker batches");
+
+ZTEST(radar_chain, test_worker_hashes_in_batches_and_checkpoints)
+{
+	static infraction_record_t added[CHAIN_TEST_RECORDS];
+	infraction_record_t *fill = added;
+	infraction_checkpoint_t start;
+	infraction_checkpoint_t head;
+	infraction_checkpoint_t cps[CONFIG_RADAR_INFRACTION_CHAIN_CHECKPOINTS];
+	infraction_chain_stats_t before;
+	infraction_chain_stats_t after;
+	infraction_cursor_t cursor;
+	infraction_record_t rec = {.type = VEHICLE_LIGHT, .limit_kmh = 60, .plate = "ABC1D23"};
+
+	uint32_t first = chain_settle(&start);
+
+	infraction_log_get_chain_stats(&before);
+	infraction_cursor_init(&cursor);
+	cursor.next_seq = first;
+	for (uint32_t i = 0; i < CHAIN_TEST_RECORDS; i++) {
+		rec.speed_kmh = 61 + i;
+		infraction_log_add(&rec);
+	}
+	chain_settle(&head);
+	infraction_log_get_chain_stats(&after);
+
+	zassert_equal(after.hashed - before.hashed, CHAIN_TEST_RECORDS,
+		      "Worker must resubmit itself until every record is hashed");
+	zassert_equal(after.gaps, before.gaps, "Nothing was overwritten");
+	zassert_equal(infraction_log_visit(&cursor, collect_cb, &fill), CHAIN_TEST_RECORDS,
+		      "Records added by this test");
+
+	/* Recompute the chain from the previous head, checking every checkpoint on the way */
+	size_t n_cps = infraction_log_get_checkpoints(ARRAY_SIZE(cps), cps);
+	uint8_t digest[SHA256_DIGEST_SIZE];
+	uint32_t checked = 0;
+
+	memcpy(digest, start.digest, sizeof(digest));
+	for (uint32_t i = 0; i < CHAIN_TEST_RECORDS; i++) {
+		infraction_chain_link(digest, &added[i], digest);
+		for (size_t c = 0; c < n_cps; c++) {
+			if (cps[c].seq == added[i].seq) {
+				zassert_mem_equal(cps[c].digest, digest, sizeof(digest),
+						  "Checkpoint digest mismatch");
+				checked++;
+			}
+		}
+	}
+	zassert_equal(checked, 2, "One checkpoint per interval");
+	zassert_equal(head.seq, added[CHAIN_TEST_RECORDS - 1].seq, "Head is the newest record");
+	zassert_mem_equal(head.digest, digest, sizeof(digest), "Head digest mismatch");
+}
+
+ZTEST(radar_chain, test_worker_links_gap_for_lapped_records)
+{
+	static infraction_record_t survivors[CONFIG_RADAR_INFRACTION_LOG_SIZE];
+	infraction_record_t *fill = survivors;
+	infraction_checkpoint_t start;
+	infraction_checkpoint_t head;
+	infraction_chain_stats_t before;
+	infraction_chain_stats_t after;
+	infraction_cursor_t cursor;
+	infraction_record_t rec = {.type = VEHICLE_HEAVY, .limit_kmh = 40};
+	const uint32_t lost = 5;
+
+	uint32_t first = chain_settle(&start);
+
+	infraction_log_get_chain_stats(&before);
+
+	/* The worker cannot run until the writers have lapped the ring */
+	k_sched_lock();
+	for (uint32_t i = 0; i < CONFIG_RADAR_INFRACTION_LOG_SIZE + lost; i++) {
+		rec.speed_kmh = 41 + i;
+		infraction_log_add(&rec);
+	}
+	k_sched_unlock();
+	chain_settle(&head);
+	infraction_log_get_chain_stats(&after);
+
+	zassert_equal(after.gaps - before.gaps, lost, "Lapped records are counted as gaps");
+	zassert_equal(after.hashed - before.hashed, CONFIG_RADAR_INFRACTION_LOG_SIZE,
+		      "Only the surviving records are hashed");
+
+	infraction_cursor_init(&cursor);
+	zassert_equal(infraction_log_visit(&cursor, collect_cb, &fill),
+		      CONFIG_RADAR_INFRACTION_LOG_SIZE, "Surviving records");
+	zassert_equal(survivors[0].seq, first + lost, "Oldest survivor follows the gap");
+
+	/* The gap marker sits between the previous head and the oldest survivor */
+	uint8_t digest[SHA256_DIGEST_SIZE];
+	uint8_t no_gap[SHA256_DIGEST_SIZE];
+
+	link_gap(start.digest, first, lost, digest);
+	memcpy(no_gap, start.digest, sizeof(no_gap));
+	for (uint32_t i = 0; i < CONFIG_RADAR_INFRACTION_LOG_SIZE; i++) {
+		infraction_chain_link(digest, &survivors[i], digest);
+		infraction_chain_link(no_gap, &survivors[i], no_gap);
+	}
+	zassert_mem_equal(head.digest, digest, sizeof(digest), "Head must include the gap marker");
+	zassert_true(memcmp(head.digest, no_gap, sizeof(no_gap)) != 0,
+		     "Silently dropping records must not give the same head");
+}
+
+ZTEST_SUITE(radar_chain, NULL, NULL, NULL, NULL, NULL);
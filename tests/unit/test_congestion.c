@@ -0,0 +1,73 @@
+#include <zephyr/ztest.h>
+#include "congestion.h"
+
+static congestion_t det;
+
+/**
+ * Feeds vehicles at a fixed speed and headway.
+ * @param start_ms Time of the first vehicle.
+ * @param count Number of vehicles.
+ * @param headway_ms Time between two vehicles.
+ * @param speed_kmh Speed of every vehicle.
+ * @return The detector state after the last vehicle.
+ */
+static bool feed(int64_t start_ms, int count, uint32_t headway_ms, uint32_t speed_kmh)
+{
+	bool active = false;
+	// Time the front axle needs to cross 5 m
+	uint32_t occupied_ms = (5000 * 36) / (speed_kmh * 10);
+
+	for (int i = 0; i < count; i++) {
+		active = congestion_update(&det, start_ms + (int64_t)i * headway_ms, speed_kmh, occupied_ms);
+	}
+	return active;
+}
+
+ZTEST(radar_congestion, test_free_flow_is_normal)
+{
+	congestion_init(&det, 60000);
+
+	/* Dense but fast traffic */
+	zassert_false(feed(0, 120, 500, 80), "Fast traffic is never congested");
+	/* Slow but sparse traffic: one vehicle a minute */
+	congestion_init(&det, 60000);
+	zassert_false(feed(0, 10, 60000, 10), "Sparse traffic is not congested");
+}
+
+ZTEST(radar_congestion, test_stop_and_go_detected)
+{
+	congestion_stats_t stats;
+
+	congestion_init(&det, 60000);
+	/* 10 km/h, one vehicle every 3 s: 1800 ms occupied out of 3000 */
+	zassert_true(feed(0, 20, 3000, 10), "Stop-and-go must be detected");
+
+	congestion_get_stats(&det, 57000, &stats);
+	zassert_equal(stats.mean_speed_kmh, 10, "Mean speed");
+	zassert_within(stats.occupancy_percent, 60, 5, "Occupancy around 60%%");
+}
+
+ZTEST(radar_congestion, test_hysteresis_and_exit)
+{
+	congestion_init(&det, 60000);
+	zassert_true(feed(0, 20, 3000, 10), "Enter congestion");
+
+	/* Mean creeps over the entry speed (about 25 km/h) but stays under the exit speed */
+	zassert_true(feed(60000, 14, 1000, 40), "Hysteresis keeps the mode");
+
+	/* A full window of free flow ends it */
+	zassert_false(feed(74000, 120, 500, 80), "Free flow clears congestion");
+}
+
+ZTEST(radar_congestion, test_window_expires)
+{
+	congestion_stats_t stats;
+
+	congestion_init(&det, 60000);
+	feed(0, 20, 3000, 10);
+	congestion_get_stats(&det, 200000, &stats);
+	zassert_equal(stats.vehicles, 0, "Old buckets leave the window");
+	zassert_equal(stats.occupancy_percent, 0, "No occupancy without vehicles");
+}
+
+ZTEST_SUITE(radar_congestion, NULL, NULL, NULL, NULL, NULL);
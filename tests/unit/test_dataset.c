@@ -0,0 +1,70 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+#include "dataset.h"
+
+static dataset_t ds;
+
+ZTEST(radar_dataset, test_csv_rows)
+{
+	static const char csv[] = "timestamp_ms,lane,duration_ms,axles,type,gross_weight_kg\n"
+				  "1000,0,360,2,L,1500\r\n"
+				  "# comment\n"
+				  "\n"
+				  "1200,3,450,5,H\n"
+				  "1300,1,abc,2,L\n"
+				  "1400,1,0,2,L\n"
+				  "1500,1,300,2,X\n"
+				  "1600,2,225,2,L,1200";
+	sensor_data_t s = {0};
+
+	dataset_open(&ds, csv, sizeof(csv) - 1);
+	zassert_equal(ds.format, DATASET_CSV, "No magic: CSV");
+
+	zassert_true(dataset_next(&ds, &s), "First row");
+	zassert_equal(s.timestamp_start, 1000, "Timestamp");
+	zassert_equal(s.timestamp_end, 1360, "End is start plus duration");
+	zassert_equal(s.type, VEHICLE_LIGHT, "Type");
+	zassert_equal(s.gross_weight_kg, 1500, "Weight before CR LF");
+
+	zassert_true(dataset_next(&ds, &s), "Comment and empty line skipped");
+	zassert_equal(s.lane, 3, "Lane");
+	zassert_equal(s.axle_count, 5, "Axles");
+	zassert_equal(s.type, VEHICLE_HEAVY, "Type");
+	zassert_equal(s.gross_weight_kg, 0, "Weight is optional");
+	zassert_equal(ds.line, 5, "Line of the row");
+
+	zassert_true(dataset_next(&ds, &s), "Malformed rows skipped");
+	zassert_equal(s.timestamp_start, 1600, "Last row without line break");
+	zassert_equal(ds.errors, 3, "Bad number, zero duration and bad type counted");
+	zassert_false(dataset_next(&ds, &s), "End of data");
+}
+
+ZTEST(radar_dataset, test_binary_records)
+{
+	uint8_t bin[DATASET_MAGIC_SIZE + 2 * DATASET_RECORD_SIZE + 5] = {0};
+	uint8_t *r = &bin[DATASET_MAGIC_SIZE];
+	sensor_data_t s = {0};
+
+	memcpy(bin, DATASET_MAGIC, DATASET_MAGIC_SIZE);
+	/* 70000 ms, 400 ms, lane 2, 3 axles, heavy, 24000 kg */
+	r[0] = 0x70; r[1] = 0x11; r[2] = 0x01;
+	r[4] = 0x90; r[5] = 0x01;
+	r[6] = 2; r[7] = 3; r[8] = 1;
+	r[12] = 0xc0; r[13] = 0x5d;
+	/* Second record has no axles */
+	r[DATASET_RECORD_SIZE + 4] = 100;
+
+	dataset_open(&ds, bin, sizeof(bin));
+	zassert_equal(ds.format, DATASET_BINARY, "Magic: binary");
+	zassert_true(dataset_next(&ds, &s), "First record");
+	zassert_equal(s.timestamp_start, 70000, "Timestamp");
+	zassert_equal(s.duration_ms, 400, "Duration");
+	zassert_equal(s.lane, 2, "Lane");
+	zassert_equal(s.axle_count, 3, "Axles");
+	zassert_equal(s.type, VEHICLE_HEAVY, "Type");
+	zassert_equal(s.gross_weight_kg, 24000, "Weight");
+	zassert_false(dataset_next(&ds, &s), "Invalid and truncated records skipped");
+	zassert_equal(ds.errors, 2, "Both counted");
+}
+
+ZTEST_SUITE(radar_dataset, NULL, NULL, NULL, NULL, NULL);
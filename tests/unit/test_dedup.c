@@ -0,0 +1,73 @@
+#include <zephyr/ztest.h>
+#include "common.h"
+#include "dedup.h"
+
+static dedup_set_t set;
+
+ZTEST(radar_dedup, test_bounce_is_duplicate)
+{
+	dedup_set_init(&set, 500);
+
+	zassert_false(dedup_vehicle_check(&set, 0, 10000, 72, 5), "First measurement is new");
+	/* Same lane, 120 ms later, 2 km/h apart: sensor bounce */
+	zassert_true(dedup_vehicle_check(&set, 0, 10120, 74, 5), "Bounce should be suppressed");
+	/* Crosses a bucket boundary but still inside the window */
+	zassert_true(dedup_vehicle_check(&set, 0, 10480, 70, 5), "Adjacent bucket should match");
+}
+
+ZTEST(radar_dedup, test_distinct_vehicles_pass)
+{
+	dedup_set_init(&set, 500);
+
+	zassert_false(dedup_vehicle_check(&set, 0, 10000, 72, 5), "First measurement is new");
+	zassert_false(dedup_vehicle_check(&set, 1, 10050, 72, 5), "Other lane is not a duplicate");
+	zassert_false(dedup_vehicle_check(&set, 0, 10100, 40, 5), "Different speed is not a duplicate");
+	zassert_false(dedup_vehicle_check(&set, 0, 12000, 72, 5), "Outside the window is new");
+}
+
+ZTEST(radar_dedup, test_platoon_is_kept)
+{
+	dedup_set_init(&set, CONFIG_RADAR_DEDUP_WINDOW_MS);
+
+	/* Three vehicles 250 ms apart on one lane at the same speed */
+	for (int64_t t = 10000; t <= 10500; t += 250) {
+		zassert_false(dedup_vehicle_check(&set, 0, t, 72, CONFIG_RADAR_DEDUP_SPEED_TOLERANCE_KMH),
+			      "Platoon member is not a duplicate");
+	}
+	/* A bounce of the last one is still caught */
+	zassert_true(dedup_vehicle_check(&set, 0, 10500 + CONFIG_RADAR_DEDUP_WINDOW_MS / 2, 73,
+					 CONFIG_RADAR_DEDUP_SPEED_TOLERANCE_KMH),
+		     "Bounce should be suppressed");
+}
+
+ZTEST(radar_dedup, test_plate_window_expires)
+{
+	dedup_set_init(&set, 60000);
+	uint32_t plate = plate_pack("ABC1D23");
+
+	zassert_false(dedup_plate_check(&set, plate, 1000), "First read is new");
+	zassert_true(dedup_plate_check(&set, plate, 30000), "Repeat inside window is a duplicate");
+	zassert_false(dedup_plate_check(&set, plate_pack("ABC1D24"), 30000), "Other plate is new");
+	zassert_false(dedup_plate_check(&set, plate, 120000), "Repeat after window is new");
+}
+
+ZTEST(radar_dedup, test_full_set_evicts_oldest)
+{
+	dedup_set_init(&set, 60000);
+
+	/* Far more live keys than slots: inserts must keep working */
+	for (uint32_t i = 0; i < 4 * CONFIG_RADAR_DEDUP_SLOTS; i++) {
+		dedup_set_insert(&set, i, i, 1000 + i);
+	}
+	zassert_not_null(dedup_set_find(&set, 4 * CONFIG_RADAR_DEDUP_SLOTS - 1, 2000),
+			 "Newest key must survive eviction");
+}
+
+ZTEST(radar_dedup, test_plate_pack_is_unique)
+{
+	zassert_not_equal(plate_pack("ABC1D23"), plate_pack("ABC1D32"), "Digits must matter");
+	zassert_not_equal(plate_pack("ABC1D23"), plate_pack("ABC1E23"), "Letters must matter");
+	zassert_equal(plate_pack("abc1d23"), plate_pack("ABC1D23"), "Packing is case-insensitive");
+}
+
+ZTEST_SUITE(radar_dedup, NULL, NULL, NULL, NULL, NULL);
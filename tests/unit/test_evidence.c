@@ -0,0 +1,167 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+#include "evidence.h"
+#include "lpr.h"
+
+static lpr_frame_t frame;
+static evidence_encoder_t encoder;
+static uint8_t jpeg[32768];
+
+/**
+ * cos(k * pi / 16) for any k, from the first quadrant, so the reference
+ * needs no libm.
+ * @param k The multiple of pi / 16.
+ * @return The cosine.
+ */
+static double cos_pi16(uint32_t k)
+{
+	static const double quadrant[9] = {1.0, 0.98078528, 0.92387953, 0.83146961, 0.70710678,
+					   0.55557023, 0.38268343, 0.19509032, 0.0};
+
+	k %= 32;
+	if (k > 16) {
+		k = 32 - k;
+	}
+	return k <= 8 ? quadrant[k] : -quadrant[16 - k];
+}
+
+/**
+ * Finds a marker segment in the stream header.
+ * @param marker The second marker byte.
+ * @return Its offset, or 0 if missing.
+ */
+static size_t find_marker(uint8_t marker)
+{
+	for (size_t i = 2; i + 1 < EVIDENCE_HEADER_SIZE; i++) {
+		if (jpeg[i] == 0xff && jpeg[i + 1] == marker) {
+			return i;
+		}
+	}
+	return 0;
+}
+
+ZTEST(radar_evidence, test_fdct_matches_reference)
+{
+	uint32_t rng = 0x2545f491u;
+
+	for (uint32_t n = 0; n < 32; n++) {
+		int16_t block[64];
+		int16_t input[64];
+
+		for (uint32_t i = 0; i < 64; i++) {
+			rng = rng * 1664525u + 1013904223u;
+			/* Half the blocks smooth ramps, half full-range noise */
+			input[i] = n % 2 ? (int16_t)((rng >> 24) - 128) :
+					   (int16_t)((i % 8) * 16 + (i / 8) * 4 - 100);
+			block[i] = input[i];
+		}
+		evidence_fdct(block);
+
+		/* Orthonormal 2-D DCT-II straight from the definition, times 8 */
+		for (uint32_t v = 0; v < 8; v++) {
+			for (uint32_t u = 0; u < 8; u++) {
+				double sum = 0;
+
+				for (uint32_t y = 0; y < 8; y++) {
+					for (uint32_t x = 0; x < 8; x++) {
+						sum += input[y * 8 + x] * cos_pi16((2 * x + 1) * u) *
+						       cos_pi16((2 * y + 1) * v);
+					}
+				}
+				double cu = u == 0 ? cos_pi16(4) : 1;
+				double cv = v == 0 ? cos_pi16(4) : 1;
+				double error = block[v * 8 + u] - 2 * cu * cv * sum;
+
+				zassert_true(error >= -2.0 && error <= 2.0,
+					     "Coefficient (%u,%u) of block %u off by more than 2", u, v, n);
+			}
+		}
+	}
+}
+
+ZTEST(radar_evidence, test_stream_layout)
+{
+	evidence_init(&encoder, 50);
+	lpr_sim_render(&frame, "RIO2A18", 1, NULL);
+	size_t len = evidence_encode(&encoder, &frame.pixels[0][0], LPR_WIDTH, LPR_HEIGHT, LPR_WIDTH,
+				     jpeg, sizeof(jpeg));
+
+	zassert_true(len > EVIDENCE_HEADER_SIZE, "Frame encoded");
+	zassert_true(jpeg[0] == 0xff && jpeg[1] == 0xd8, "Starts with SOI");
+	zassert_true(jpeg[len - 2] == 0xff && jpeg[len - 1] == 0xd9, "Ends with EOI");
+	/* Baseline frame header with the size, height first */
+	size_t sof = find_marker(0xc0);
+
+	zassert_true(sof > 0, "SOF0 present");
+	zassert_equal((jpeg[sof + 5] << 8) | jpeg[sof + 6], LPR_HEIGHT, "SOF0 height");
+	zassert_equal((jpeg[sof + 7] << 8) | jpeg[sof + 8], LPR_WIDTH, "SOF0 width");
+	zassert_true(find_marker(0xdb) > 0 && find_marker(0xc4) > 0, "Tables present");
+	zassert_equal(find_marker(0xda), EVIDENCE_HEADER_SIZE - 10,
+		      "Scan header right before the data");
+	/* No marker inside the entropy-coded data: every 0xFF is stuffed */
+	for (size_t i = EVIDENCE_HEADER_SIZE; i < len - 2; i++) {
+		if (jpeg[i] == 0xff) {
+			zassert_equal(jpeg[i + 1], 0, "Unstuffed 0xFF at %u", (uint32_t)i);
+			i++;
+		}
+	}
+	zassert_true(len * 8 < sizeof(lpr_frame_t), "Better than 8:1 at quality 50");
+}
+
+ZTEST(radar_evidence, test_flat_frame)
+{
+	memset(&frame, 0x80, sizeof(frame));
+	evidence_init(&encoder, 90);
+	size_t len = evidence_encode(&encoder, &frame.pixels[0][0], LPR_WIDTH, LPR_HEIGHT, LPR_WIDTH,
+				     jpeg, sizeof(jpeg));
+
+	/* Two bits of DC and four of EOB per block */
+	zassert_true(len > 0, "Frame encoded");
+	zassert_true(len <= EVIDENCE_HEADER_SIZE + 2 + (LPR_WIDTH * LPR_HEIGHT / 64) * 6 / 8 + 1,
+		     "Flat blocks cost only their DC and EOB codes, got %u bytes", (uint32_t)len);
+}
+
+ZTEST(radar_evidence, test_quality_orders_size)
+{
+	size_t last = 0;
+	static const uint8_t qualities[] = {10, 25, 50, 75, 95};
+
+	lpr_sim_render(&frame, "ABC1D23", 7, NULL);
+	for (uint32_t i = 0; i < ARRAY_SIZE(qualities); i++) {
+		evidence_init(&encoder, qualities[i]);
+		size_t len = evidence_encode(&encoder, &frame.pixels[0][0], LPR_WIDTH, LPR_HEIGHT,
+					     LPR_WIDTH, jpeg, sizeof(jpeg));
+
+		zassert_true(len > last, "Quality %u larger than the one below", qualities[i]);
+		last = len;
+	}
+}
+
+ZTEST(radar_evidence, test_overflow_stays_in_buffer)
+{
+	static const size_t capacities[] = {0, EVIDENCE_HEADER_SIZE, 1000, 4000};
+
+	evidence_init(&encoder, 75);
+	lpr_sim_render(&frame, "QOD0B07", 3, NULL);
+	for (uint32_t i = 0; i < ARRAY_SIZE(capacities); i++) {
+		memset(jpeg, 0xa5, sizeof(jpeg));
+		zassert_equal(evidence_encode(&encoder, &frame.pixels[0][0], LPR_WIDTH, LPR_HEIGHT,
+					      LPR_WIDTH, jpeg, capacities[i]),
+			      0, "Does not fit %u bytes", (uint32_t)capacities[i]);
+		zassert_equal(jpeg[capacities[i]], 0xa5, "Nothing written past the buffer");
+	}
+}
+
+ZTEST(radar_evidence, test_edge_blocks)
+{
+	/* Width and height off the block grid: the last block repeats the edge */
+	evidence_init(&encoder, 50);
+	lpr_sim_render(&frame, "WMW8M88", 5, NULL);
+	size_t len = evidence_encode(&encoder, &frame.pixels[0][0], 100, 61, LPR_WIDTH, jpeg,
+				     sizeof(jpeg));
+
+	zassert_true(len > EVIDENCE_HEADER_SIZE, "Frame encoded");
+	zassert_true(jpeg[len - 2] == 0xff && jpeg[len - 1] == 0xd9, "Ends with EOI");
+}
+
+ZTEST_SUITE(radar_evidence, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,217 @@
+#include <zephyr/ztest.h>
+#include "infraction_log.h"
+
+#define EXPORT_STACK_SIZE   1024
+#define EXPORT_STACK_BUDGET 256
+
+typedef struct {
+	uint32_t expected_seq;
+	uint32_t count;
+	uint32_t stop_after;
+	bool in_order;
+} export_state_t;
+
+static bool export_cb(const infraction_record_t *records, size_t count, void *user_data)
+{
+	export_state_t *st = user_data;
+
+	for (size_t i = 0; i < count; i++) {
+		if (records[i].seq != st->expected_seq) {
+			st->in_order = false;
+		}
+		st->expected_seq = records[i].seq + 1;
+		st->count++;
+	}
+	return st->stop_after == 0 || st->count < st->stop_after;
+}
+
+static void fill_log(uint32_t n)
+{
+	infraction_record_t rec = {.type = VEHICLE_HEAVY, .speed_kmh = 50, .limit_kmh = 40};
+
+	for (uint32_t i = 0; i < n; i++) {
+		infraction_log_add(&rec);
+	}
+}
+
+ZTEST(radar_export, test_visit_streams_whole_log_in_order)
+{
+	infraction_cursor_t cursor;
+
+	fill_log(CONFIG_RADAR_INFRACTION_LOG_SIZE + 5);
+	infraction_cursor_init(&cursor);
+
+	export_state_t st = {.expected_seq = cursor.next_seq, .in_order = true};
+	size_t n = infraction_log_visit(&cursor, export_cb, &st);
+
+	zassert_equal(n, CONFIG_RADAR_INFRACTION_LOG_SIZE, "Whole ring should be visited");
+	zassert_true(st.in_order, "Records must be consecutive, oldest first");
+	zassert_equal(cursor.lost, 0, "Nothing was overwritten during the export");
+	zassert_equal(infraction_log_visit(&cursor, export_cb, &st), 0, "Cursor is at the end");
+}
+
+ZTEST(radar_export, test_visit_resumes_by_sequence_number)
+{
+	infraction_cursor_t cursor;
+
+	fill_log(CONFIG_RADAR_INFRACTION_LOG_SIZE);
+	infraction_cursor_init(&cursor);
+	uint32_t first = cursor.next_seq;
+
+	export_state_t st = {.expected_seq = first, .in_order = true, .stop_after = 3};
+	infraction_log_visit(&cursor, export_cb, &st);
+	zassert_true(st.count >= 3 && st.count < CONFIG_RADAR_INFRACTION_LOG_SIZE,
+		     "Callback should be able to stop the export early");
+
+	/* Resume from a saved sequence number, as a consumer would after a reboot */
+	infraction_cursor_t resumed = {.next_seq = cursor.next_seq};
+	st.stop_after = 0;
+	infraction_log_visit(&resumed, export_cb, &st);
+	zassert_equal(st.count, CONFIG_RADAR_INFRACTION_LOG_SIZE, "Resume must not skip or repeat");
+	zassert_true(st.in_order, "Resume must continue at the saved sequence number");
+}
+
+ZTEST(radar_export, test_visit_counts_overwritten_records)
+{
+	infraction_cursor_t cursor;
+	export_state_t drained = {.in_order = true};
+
+	/* Start at the end of the log, whatever earlier tests left in it */
+	infraction_cursor_init(&cursor);
+	drained.expected_seq = cursor.next_seq;
+	infraction_log_visit(&cursor, export_cb, &drained);
+	zassert_equal(cursor.lost, 0, "Nothing was overwritten while draining");
+	fill_log(CONFIG_RADAR_INFRACTION_LOG_SIZE + 7);
+
+	export_state_t st = {.expected_seq = cursor.next_seq + 7, .in_order = true};
+	infraction_log_visit(&cursor, export_cb, &st);
+	zassert_equal(cursor.lost, 7, "Lapped records should be reported as lost");
+	zassert_true(st.in_order, "Export should continue at the oldest surviving record");
+}
+
+K_THREAD_STACK_DEFINE(export_stack, EXPORT_STACK_SIZE);
+static struct k_thread export_thread;
+
+static bool discard_cb(const infraction_record_t *records, size_t count, void *user_data)
+{
+	ARG_UNUSED(records);
+	*(size_t *)user_data += count;
+	return true;
+}
+
+static void baseline_entry(void *p1, void *p2, void *p3)
+{
+	size_t total = 0;
+
+	(void)discard_cb(NULL, 0, &total);
+}
+
+static void export_entry(void *p1, void *p2, void *p3)
+{
+	infraction_cursor_t cursor;
+	size_t total = 0;
+
+	infraction_cursor_init(&cursor);
+	infraction_log_visit(&cursor, discard_cb, &total);
+	*(size_t *)p1 = total;
+}
+
+static size_t stack_used_by(k_thread_entry_t entry, void *arg)
+{
+	size_t unused = 0;
+
+	k_thread_create(&export_thread, export_stack, K_THREAD_STACK_SIZEOF(export_stack), entry,
+			arg, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	k_thread_join(&export_thread, K_FOREVER);
+	zassert_ok(k_thread_stack_space_get(&export_thread, &unused), "Stack info unavailable");
+	return K_THREAD_STACK_SIZEOF(export_stack) - unused;
+}
+
+ZTEST(radar_export, test_full_export_stack_budget)
+{
+	if (IS_ENABLED(CONFIG_ARCH_POSIX)) {
+		/* Threads run on host stacks; nothing meaningful to measure */
+		ztest_test_skip();
+	}
+
+	size_t exported = 0;
+
+	fill_log(CONFIG_RADAR_INFRACTION_LOG_SIZE);
+	size_t baseline = stack_used_by(baseline_entry, NULL);
+	size_t used = stack_used_by(export_entry, &exported);
+
+	TC_PRINT("Export of %zu records used %zu bytes of stack above baseline\n", exported,
+		 used - baseline);
+	zassert_equal(exported, CONFIG_RADAR_INFRACTION_LOG_SIZE, "Whole log should be exported");
+	zassert_true(used - baseline < EXPORT_STACK_BUDGET, "Export exceeded the stack budget");
+}
+
+#define PRODUCER_COUNT   4
+#define PRODUCER_RECORDS (2 * CONFIG_RADAR_INFRACTION_LOG_SIZE)
+
+K_THREAD_STACK_ARRAY_DEFINE(producer_stacks, PRODUCER_COUNT, EXPORT_STACK_SIZE);
+static struct k_thread producer_threads[PRODUCER_COUNT];
+
+static void producer_entry(void *p1, void *p2, void *p3)
+{
+	infraction_record_t rec = {.type = VEHICLE_LIGHT, .valid_read = true};
+
+	rec.speed_kmh = (uint32_t)(uintptr_t)p1;
+	for (uint32_t i = 0; i < PRODUCER_RECORDS; i++) {
+		rec.limit_kmh = i;
+		infraction_log_add(&rec);
+		k_yield();
+	}
+}
+
+typedef struct {
+	export_state_t export;
+	int64_t last[PRODUCER_COUNT]; // Last record index seen from each producer
+} producer_state_t;
+
+static bool producer_order_cb(const infraction_record_t *records, size_t count, void *user_data)
+{
+	producer_state_t *st = user_data;
+
+	for (size_t i = 0; i < count; i++) {
+		uint32_t p = records[i].speed_kmh;
+
+		if (records[i].limit_kmh <= st->last[p]) {
+			st->export.in_order = false;
+		}
+		st->last[p] = records[i].limit_kmh;
+	}
+	return export_cb(records, count, &st->export);
+}
+
+ZTEST(radar_export, test_concurrent_producers)
+{
+	uint32_t valid_before;
+	uint32_t valid_after;
+
+	infraction_log_get_counters(NULL, NULL, &valid_before, NULL);
+	for (uintptr_t p = 0; p < PRODUCER_COUNT; p++) {
+		k_thread_create(&producer_threads[p], producer_stacks[p],
+				K_THREAD_STACK_SIZEOF(producer_stacks[p]), producer_entry, (void *)p,
+				NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+	for (int p = 0; p < PRODUCER_COUNT; p++) {
+		k_thread_join(&producer_threads[p], K_FOREVER);
+	}
+	infraction_log_get_counters(NULL, NULL, &valid_after, NULL);
+	zassert_equal(valid_after - valid_before, PRODUCER_COUNT * PRODUCER_RECORDS,
+		      "Every append must be counted");
+
+	infraction_cursor_t cursor;
+	producer_state_t st = {.last = {-1, -1, -1, -1}};
+
+	infraction_cursor_init(&cursor);
+	st.export.expected_seq = cursor.next_seq;
+	st.export.in_order = true;
+	zassert_equal(infraction_log_visit(&cursor, producer_order_cb, &st),
+		      CONFIG_RADAR_INFRACTION_LOG_SIZE, "Ring should hold only committed records");
+	zassert_equal(cursor.lost, 0, "Nothing was overwritten during the export");
+	zassert_true(st.export.in_order, "Consecutive sequence numbers, each producer in order");
+}
+
+ZTEST_SUITE(radar_export, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,112 @@
+#include <zephyr/ztest.h>
+#include <string.h>
+#include "common.h"
+#include "flight_recorder.h"
+
+static flight_event_t events[CONFIG_RADAR_FLIGHT_RECORDER_EVENTS];
+
+static void cold_boot(void)
+{
+	memset(&flight_ring, 0xa5, sizeof(flight_ring));
+	zassert_false(flight_recorder_init(), "Garbage ring must not be kept");
+}
+
+ZTEST(radar_flight, test_cold_boot_starts_with_boot_event)
+{
+	cold_boot();
+
+	size_t n = flight_recorder_snapshot(events, ARRAY_SIZE(events));
+
+	zassert_equal(n, 1, "Only the boot event should be recorded");
+	zassert_equal(events[0].type, FLIGHT_EV_BOOT, "First event is the boot marker");
+	zassert_equal(events[0].value, 1, "First boot");
+}
+
+ZTEST(radar_flight, test_events_round_trip_in_order)
+{
+	cold_boot();
+	flight_recorder_record(FLIGHT_EV_FINALIZE, 3, 360);
+	flight_recorder_record(FLIGHT_EV_SPEED, 2, 50);
+	flight_recorder_record(FLIGHT_EV_TRIGGER, 0, 50);
+
+	size_t n = flight_recorder_snapshot(events, ARRAY_SIZE(events));
+
+	zassert_equal(n, 4, "Boot plus three events");
+	zassert_equal(events[1].type, FLIGHT_EV_FINALIZE, "Oldest first");
+	zassert_equal(events[1].arg, 3, "Arg survives packing");
+	zassert_equal(events[1].value, 360, "Value survives packing");
+	zassert_equal(events[3].type, FLIGHT_EV_TRIGGER, "Newest last");
+	zassert_true(events[3].time_ms >= events[1].time_ms, "Timestamps are monotonic");
+}
+
+ZTEST(radar_flight, test_ring_keeps_newest_events)
+{
+	cold_boot();
+	for (uint16_t i = 0; i < CONFIG_RADAR_FLIGHT_RECORDER_EVENTS + 10; i++) {
+		flight_recorder_record(FLIGHT_EV_SPEED, 0, i);
+	}
+
+	size_t n = flight_recorder_snapshot(events, ARRAY_SIZE(events));
+
+	zassert_equal(n, CONFIG_RADAR_FLIGHT_RECORDER_EVENTS, "Ring should be full");
+	zassert_equal(events[0].value, 10, "Oldest survivor");
+	zassert_equal(events[n - 1].value, CONFIG_RADAR_FLIGHT_RECORDER_EVENTS + 9, "Newest event");
+}
+
+ZTEST(radar_flight, test_warm_boot_keeps_previous_events)
+{
+	cold_boot();
+	flight_recorder_record(FLIGHT_EV_LOG_ADD, VEHICLE_HEAVY, 72);
+
+	/* Simulated reset: noinit RAM is left as is */
+	zassert_true(flight_recorder_init(), "Valid ring must be kept across a warm boot");
+
+	size_t n = flight_recorder_snapshot(events, ARRAY_SIZE(events));
+
+	zassert_equal(n, 3, "Previous boot's events plus a new boot marker");
+	zassert_equal(events[1].type, FLIGHT_EV_LOG_ADD, "Pre-reset event survives");
+	zassert_equal(events[2].type, FLIGHT_EV_BOOT, "New boot is marked");
+	zassert_equal(events[2].value, 2, "Boot count increments");
+}
+
+ZTEST(radar_flight, test_torn_event_is_skipped)
+{
+	cold_boot();
+	flight_recorder_record(FLIGHT_EV_SPEED, 1, 80);
+
+	/* A writer that reserved its slot and stored the time half, then died */
+	uint32_t seq = (uint32_t)radar_atomic_inc(&flight_ring.head);
+
+	flight_ring.events[seq & (CONFIG_RADAR_FLIGHT_RECORDER_EVENTS - 1)] =
+		12345 | (flight_recorder_tag(seq) << 28);
+	flight_recorder_record(FLIGHT_EV_TRIGGER, 0, 80);
+
+	size_t n = flight_recorder_snapshot(events, ARRAY_SIZE(events));
+
+	zassert_equal(n, 3, "Boot, speed and trigger; the torn event is left out");
+	zassert_equal(events[1].type, FLIGHT_EV_SPEED, "Event before the torn one");
+	zassert_equal(events[2].type, FLIGHT_EV_TRIGGER, "Event after the torn one");
+	zassert_false(flight_recorder_read(seq, &(uint64_t){0}), "Torn event is rejected");
+}
+
+ZTEST(radar_flight, test_torn_event_of_later_lap_is_skipped)
+{
+	cold_boot();
+	for (uint16_t i = 0; i < CONFIG_RADAR_FLIGHT_RECORDER_EVENTS; i++) {
+		flight_recorder_record(FLIGHT_EV_SPEED, 0, i);
+	}
+
+	/* Second lap: the slot still holds the high half of the first lap's event */
+	uint32_t seq = (uint32_t)radar_atomic_inc(&flight_ring.head);
+
+	uint64_t *slot = &flight_ring.events[seq & (CONFIG_RADAR_FLIGHT_RECORDER_EVENTS - 1)];
+
+	*slot = (*slot & ~(uint64_t)UINT32_MAX) | 12345 | (flight_recorder_tag(seq) << 28);
+
+	size_t n = flight_recorder_snapshot(events, ARRAY_SIZE(events));
+
+	zassert_equal(n, CONFIG_RADAR_FLIGHT_RECORDER_EVENTS - 1, "Torn slot left out");
+	zassert_equal(events[n - 1].value, CONFIG_RADAR_FLIGHT_RECORDER_EVENTS - 1, "Newest whole event");
+}
+
+ZTEST_SUITE(radar_flight, NULL, NULL, NULL, NULL, NULL);
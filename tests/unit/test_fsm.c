@@ -60,6 +60,78 @@ ZTEST(radar_fsm, test_heavy_classification)
 	zassert_equal(out.type, VEHICLE_HEAVY, "Type should be HEAVY");
 }
 
+ZTEST(radar_fsm, test_edges_together_start_first)
+{
+	sensor_fsm_t fsm;
+	sensor_fsm_init(&fsm);
+
+	/* Second axle and end sensor in the same interrupt */
+	sensor_fsm_handle_edges(&fsm, true, false, 1000, 0);
+	sensor_fsm_handle_edges(&fsm, true, true, 1200, 200000000);
+	sensor_fsm_handle_edges(&fsm, true, false, 1300, 300000000);
+
+	sensor_data_t out;
+	bool ok = sensor_fsm_finalize(&fsm, &out);
+	zassert_true(ok, "Finalize should produce data");
+	zassert_equal(out.duration_ms, 200, "End edge should keep the shared timestamp");
+	zassert_equal(out.axle_count, 3, "Axle from the shared interrupt should count");
+}
+
+ZTEST(radar_fsm, test_edges_cycle_timing)
+{
+	sensor_fsm_t fsm;
+	sensor_fsm_init(&fsm);
+
+	/* Counter wraps between the edges; the host counts nanoseconds */
+	uint32_t start = UINT32_MAX - 100000;
+	uint32_t end = start + 200250000;
+
+	sensor_fsm_handle_edges(&fsm, true, false, 1000, start);
+	sensor_fsm_handle_edges(&fsm, false, true, 1200, end);
+
+	sensor_data_t out;
+	zassert_true(sensor_fsm_finalize(&fsm, &out), "Finalize should produce data");
+	zassert_equal(out.duration_ms, 200, "Millisecond duration");
+	zassert_equal(out.duration_us, 200250, "Duration from the cycle counter");
+	zassert_equal(out.end_cycles, end, "End edge cycles");
+}
+
+ZTEST(radar_fsm, test_edges_together_when_idle)
+{
+	sensor_fsm_t fsm;
+	sensor_fsm_init(&fsm);
+
+	/* Start goes first; an end at the start timestamp times nothing */
+	sensor_fsm_handle_edges(&fsm, true, true, 1000, 0);
+	zassert_equal(fsm.state, SENSOR_COUNTING, "End edge should not close the window");
+
+	sensor_fsm_handle_end(&fsm, 1250);
+
+	sensor_data_t out;
+	zassert_true(sensor_fsm_finalize(&fsm, &out), "Later end edge should time the vehicle");
+	zassert_equal(out.duration_ms, 250, "Duration mismatch");
+}
+
+ZTEST(radar_fsm, test_unlisted_events_ignored)
+{
+	sensor_fsm_t fsm;
+	sensor_fsm_init(&fsm);
+	sensor_data_t out;
+
+	/* No rows for these pairs: state and data must not move */
+	zassert_false(sensor_fsm_finalize(&fsm, &out), "Timeout when idle");
+	sensor_fsm_handle_end(&fsm, 500);
+	zassert_equal(fsm.state, SENSOR_IDLE, "End edge when idle");
+
+	sensor_fsm_handle_start(&fsm, 1000);
+	sensor_fsm_handle_end(&fsm, 1300);
+	sensor_fsm_handle_end(&fsm, 1600);
+	zassert_equal(fsm.state, SENSOR_TIMED, "First end edge should time the vehicle");
+	zassert_true(sensor_fsm_finalize(&fsm, &out), "Finalize should produce data");
+	zassert_equal(out.duration_ms, 300, "Repeated end edge should be ignored");
+	zassert_equal(fsm.state, SENSOR_IDLE, "Finalize should return to idle");
+}
+
 ZTEST_SUITE(radar_fsm, NULL, NULL, NULL, NULL, NULL);
 
 
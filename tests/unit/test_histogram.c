@@ -0,0 +1,90 @@
+#include <zephyr/ztest.h>
+#include "histogram.h"
+
+static histogram_t hist;
+static histogram_snapshot_t snap, other;
+static uint8_t dump[HISTOGRAM_DUMP_MAX];
+
+ZTEST(radar_histogram, test_bucket_bounds_cover_every_value)
+{
+	static const uint32_t values[] = {0, 1, 7, 8, 9, 15, 16, 17, 100, 1000, 65535, 65536,
+					  123456789, 0x80000000u, 0xffffffffu};
+
+	for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+		uint32_t b = histogram_bucket(values[i]);
+
+		zassert_true(b < HISTOGRAM_BUCKETS, "Bucket out of range for %u", values[i]);
+		zassert_true(histogram_bucket_low(b) <= values[i] && values[i] <= histogram_bucket_high(b),
+			     "%u outside its bucket", values[i]);
+		/* Bucket width is at most 1/2^S of its lower bound */
+		zassert_true((uint64_t)(histogram_bucket_high(b) - histogram_bucket_low(b)) *
+				     HISTOGRAM_SUB_BUCKETS <= histogram_bucket_low(b),
+			     "Bucket of %u too wide", values[i]);
+	}
+	zassert_equal(histogram_bucket(0xffffffffu), HISTOGRAM_BUCKETS - 1, "Last bucket unused");
+}
+
+ZTEST(radar_histogram, test_buckets_are_contiguous)
+{
+	for (uint32_t b = 1; b < HISTOGRAM_BUCKETS; b++) {
+		zassert_equal(histogram_bucket_low(b), histogram_bucket_high(b - 1) + 1,
+			      "Gap between buckets %u and %u", b - 1, b);
+	}
+}
+
+ZTEST(radar_histogram, test_percentiles)
+{
+	histogram_reset(&hist);
+	for (uint32_t v = 1; v <= 1000; v++) {
+		histogram_record(&hist, v);
+	}
+	histogram_snapshot(&hist, &snap);
+
+	zassert_equal(snap.total, 1000, "Every sample should be counted");
+	uint32_t p50 = histogram_percentile(&snap, 5000);
+	uint32_t p99 = histogram_percentile(&snap, 9900);
+
+	zassert_true(p50 >= 500 && p50 <= 500 + 500 / HISTOGRAM_SUB_BUCKETS, "p50 = %u", p50);
+	zassert_true(p99 >= 990 && p99 <= 990 + 990 / HISTOGRAM_SUB_BUCKETS, "p99 = %u", p99);
+	zassert_true(histogram_max(&snap) >= 1000, "Max below the largest sample");
+	zassert_equal(histogram_percentile(&snap, 0), 1, "p0 is the smallest sample");
+}
+
+ZTEST(radar_histogram, test_merge_adds_counts)
+{
+	histogram_reset(&hist);
+	histogram_record(&hist, 10);
+	histogram_snapshot(&hist, &snap);
+	histogram_reset(&hist);
+	histogram_record(&hist, 10);
+	histogram_record(&hist, 5000);
+	histogram_snapshot(&hist, &other);
+
+	histogram_merge(&snap, &other);
+	zassert_equal(snap.total, 3, "Totals should add");
+	zassert_equal(snap.counts[histogram_bucket(10)], 2, "Shared bucket should add");
+	zassert_true(histogram_max(&snap) >= 5000, "Merged max comes from either side");
+}
+
+ZTEST(radar_histogram, test_dump_round_trip)
+{
+	histogram_reset(&hist);
+	for (uint32_t v = 0; v < 300; v += 3) {
+		histogram_record(&hist, v * v);
+	}
+	histogram_record(&hist, 0xffffffffu);
+	histogram_snapshot(&hist, &snap);
+
+	size_t len = histogram_encode(&snap, dump, sizeof(dump));
+
+	zassert_true(len > 4 && len < 256, "Sparse dump should be compact, got %zu", len);
+	zassert_true(histogram_decode(dump, len, &other), "Dump should decode");
+	zassert_mem_equal(&snap, &other, sizeof(snap), "Round trip should be lossless");
+
+	zassert_false(histogram_decode(dump, len - 1, &other), "Truncated dump must be rejected");
+	dump[2]++;
+	zassert_false(histogram_decode(dump, len, &other), "Foreign layout must be rejected");
+	zassert_equal(histogram_encode(&snap, dump, len - 1), 0, "Short buffer must be reported");
+}
+
+ZTEST_SUITE(radar_histogram, NULL, NULL, NULL, NULL, NULL);
@@ -55,4 +55,15 @@ ZTEST(radar_unit, test_plate_validation)
     zassert_true(validate_plate("abc1d23"), "Lowercase should be accepted (normalized to uppercase)");
 }
 
+ZTEST(radar_unit, test_predict_arrival)
+{
+    // 5 m in 200 ms is 25 m/s: 8 m further takes 320 ms
+    zassert_equal(predict_arrival_us(1000000, 200000, 5000, 8000), 1320000, "8 m at 90 km/h");
+    // Sub-millisecond timing is kept
+    zassert_equal(predict_arrival_us(0, 3250, 5000, 1000), 650, "1 m at 6000 km/h");
+    // Zero distance fires at the end sensor
+    zassert_equal(predict_arrival_us(500000, 200000, 5000, 0), 500000, "Point on the end sensor");
+    zassert_equal(predict_arrival_us(500000, 200000, 0, 8000), 500000, "Bad geometry");
+}
+
 ZTEST_SUITE(radar_unit, NULL, NULL, NULL, NULL, NULL);
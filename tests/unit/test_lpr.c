@@ -0,0 +1,120 @@
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include "common.h"
+#include "lpr.h"
+
+static lpr_frame_t frame;
+static lpr_integral_t integral;
+static uint8_t reference_edges[LPR_HEIGHT][LPR_WIDTH];
+
+ZTEST(radar_lpr, test_integral_matches_reference)
+{
+	lpr_sim_render(&frame, "RIO2A18", 3, NULL);
+	lpr_integral(&frame, &integral);
+
+	/* Scalar edge map straight from the definition */
+	for (uint32_t y = 0; y < LPR_HEIGHT; y++) {
+		for (uint32_t x = 0; x < LPR_WIDTH; x++) {
+			bool inner = x > 0 && x < LPR_WIDTH - 1;
+
+			reference_edges[y][x] =
+				inner && abs(frame.pixels[y][x + 1] - frame.pixels[y][x - 1]) >
+						 CONFIG_RADAR_LPR_EDGE_THRESHOLD;
+		}
+	}
+
+	/* Running column sums of the row prefix sums, wrapping at 16 bits like the kernel */
+	uint16_t column[LPR_WIDTH + 1] = {0};
+
+	for (uint32_t y = 0; y < LPR_HEIGHT; y++) {
+		uint16_t run = 0;
+
+		for (uint32_t x = 0; x < LPR_WIDTH; x++) {
+			run += reference_edges[y][x];
+			column[x + 1] += run;
+			zassert_equal(integral.sum[y + 1][x + 1], column[x + 1],
+				      "Integral differs at row %u column %u", y + 1, x + 1);
+		}
+		zassert_equal(integral.sum[y + 1][0], 0, "First column is zero");
+	}
+}
+
+ZTEST(radar_lpr, test_locates_plate)
+{
+	static const char *const plates[] = {"ABC1D23", "III1I11", "WMW8M88", "QOD0B07"};
+
+	for (uint32_t seed = 1; seed <= 32; seed++) {
+		lpr_rect_t plate;
+		lpr_rect_t crop;
+
+		lpr_sim_render(&frame, plates[seed % ARRAY_SIZE(plates)], seed, &plate);
+		zassert_true(lpr_locate(&frame, &integral, &crop), "Plate found, seed %u", seed);
+
+		/* Within the plate, give or take the edge of its border */
+		zassert_true(crop.x + 2 >= plate.x && crop.y + 2 >= plate.y, "Crop starts on the plate");
+		zassert_true(crop.x + crop.width <= plate.x + plate.width + 2 &&
+				     crop.y + crop.height <= plate.y + plate.height + 2,
+			     "Crop ends on the plate");
+		/* And all characters inside */
+		zassert_true(crop.x <= plate.x + LPR_TEXT_X && crop.y <= plate.y + LPR_TEXT_Y,
+			     "Crop starts before the text");
+		zassert_true(crop.x + crop.width >= plate.x + LPR_TEXT_X + LPR_TEXT_WIDTH &&
+				     crop.y + crop.height >= plate.y + LPR_TEXT_Y + LPR_TEXT_HEIGHT,
+			     "Crop ends after the text");
+	}
+}
+
+ZTEST(radar_lpr, test_no_plate)
+{
+	lpr_rect_t crop;
+
+	for (uint32_t seed = 1; seed <= 8; seed++) {
+		lpr_sim_render(&frame, NULL, seed, NULL);
+		zassert_false(lpr_locate(&frame, &integral, &crop),
+			      "Headlights and grille are not a plate, seed %u", seed);
+	}
+}
+
+ZTEST(radar_lpr, test_reads_plate)
+{
+	static const char *const plates[] = {"ABC1D23", "III1I11", "WMW8M88", "QOD0B07", "EFB8P38"};
+
+	for (uint32_t seed = 1; seed <= 40; seed++) {
+		const char *plate = plates[seed % ARRAY_SIZE(plates)];
+		lpr_rect_t crop;
+		lpr_read_t read;
+
+		lpr_sim_render(&frame, plate, seed, NULL);
+		zassert_true(lpr_locate(&frame, &integral, &crop), "Plate found, seed %u", seed);
+		zassert_true(lpr_read(&frame, &crop, &read), "Plate read, seed %u", seed);
+		zassert_equal(strcmp(read.plate, plate), 0, "Read what was drawn, seed %u", seed);
+		zassert_true(validate_plate(read.plate), "Position alphabets keep the Mercosul format");
+		for (uint32_t i = 0; i < LPR_PLATE_CHARS; i++) {
+			zassert_true(read.confidence[i] >= read.min_confidence, "Minimum is the minimum");
+		}
+	}
+}
+
+ZTEST(radar_lpr, test_smudged_plate_not_misread)
+{
+	uint32_t rejected = 0;
+
+	for (uint32_t seed = 1; seed <= 40; seed++) {
+		lpr_rect_t plate;
+		lpr_rect_t crop;
+		lpr_read_t read;
+
+		lpr_sim_render(&frame, "RIO2A18", seed, &plate);
+		lpr_sim_smudge(&frame, &plate, seed);
+		if (!lpr_locate(&frame, &integral, &crop) || !lpr_read(&frame, &crop, &read)) {
+			rejected++;
+			continue;
+		}
+		/* Mud over a character may leave it readable, but never as another plate */
+		zassert_equal(strcmp(read.plate, "RIO2A18"), 0, "Confident misread, seed %u", seed);
+	}
+	zassert_true(rejected > 0, "Mud costs reads");
+}
+
+ZTEST_SUITE(radar_lpr, NULL, NULL, NULL, NULL, NULL);
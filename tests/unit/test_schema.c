@@ -0,0 +1,179 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+#include "schema.h"
+
+static uint8_t buf[SCHEMA_MAX_SIZE + 8];
+
+ZTEST(radar_schema, test_sizes)
+{
+	zassert_equal(SCHEMA_SENSOR_DATA_SIZE, 38, "Sensor data");
+	zassert_equal(SCHEMA_DISPLAY_DATA_SIZE, 46, "Display data");
+	zassert_equal(SCHEMA_CAMERA_TRIGGER_SIZE, 18, "Camera trigger");
+	zassert_equal(SCHEMA_CAMERA_RESULT_SIZE, 15, "Camera result");
+	zassert_equal(SCHEMA_INFRACTION_RECORD_SIZE, 36, "Infraction record");
+	zassert_equal(SCHEMA_MAX_SIZE, SCHEMA_DISPLAY_DATA_SIZE, "Display data is the largest");
+}
+
+ZTEST(radar_schema, test_wire_format)
+{
+	camera_trigger_t trig = {
+		.speed_kmh = 0x01020304,
+		.type = VEHICLE_HEAVY,
+		.id = 0xa0b0c0d0,
+		.lane = 3,
+		.timestamp_ms = -2,
+	};
+	static const uint8_t expected[] = {
+		0x04, 0x03, 0x02, 0x01,                         /* speed_kmh */
+		0x01,                                           /* type */
+		0xd0, 0xc0, 0xb0, 0xa0,                         /* id */
+		0x03,                                           /* lane */
+		0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, /* timestamp_ms */
+	};
+
+	/* Little-endian, no padding, fields in schema order */
+	zassert_equal(schema_encode_camera_trigger(&trig, buf, sizeof(buf)), sizeof(expected),
+		      "Encoded size");
+	zassert_mem_equal(buf, expected, sizeof(expected), "Wire bytes");
+}
+
+ZTEST(radar_schema, test_round_trip)
+{
+	sensor_data_t s = {
+		.timestamp_start = 1234567890123LL,
+		.timestamp_end = -1,
+		.duration_ms = 250,
+		.axle_count = 6,
+		.type = VEHICLE_HEAVY,
+		.lane = 2,
+		.gross_weight_kg = 41500,
+	};
+	sensor_data_t s2;
+
+	zassert_equal(schema_encode_sensor_data(&s, buf, sizeof(buf)), SCHEMA_SENSOR_DATA_SIZE,
+		      "Sensor data size");
+	zassert_equal(schema_decode_sensor_data(buf, sizeof(buf), &s2), SCHEMA_SENSOR_DATA_SIZE,
+		      "Sensor data size");
+	zassert_true(s2.timestamp_start == s.timestamp_start && s2.timestamp_end == s.timestamp_end &&
+			     s2.duration_ms == s.duration_ms && s2.axle_count == s.axle_count &&
+			     s2.type == s.type && s2.lane == s.lane &&
+			     s2.gross_weight_kg == s.gross_weight_kg,
+		     "Sensor data survives the round trip");
+
+	display_data_t d = {
+		.speed_kmh = 97,
+		.limit_kmh = 80,
+		.type = VEHICLE_LIGHT,
+		.status = STATUS_INFRACTION,
+		.plate = "RIO2A18",
+		.warning_kmh = 72,
+		.congested = true,
+		.gross_weight_kg = 3900,
+		.weight_limit_kg = 3500,
+		.overweight = true,
+	};
+	display_data_t d2;
+
+	zassert_equal(schema_encode_display_data(&d, buf, sizeof(buf)), SCHEMA_DISPLAY_DATA_SIZE,
+		      "Display data size");
+	zassert_equal(schema_decode_display_data(buf, sizeof(buf), &d2), SCHEMA_DISPLAY_DATA_SIZE,
+		      "Display data size");
+	zassert_true(d2.speed_kmh == 97 && d2.limit_kmh == 80 && d2.type == VEHICLE_LIGHT &&
+			     d2.status == STATUS_INFRACTION && strcmp(d2.plate, "RIO2A18") == 0 &&
+			     d2.warning_kmh == 72 && d2.congested && d2.aggregate_vehicles == 0 &&
+			     d2.gross_weight_kg == 3900 && d2.weight_limit_kg == 3500 && d2.overweight,
+		     "Display data survives the round trip");
+
+	camera_result_t r = {.plate = "ABC1D23", .valid_read = true, .id = 0xffffffffu};
+	camera_result_t r2;
+
+	zassert_equal(schema_encode_camera_result(&r, buf, sizeof(buf)), SCHEMA_CAMERA_RESULT_SIZE,
+		      "Camera result size");
+	zassert_equal(schema_decode_camera_result(buf, sizeof(buf), &r2), SCHEMA_CAMERA_RESULT_SIZE,
+		      "Camera result size");
+	zassert_true(strcmp(r2.plate, "ABC1D23") == 0 && r2.valid_read && r2.id == 0xffffffffu,
+		     "Camera result survives the round trip");
+
+	infraction_record_t rec = {
+		.timestamp_ms = 0x123456789aLL,
+		.type = VEHICLE_UNKNOWN,
+		.speed_kmh = 140,
+		.limit_kmh = 60,
+		.plate = "",
+		.seq = 77,
+	};
+	infraction_record_t rec2;
+
+	zassert_equal(schema_encode_infraction_record(&rec, buf, sizeof(buf)),
+		      SCHEMA_INFRACTION_RECORD_SIZE, "Infraction record size");
+	zassert_equal(schema_decode_infraction_record(buf, sizeof(buf), &rec2),
+		      SCHEMA_INFRACTION_RECORD_SIZE, "Infraction record size");
+	zassert_true(rec2.timestamp_ms == rec.timestamp_ms && rec2.type == VEHICLE_UNKNOWN &&
+			     rec2.speed_kmh == 140 && rec2.limit_kmh == 60 && !rec2.valid_read &&
+			     rec2.plate[0] == '\0' && rec2.seq == 77,
+		     "Infraction record survives the round trip");
+}
+
+ZTEST(radar_schema, test_independent_of_memory_layout)
+{
+	infraction_record_t a;
+	infraction_record_t b;
+	uint8_t other[SCHEMA_INFRACTION_RECORD_SIZE];
+
+	/* Same fields, different padding and bytes after the plate's terminator */
+	memset(&a, 0x00, sizeof(a));
+	memset(&b, 0xee, sizeof(b));
+	a.seq = b.seq = 5;
+	a.timestamp_ms = b.timestamp_ms = 1000;
+	a.type = b.type = VEHICLE_LIGHT;
+	a.speed_kmh = b.speed_kmh = 90;
+	a.limit_kmh = b.limit_kmh = 60;
+	a.gross_weight_kg = b.gross_weight_kg = 0;
+	a.valid_read = b.valid_read = true;
+	strcpy(a.plate, "QOD0B07");
+	strcpy(b.plate, "QOD0B07");
+
+	schema_encode_infraction_record(&a, buf, sizeof(buf));
+	schema_encode_infraction_record(&b, other, sizeof(other));
+	zassert_mem_equal(buf, other, SCHEMA_INFRACTION_RECORD_SIZE, "Encoding depends on values only");
+}
+
+ZTEST(radar_schema, test_bounds)
+{
+	camera_result_t r = {.plate = "ABC1D23", .valid_read = true, .id = 9};
+	camera_result_t untouched = {.id = 12345};
+
+	memset(buf, 0xa5, sizeof(buf));
+	zassert_equal(schema_encode_camera_result(&r, buf, SCHEMA_CAMERA_RESULT_SIZE - 1), 0,
+		      "Buffer one byte short");
+	zassert_equal(buf[0], 0xa5, "Nothing written into a short buffer");
+
+	zassert_equal(schema_encode_camera_result(&r, buf, sizeof(buf)), SCHEMA_CAMERA_RESULT_SIZE,
+		      "Camera result size");
+	zassert_equal(buf[SCHEMA_CAMERA_RESULT_SIZE], 0xa5, "Nothing written past the message");
+	zassert_equal(schema_decode_camera_result(buf, SCHEMA_CAMERA_RESULT_SIZE - 1, &untouched), 0,
+		      "Short input");
+	zassert_equal(untouched.id, 12345, "Message left alone on failure");
+}
+
+ZTEST(radar_schema, test_rejects_out_of_range)
+{
+	camera_trigger_t trig = {.type = VEHICLE_LIGHT};
+	camera_result_t r = {.plate = "ABC1D23", .valid_read = true};
+	camera_trigger_t trig2;
+	camera_result_t r2;
+
+	schema_encode_camera_trigger(&trig, buf, sizeof(buf));
+	buf[4] = VEHICLE_UNKNOWN + 1;
+	zassert_equal(schema_decode_camera_trigger(buf, sizeof(buf), &trig2), 0, "Unknown enum value");
+
+	schema_encode_camera_result(&r, buf, sizeof(buf));
+	buf[10] = 2;
+	zassert_equal(schema_decode_camera_result(buf, sizeof(buf), &r2), 0, "Bool above 1");
+
+	schema_encode_camera_result(&r, buf, sizeof(buf));
+	memset(buf, 'A', 10);
+	zassert_equal(schema_decode_camera_result(buf, sizeof(buf), &r2), 0, "Plate without terminator");
+}
+
+ZTEST_SUITE(radar_schema, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,115 @@
+#include <zephyr/ztest.h>
+#include "wim.h"
+
+#define SENSOR_DISTANCE_MM 5000
+#define BLOCK 20
+
+static wim_t wim;
+static wim_sim_t sim;
+
+/**
+ * Streams simulated samples through the detector in DMA-sized blocks.
+ * @param count The number of samples.
+ * @return The number of axle pulses that ended.
+ */
+static uint32_t stream(uint32_t count)
+{
+	uint16_t block[BLOCK];
+	uint32_t axles = 0;
+
+	for (uint32_t done = 0; done < count; done += BLOCK) {
+		wim_sim_read(&sim, block, BLOCK);
+		axles += wim_feed(&wim, block, BLOCK);
+	}
+	return axles;
+}
+
+/**
+ * Drives one vehicle over the strip and weighs it.
+ * @param speed_kmh The vehicle speed.
+ * @param axles The number of axles.
+ * @param axle_kg The load of each axle.
+ * @return The gross weight the detector reports.
+ */
+static uint32_t weigh(uint32_t speed_kmh, uint32_t axles, uint32_t axle_kg)
+{
+	uint32_t speed_mm_s = speed_kmh * 1000000u / 3600u;
+	uint32_t spacing = (3000u * CONFIG_RADAR_WIM_SAMPLE_HZ) / speed_mm_s;
+
+	wim_vehicle_reset(&wim);
+	for (uint32_t i = 0; i < axles; i++) {
+		zassert_true(wim_sim_add_axle(&sim, sim.now + 100 + i * spacing, axle_kg, speed_mm_s),
+			     "Pulse queue full");
+	}
+	zassert_equal(stream(200 + axles * spacing), axles, "Axle count mismatch");
+	zassert_false(wim_sim_busy(&sim), "Pulses left in the simulator");
+	return wim_gross_weight_kg(&wim, SENSOR_DISTANCE_MM, (SENSOR_DISTANCE_MM * 36) / (speed_kmh * 10));
+}
+
+/**
+ * Sets up a quiet strip with a settled baseline.
+ */
+static void strip_setup(void)
+{
+	wim_sim_init(&sim, 512, 8, 12345);
+	wim_init(&wim, CONFIG_RADAR_WIM_THRESHOLD);
+	zassert_equal(stream(2000), 0, "Noise should not open a pulse");
+}
+
+ZTEST(radar_wim, test_light_vehicle_weight)
+{
+	strip_setup();
+
+	uint32_t kg = weigh(60, 2, 750);
+
+	zassert_within(kg, 1500, 45, "Gross weight %u kg off by more than 3%%", kg);
+	zassert_within(wim.axles[0].peak, 112, 6, "Peak should be 1.5x the mean height");
+}
+
+ZTEST(radar_wim, test_weight_independent_of_speed)
+{
+	strip_setup();
+
+	/* Slow pulses are long and low, fast ones short and high: same weight */
+	zassert_within(weigh(15, 5, 9000), 45000, 1350, "Slow truck");
+	zassert_within(weigh(90, 5, 9000), 45000, 1350, "Fast truck");
+}
+
+ZTEST(radar_wim, test_axles_beyond_table_still_weighed)
+{
+	strip_setup();
+
+	/* Eight pulses, then two more once the queue drained: one ten-axle vehicle */
+	wim_vehicle_reset(&wim);
+	uint32_t speed_mm_s = 20000;
+	for (int i = 0; i < 8; i++) {
+		zassert_true(wim_sim_add_axle(&sim, sim.now + 100 + i * 400, 8000, speed_mm_s),
+			     "Pulse queue full");
+	}
+	zassert_false(wim_sim_add_axle(&sim, sim.now, 8000, speed_mm_s), "Queue should be full");
+	stream(3400);
+	wim_sim_add_axle(&sim, sim.now + 100, 8000, speed_mm_s);
+	wim_sim_add_axle(&sim, sim.now + 500, 8000, speed_mm_s);
+	stream(800);
+
+	zassert_equal(wim.axle_count, 10, "Axle count mismatch");
+	/* 5 m at 20 m/s */
+	zassert_within(wim_gross_weight_kg(&wim, SENSOR_DISTANCE_MM, 250), 80000, 2400, "Gross weight");
+}
+
+ZTEST(radar_wim, test_baseline_follows_drift)
+{
+	uint16_t block[BLOCK];
+
+	wim_init(&wim, CONFIG_RADAR_WIM_THRESHOLD);
+	/* Slow drift of 200 counts, ten times the threshold, without a pulse */
+	for (uint32_t i = 0; i < 20000; i += BLOCK) {
+		for (int k = 0; k < BLOCK; k++) {
+			block[k] = 500 + (i + k) / 100;
+		}
+		zassert_equal(wim_feed(&wim, block, BLOCK), 0, "Drift should not open a pulse");
+	}
+	zassert_within(wim.baseline_q8 >> 8, 699, 2, "Baseline should track the drift");
+}
+
+ZTEST_SUITE(radar_wim, NULL, NULL, NULL, NULL, NULL);